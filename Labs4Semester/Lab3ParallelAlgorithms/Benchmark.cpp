@@ -0,0 +1,332 @@
+/**
+\file
+\brief .cpp file with implementation of benchmark driver
+*/
+
+#include "Benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+
+namespace {
+    const char* countersColumns[PerfCounters::EventsCount] = { "cycles", "instructions", "l1_misses", "llc_misses",
+        "branch_misses", "context_switches" };
+
+    /**
+    \brief escapes string for JSON string literal
+
+    \param value string
+    \return string with escaped quotes and backslashes, control characters are written as \\u00XX
+    */
+    std::string EscapeJson(const std::string& value) {
+        std::string escaped;
+        for (char c : value) {
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char code[7];
+                std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(c));
+                escaped += code;
+                continue;
+            }
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    /**
+    \brief quotes CSV field
+
+    \param value field
+    \return field in quotes with doubled quotes inside if it has separator, quote or line break, field itself otherwise
+    */
+    std::string QuoteCsv(const std::string& value) {
+        if (value.find_first_of(",\"\r\n") == std::string::npos) {
+            return value;
+        }
+        std::string quoted = "\"";
+        for (char c : value) {
+            if (c == '"') {
+                quoted += '"';
+            }
+            quoted += c;
+        }
+        return quoted + '"';
+    }
+
+    /**
+    \brief generates random lowercase word
+
+    \param rng random numbers generator
+    \param minLength minimal length of word
+    \param maxLength maximal length of word
+    \return word of random letters
+    */
+    std::string GenerateWord(std::mt19937_64& rng, size_t minLength, size_t maxLength) {
+        std::string word(minLength + rng() % (maxLength - minLength + 1), 'a');
+        for (char& letter : word) {
+            letter = static_cast<char>('a' + rng() % 26);
+        }
+        return word;
+    }
+}
+
+std::string ToString(Distribution distribution) {
+    switch (distribution) {
+    case Distribution::Random:
+        return "random";
+    case Distribution::Sorted:
+        return "sorted";
+    case Distribution::Reversed:
+        return "reversed";
+    case Distribution::AlmostSorted:
+        return "almost sorted";
+    case Distribution::FewUnique:
+        return "few unique";
+    case Distribution::OrganPipe:
+        return "organ pipe";
+    case Distribution::Zipf:
+        return "zipf";
+    }
+    return "unknown";
+}
+
+const std::vector<Distribution>& GetDistributions() {
+    static const std::vector<Distribution> distributions{ Distribution::Random, Distribution::Sorted,
+        Distribution::Reversed, Distribution::AlmostSorted, Distribution::FewUnique, Distribution::OrganPipe,
+        Distribution::Zipf };
+    return distributions;
+}
+
+std::vector<uint64_t> GenerateKeys(Distribution distribution, size_t size, std::mt19937_64& rng) {
+    std::vector<uint64_t> keys(size);
+    switch (distribution) {
+    case Distribution::Random:
+        for (auto& key : keys) {
+            key = rng() >> 33;
+        }
+        break;
+    case Distribution::Sorted:
+        for (size_t i = 0; i < size; i++) {
+            keys[i] = i;
+        }
+        break;
+    case Distribution::Reversed:
+        for (size_t i = 0; i < size; i++) {
+            keys[i] = size - i;
+        }
+        break;
+    case Distribution::AlmostSorted:
+        for (size_t i = 0; i < size; i++) {
+            keys[i] = i;
+        }
+        for (size_t i = 0; i < size / 100; i++) {
+            std::swap(keys[rng() % size], keys[rng() % size]);
+        }
+        break;
+    case Distribution::FewUnique:
+        for (auto& key : keys) {
+            key = rng() % 16;
+        }
+        break;
+    case Distribution::OrganPipe:
+        for (size_t i = 0; i < size; i++) {
+            keys[i] = i < size / 2 ? i : size - i;
+        }
+        break;
+    case Distribution::Zipf: {
+        std::vector<double> weights(std::min<size_t>(std::max<size_t>(size, 1), 1 << 16));
+        for (size_t i = 0; i < weights.size(); i++) {
+            weights[i] = 1.0 / static_cast<double>(i + 1);
+        }
+        std::discrete_distribution<uint64_t> zipf(weights.begin(), weights.end());
+        for (auto& key : keys) {
+            key = zipf(rng);
+        }
+        break;
+    }
+    }
+    return keys;
+}
+
+std::string ToString(StringDistribution distribution) {
+    switch (distribution) {
+    case StringDistribution::Urls:
+        return "urls";
+    case StringDistribution::Words:
+        return "words";
+    case StringDistribution::LongPrefixes:
+        return "long prefixes";
+    }
+    return "unknown";
+}
+
+const std::vector<StringDistribution>& GetStringDistributions() {
+    static const std::vector<StringDistribution> distributions{ StringDistribution::Urls, StringDistribution::Words,
+        StringDistribution::LongPrefixes };
+    return distributions;
+}
+
+std::vector<std::string> GenerateStrings(StringDistribution distribution, size_t size, std::mt19937_64& rng) {
+    std::vector<std::string> strings;
+    strings.reserve(size);
+    switch (distribution) {
+    case StringDistribution::Urls: {
+        std::vector<std::string> hosts;
+        for (size_t i = 0; i < 100; i++) {
+            hosts.push_back("https://www." + GenerateWord(rng, 4, 12) + (i % 3 ? ".com/" : ".org/"));
+        }
+        for (size_t i = 0; i < size; i++) {
+            std::string url = hosts[rng() % hosts.size()];
+            for (size_t segments = 1 + rng() % 4; segments > 0; segments--) {
+                url += GenerateWord(rng, 2, 10) + "/";
+            }
+            url += "index.html?id=" + std::to_string(rng() % 1'000'000);
+            strings.push_back(std::move(url));
+        }
+        break;
+    }
+    case StringDistribution::Words:
+        for (size_t i = 0; i < size; i++) {
+            strings.push_back(GenerateWord(rng, 1, 12));
+        }
+        break;
+    case StringDistribution::LongPrefixes: {
+        std::string prefix = GenerateWord(rng, 200, 200);
+        for (size_t i = 0; i < size; i++) {
+            strings.push_back(prefix + GenerateWord(rng, 1, 20));
+        }
+        break;
+    }
+    }
+    return strings;
+}
+
+BenchmarkOptions ParseBenchmarkOptions(int argc, char** argv) {
+    BenchmarkOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--counters") {
+            options.counters = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            throw std::invalid_argument("no value for option " + option);
+        }
+        std::string value = argv[++i];
+        if (option == "--warmups") {
+            options.warmups = std::stoull(value);
+        }
+        else if (option == "--repetitions") {
+            options.repetitions = std::max<size_t>(std::stoull(value), 1);
+        }
+        else if (option == "--max-size") {
+            options.maxSize = std::stoull(value);
+        }
+        else if (option == "--csv") {
+            options.csvPath = value;
+        }
+        else if (option == "--json") {
+            options.jsonPath = value;
+        }
+        else {
+            throw std::invalid_argument("unknown option " + option);
+        }
+    }
+    return options;
+}
+
+Benchmark::Benchmark(size_t warmups, size_t repetitions, std::ostream& log, bool counters)
+    : warmups(warmups)
+    , repetitions(std::max<size_t>(repetitions, 1))
+    , counters(counters)
+    , log(log) {}
+
+const std::vector<BenchmarkResult>& Benchmark::GetResults() const {
+    return results;
+}
+
+void Benchmark::WriteCsv(std::ostream& out) const {
+    out << "algorithm,type,distribution,size,workers,min_ms,median_ms,p95_ms,allocations";
+    for (const char* column : countersColumns) {
+        out << ',' << column;
+    }
+    out << ",ipc" << std::endl << std::fixed << std::setprecision(3);
+    for (const auto& result : results) {
+        out << QuoteCsv(result.algorithm) << ',' << QuoteCsv(result.type) << ',' << QuoteCsv(result.distribution) << ','
+            << result.size << ',' << result.workers << ',' << result.minMs << ',' << result.medianMs << ',' << result.p95Ms << ','
+            << result.allocations;
+        for (const auto& value : result.counters) {
+            out << ',';
+            if (value) {
+                out << *value;
+            }
+        }
+        out << ',';
+        if (auto ipc = PerfCounters::GetIpc(result.counters)) {
+            out << *ipc;
+        }
+        out << std::endl;
+    }
+}
+
+void Benchmark::WriteJson(std::ostream& out) const {
+    out << '[' << std::endl << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        out << "  {\"algorithm\": \"" << EscapeJson(result.algorithm) << "\", \"type\": \"" << EscapeJson(result.type)
+            << "\", \"distribution\": \"" << EscapeJson(result.distribution) << "\", \"size\": " << result.size
+            << ", \"workers\": " << result.workers << ", \"min_ms\": " << result.minMs
+            << ", \"median_ms\": " << result.medianMs << ", \"p95_ms\": " << result.p95Ms
+            << ", \"allocations\": " << result.allocations;
+        for (size_t event = 0; event < PerfCounters::EventsCount; event++) {
+            out << ", \"" << countersColumns[event] << "\": ";
+            if (result.counters[event]) {
+                out << *result.counters[event];
+            }
+            else {
+                out << "null";
+            }
+        }
+        out << ", \"ipc\": ";
+        if (auto ipc = PerfCounters::GetIpc(result.counters)) {
+            out << *ipc;
+        }
+        else {
+            out << "null";
+        }
+        out << '}' << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << ']' << std::endl;
+}
+
+void Benchmark::Add(const std::string& algorithm, const std::string& type, const std::string& distribution,
+    size_t size, size_t workers, std::vector<double> times, size_t allocations, PerfCounters::Values counters) {
+    std::sort(times.begin(), times.end());
+    for (auto& value : counters) {
+        if (value) {
+            *value /= times.size();
+        }
+    }
+    size_t count = times.size();
+    double median = count % 2 ? times[count / 2] : (times[count / 2 - 1] + times[count / 2]) / 2;
+    size_t p95Rank = static_cast<size_t>(std::ceil(0.95 * count));
+    results.push_back({ algorithm, type, distribution, size, workers, times.front(), median, times[p95Rank - 1], allocations, counters });
+    log << std::fixed << std::setprecision(3) << algorithm << " | " << type << " | " << distribution << " | "
+        << size << " elements | " << workers << " workers: min " << times.front() << " ms, median " << median
+        << " ms, p95 " << times[p95Rank - 1] << " ms, " << allocations << " allocations";
+    if (this->counters) {
+        log << ", " << PerfCounters::ToString(counters);
+    }
+    log << std::endl;
+}
+
+void Benchmark::AddCounters(PerfCounters::Values& total, const PerfCounters::Values& values) {
+    for (size_t event = 0; event < PerfCounters::EventsCount; event++) {
+        if (values[event]) {
+            total[event] = total[event].value_or(0) + *values[event];
+        }
+    }
+}
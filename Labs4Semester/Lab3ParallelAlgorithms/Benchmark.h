@@ -0,0 +1,317 @@
+/**
+\file
+\brief .h file with definition of benchmark driver: input generators, repeated measurements and reports
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Profile.h"
+
+/**
+\brief input distributions of benchmark
+*/
+enum class Distribution {
+    Random,
+    Sorted,
+    Reversed,
+    AlmostSorted,
+    FewUnique,
+    OrganPipe,
+    Zipf
+};
+
+/**
+\brief distribution name getter
+
+\param distribution input distribution
+\return name of distribution used in reports
+*/
+std::string ToString(Distribution distribution);
+
+/**
+\brief all distributions getter
+
+\return all input distributions in order of declaration
+*/
+const std::vector<Distribution>& GetDistributions();
+
+/**
+\brief generates keys of given distribution
+
+\param distribution input distribution
+\param size number of keys
+\param rng random numbers generator
+\return keys, all of them are less than 2^31
+*/
+std::vector<uint64_t> GenerateKeys(Distribution distribution, size_t size, std::mt19937_64& rng);
+
+/**
+\brief record with 64-bit key and payload, Size bytes total
+*/
+template<size_t Size>
+struct Record {
+    static_assert(Size > sizeof(uint64_t), "record must be greater than its key");
+
+    uint64_t key;
+    char payload[Size - sizeof(uint64_t)];
+
+    bool operator<(const Record& other) const {
+        return key < other.key;
+    }
+};
+
+/**
+\brief element type traits: name in reports and construction from key
+
+Construction keeps order of keys, so distributions look the same for all types
+*/
+template<typename T>
+struct ElementTraits;
+
+template<>
+struct ElementTraits<int32_t> {
+    static std::string Name() { return "int32"; }
+    static int32_t Make(uint64_t key) { return static_cast<int32_t>(key); }
+};
+
+template<>
+struct ElementTraits<int64_t> {
+    static std::string Name() { return "int64"; }
+    static int64_t Make(uint64_t key) { return static_cast<int64_t>(key); }
+};
+
+template<>
+struct ElementTraits<double> {
+    static std::string Name() { return "double"; }
+    static double Make(uint64_t key) { return static_cast<double>(key) / 3.0; }
+};
+
+template<size_t Size>
+struct ElementTraits<Record<Size>> {
+    static std::string Name() { return "record" + std::to_string(Size); }
+    static Record<Size> Make(uint64_t key) {
+        Record<Size> record;
+        record.key = key;
+        std::memset(record.payload, static_cast<int>(key & 0xff), sizeof(record.payload));
+        return record;
+    }
+};
+
+template<>
+struct ElementTraits<std::string> {
+    static std::string Name() { return "string"; }
+    static std::string Make(uint64_t key) {
+        std::string digits = std::to_string(key);
+        return "key" + std::string(10 - digits.size(), '0') + digits;
+    }
+};
+
+/**
+\brief generates input of given distribution
+
+\param distribution input distribution
+\param size number of elements
+\param rng random numbers generator
+\return elements made from keys of distribution
+*/
+template<typename T>
+std::vector<T> GenerateInput(Distribution distribution, size_t size, std::mt19937_64& rng) {
+    std::vector<uint64_t> keys = GenerateKeys(distribution, size, rng);
+    std::vector<T> input;
+    input.reserve(size);
+    for (uint64_t key : keys) {
+        input.push_back(ElementTraits<T>::Make(key));
+    }
+    return input;
+}
+
+/**
+\brief string input distributions of benchmark
+*/
+enum class StringDistribution {
+    Urls,
+    Words,
+    LongPrefixes
+};
+
+/**
+\brief string distribution name getter
+
+\param distribution string input distribution
+\return name of distribution used in reports
+*/
+std::string ToString(StringDistribution distribution);
+
+/**
+\brief all string distributions getter
+
+\return all string input distributions in order of declaration
+*/
+const std::vector<StringDistribution>& GetStringDistributions();
+
+/**
+\brief generates strings of given distribution
+
+\param distribution string input distribution
+\param size number of strings
+\param rng random numbers generator
+\return urls of few hosts with random paths, random lowercase words of 1 to 12 letters
+or strings with 200 characters long common prefix and random suffixes
+*/
+std::vector<std::string> GenerateStrings(StringDistribution distribution, size_t size, std::mt19937_64& rng);
+
+/**
+\brief statistics of one measured case
+*/
+struct BenchmarkResult {
+    std::string algorithm;
+    std::string type;
+    std::string distribution;
+    size_t size;
+    size_t workers;
+    double minMs;
+    double medianMs;
+    double p95Ms;
+    size_t allocations;
+    PerfCounters::Values counters;
+};
+
+/**
+\brief benchmark options, parsed from command line
+*/
+struct BenchmarkOptions {
+    size_t warmups = 1;
+    size_t repetitions = 5;
+    size_t maxSize = 10'000'000;
+    std::string csvPath = "benchmark.csv";
+    std::string jsonPath = "benchmark.json";
+    bool counters = false;
+};
+
+/**
+\brief parses benchmark options
+
+\param argc number of arguments
+\param argv arguments: --warmups N, --repetitions N, --max-size N, --csv PATH, --json PATH, --counters
+\return parsed options, defaults for missing ones
+\throw std::invalid_argument if option is unknown or has no value
+*/
+BenchmarkOptions ParseBenchmarkOptions(int argc, char** argv);
+
+/**
+\brief class definition of benchmark driver
+
+Every case is run warmups + repetitions times on fresh copy of input, only repetitions are measured.
+Results are written as CSV or JSON, one line or object per case, so reports of two builds can be diffed
+*/
+class Benchmark {
+public:
+    /**
+    \brief Benchmark ctor
+
+    \param warmups number of not measured runs
+    \param repetitions number of measured runs
+    \param log stream every result is printed to as soon as it is measured
+    \param counters true to measure hardware counters, their mean per repetition is reported
+    */
+    Benchmark(size_t warmups, size_t repetitions, std::ostream& log, bool counters = false);
+
+    /**
+    \brief measures sort of input
+
+    \param algorithm name of algorithm
+    \param distribution name of input distribution
+    \param workers number of workers sort runs on
+    \param input input to sort, it is copied before every run
+    \param sort function that takes begin and end iterators of copy
+    \throw std::logic_error if sort result is not sorted
+    */
+    template<typename T, typename Sort>
+    void Measure(const std::string& algorithm, const std::string& distribution, size_t workers,
+        const std::vector<T>& input, Sort sort) {
+        Measure(algorithm, distribution, workers, input, sort, [](const std::vector<T>& result) {
+            return std::is_sorted(result.begin(), result.end());
+        });
+    }
+
+    /**
+    \brief measures algorithm that doesn't sort whole input, for example selection
+
+    \param algorithm name of algorithm
+    \param distribution name of input distribution
+    \param workers number of workers algorithm runs on
+    \param input input of algorithm, it is copied before every run
+    \param run function that takes begin and end iterators of copy
+    \param check function that takes copy after run and returns true if result is correct
+    \throw std::logic_error if check fails
+    */
+    template<typename T, typename Run, typename Check>
+    void Measure(const std::string& algorithm, const std::string& distribution, size_t workers,
+        const std::vector<T>& input, Run run, Check check) {
+        std::vector<double> times;
+        times.reserve(repetitions);
+        size_t allocations = 0;
+        PerfCounters::Values countersTotal;
+        for (size_t i = 0; i < warmups + repetitions; i++) {
+            std::vector<T> copy = input;
+            std::unique_ptr<PerfCounters> perfCounters = counters && i >= warmups ? std::make_unique<PerfCounters>() : nullptr;
+            size_t allocationsBefore = GetAllocationsCount();
+            auto start = std::chrono::steady_clock::now();
+            run(copy.begin(), copy.end());
+            auto finish = std::chrono::steady_clock::now();
+            if (i >= warmups) {
+                times.push_back(std::chrono::duration<double, std::milli>(finish - start).count());
+                allocations = GetAllocationsCount() - allocationsBefore;
+            }
+            if (perfCounters) {
+                AddCounters(countersTotal, perfCounters->Read());
+            }
+            if (!check(copy)) {
+                throw std::logic_error(algorithm + " failed on " + distribution + " " + ElementTraits<T>::Name());
+            }
+        }
+        Add(algorithm, ElementTraits<T>::Name(), distribution, input.size(), workers, times, allocations, countersTotal);
+    }
+
+    /**
+    \brief results getter
+
+    \return results of all measured cases
+    */
+    const std::vector<BenchmarkResult>& GetResults() const;
+
+    /**
+    \brief writes results as CSV with header line
+
+    \param out output stream
+    */
+    void WriteCsv(std::ostream& out) const;
+
+    /**
+    \brief writes results as JSON array of objects
+
+    \param out output stream
+    */
+    void WriteJson(std::ostream& out) const;
+private:
+    void Add(const std::string& algorithm, const std::string& type, const std::string& distribution,
+        size_t size, size_t workers, std::vector<double> times, size_t allocations, PerfCounters::Values counters);
+    static void AddCounters(PerfCounters::Values& total, const PerfCounters::Values& values);
+
+    size_t warmups;
+    size_t repetitions;
+    bool counters;
+    std::ostream& log;
+    std::vector<BenchmarkResult> results;
+};
@@ -0,0 +1,200 @@
+/**
+\file
+\brief .cpp file with implementation of calibration of sortings thresholds
+*/
+
+#include "Calibration.h"
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "Benchmark.h"
+#include "ParallelPrimitives.h"
+#include "Sorting.h"
+#include "StringSort.h"
+
+namespace {
+    /**
+    \brief measurement of one input with current tuning, takes benchmark and name of case
+    */
+    using Case = std::function<void(Benchmark&, const std::string&)>;
+
+    const std::vector<size_t> grainCandidates{ 1000, 2000, 5000, 10'000, 20'000, 50'000 };
+
+    /**
+    \brief adds cases of sorting random inputs of type T
+
+    \param cases cases inputs are added to
+    \param sizes sizes of inputs
+    \param workers number of workers sort runs on
+    \param sort function that takes begin and end iterators of input
+    */
+    template<typename T, typename Sort>
+    void AddCases(std::vector<Case>& cases, const std::vector<size_t>& sizes, size_t workers, Sort sort) {
+        static std::mt19937_64 rng{ std::random_device()() };
+        for (size_t size : sizes) {
+            auto input = std::make_shared<std::vector<T>>(GenerateInput<T>(Distribution::Random, size, rng));
+            cases.push_back([input, workers, sort](Benchmark& benchmark, const std::string& name) {
+                benchmark.Measure(name, ToString(Distribution::Random), workers, *input, sort);
+            });
+        }
+    }
+
+    /**
+    \brief adds cases of sorting int64, double and 16 bytes records
+    */
+    template<typename Sort>
+    std::vector<Case> MakeCases(const std::vector<size_t>& sizes, size_t workers, Sort sort) {
+        std::vector<Case> cases;
+        AddCases<int64_t>(cases, sizes, workers, sort);
+        AddCases<double>(cases, sizes, workers, sort);
+        AddCases<Record<16>>(cases, sizes, workers, sort);
+        return cases;
+    }
+
+    /**
+    \brief measures cases with every candidate value of parameter and sets the best one
+
+    \param parameter calibrated parameter
+    \param candidates candidate values
+    \param cases measured cases
+    \param repetitions number of measured runs of every case
+    \param log stream measurements and chosen value are printed to
+    */
+    void Choose(SortingTuning::Parameter parameter, const std::vector<size_t>& candidates, const std::vector<Case>& cases,
+        size_t repetitions, std::ostream& log) {
+        std::string name = SortingTuning::GetName(parameter);
+        std::vector<std::vector<double>> times;
+        for (size_t candidate : candidates) {
+            SortingTuning::Set(parameter, candidate);
+            Benchmark benchmark(1, repetitions, log);
+            for (const auto& measure : cases) {
+                measure(benchmark, name + " = " + std::to_string(candidate));
+            }
+            times.emplace_back();
+            for (const auto& result : benchmark.GetResults()) {
+                times.back().push_back(std::max(result.medianMs, 1e-6));
+            }
+        }
+        size_t best = 0;
+        double bestScore = std::numeric_limits<double>::max();
+        for (size_t candidate = 0; candidate < candidates.size(); candidate++) {
+            double score = 0;
+            for (size_t i = 0; i < cases.size(); i++) {
+                double fastest = std::numeric_limits<double>::max();
+                for (const auto& candidateTimes : times) {
+                    fastest = std::min(fastest, candidateTimes[i]);
+                }
+                score += times[candidate][i] / fastest;
+            }
+            if (score < bestScore) {
+                bestScore = score;
+                best = candidate;
+            }
+        }
+        SortingTuning::Set(parameter, candidates[best]);
+        log << name << ": " << candidates[best] << std::endl;
+    }
+}
+
+CalibrationOptions ParseCalibrationOptions(int argc, char** argv) {
+    CalibrationOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (i + 1 == argc) {
+            throw std::invalid_argument("no value for option " + option);
+        }
+        std::string value = argv[++i];
+        if (option == "--output") {
+            options.outputPath = value;
+        }
+        else if (option == "--max-size") {
+            options.maxSize = std::max<size_t>(std::stoull(value), 1);
+        }
+        else if (option == "--repetitions") {
+            options.repetitions = std::max<size_t>(std::stoull(value), 1);
+        }
+        else {
+            throw std::invalid_argument("unknown option " + option);
+        }
+    }
+    return options;
+}
+
+void Calibrate(const CalibrationOptions& options, ThreadPool& pool, std::ostream& log) {
+    std::vector<size_t> sizes;
+    for (size_t size : {2'000, 10'000, 100'000, 1'000'000}) {
+        if (size <= options.maxSize) {
+            sizes.push_back(size);
+        }
+    }
+    if (sizes.empty()) {
+        sizes.push_back(options.maxSize);
+    }
+    size_t workers = pool.GetWorkersCount();
+
+    Choose(SortingTuning::SampleSortCutoff, { 250, 500, 1000, 2000, 4000 }, MakeCases(sizes, 1, [](auto begin, auto end) {
+        SampleSort<decltype(begin)>::Sort(begin, end);
+    }), options.repetitions, log);
+    Choose(SortingTuning::QuickSortGrain, grainCandidates, MakeCases(sizes, workers, [&pool](auto begin, auto end) {
+        QuickSort<decltype(begin)>::SortParallel(begin, end, pool);
+    }), options.repetitions, log);
+    Choose(SortingTuning::MergeSortGrain, grainCandidates, MakeCases(sizes, workers, [&pool](auto begin, auto end) {
+        MergeSort<decltype(begin)>::SortParallel(begin, end, pool);
+    }), options.repetitions, log);
+    Choose(SortingTuning::MergeGrain, { 10'000, 20'000, 50'000, 100'000, 200'000 }, MakeCases(sizes, workers, [&pool](auto begin, auto end) {
+        MergeSort<decltype(begin)>::SortParallel(begin, end, pool);
+    }), options.repetitions, log);
+    Choose(SortingTuning::SampleSortGrain, grainCandidates, MakeCases(sizes, workers, [&pool](auto begin, auto end) {
+        SampleSort<decltype(begin)>::SortParallel(begin, end, pool);
+    }), options.repetitions, log);
+
+    std::vector<Case> radixCases;
+    auto radixSort = [&pool](auto begin, auto end) {
+        RadixSort<decltype(begin)>::SortParallel(begin, end, pool);
+    };
+    AddCases<int64_t>(radixCases, sizes, workers, radixSort);
+    AddCases<double>(radixCases, sizes, workers, radixSort);
+    Choose(SortingTuning::RadixSortGrain, grainCandidates, radixCases, options.repetitions, log);
+
+    std::vector<Case> indirectCases;
+    AddCases<int64_t>(indirectCases, sizes, workers, [&pool](auto begin, auto end) {
+        std::vector<uint32_t> payload(end - begin);
+        IndirectSort<QuickSort>::SortByKeyParallel(begin, end, payload.begin(), pool);
+    });
+    Choose(SortingTuning::IndirectSortGrain, grainCandidates, indirectCases, options.repetitions, log);
+
+    std::vector<Case> stringCases;
+    for (size_t size : sizes) {
+        static std::mt19937_64 rng{ std::random_device()() };
+        auto input = std::make_shared<std::vector<std::string>>(GenerateStrings(StringDistribution::Words, size, rng));
+        stringCases.push_back([input, workers, &pool](Benchmark& benchmark, const std::string& name) {
+            benchmark.Measure(name, ToString(StringDistribution::Words), workers, *input, [&pool](auto begin, auto end) {
+                StringSort<decltype(begin)>::RadixSortParallel(begin, end, pool);
+            });
+        });
+    }
+    Choose(SortingTuning::StringSortGrain, grainCandidates, stringCases, options.repetitions, log);
+
+    std::vector<Case> primitivesCases;
+    for (size_t size : sizes) {
+        static std::mt19937_64 rng{ std::random_device()() };
+        auto input = std::make_shared<std::vector<int64_t>>(GenerateInput<int64_t>(Distribution::Random, size, rng));
+        primitivesCases.push_back([input, workers, &pool](Benchmark& benchmark, const std::string& name) {
+            benchmark.Measure(name, ToString(Distribution::Random), workers, *input, [&pool](auto begin, auto end) {
+                ParallelPrimitives::StablePartition(begin, end, [](int64_t element) { return element % 2 == 0; }, pool);
+                ParallelPrimitives::InclusiveScan(begin, end, begin, pool);
+            }, [](const std::vector<int64_t>&) { return true; });
+        });
+    }
+    Choose(SortingTuning::PrimitivesGrain, grainCandidates, primitivesCases, options.repetitions, log);
+
+    std::vector<Case> slowCases;
+    AddCases<int64_t>(slowCases, { std::min<size_t>(options.maxSize, 100) }, workers, [&pool](auto begin, auto end) {
+        SlowSort<decltype(begin)>::SortParallel(begin, end, pool);
+    });
+    Choose(SortingTuning::SlowSortGrain, { 10, 20, 50, 100 }, slowCases, options.repetitions, log);
+}
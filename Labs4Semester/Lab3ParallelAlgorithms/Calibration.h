@@ -0,0 +1,46 @@
+/**
+\file
+\brief .h file with definition of calibration of sortings thresholds on current machine
+*/
+
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include "SortingTuning.h"
+#include "ThreadPool.h"
+
+/**
+\brief calibration options, parsed from command line
+*/
+struct CalibrationOptions {
+    std::string outputPath = SortingTuning::GetDefaultPath();
+    size_t maxSize = 1'000'000;
+    size_t repetitions = 3;
+};
+
+/**
+\brief parses calibration options
+
+\param argc number of arguments
+\param argv arguments: --output PATH, --max-size N, --repetitions N
+\return parsed options, defaults for missing ones
+\throw std::invalid_argument if option is unknown or has no value
+*/
+CalibrationOptions ParseCalibrationOptions(int argc, char** argv);
+
+/**
+\brief calibrates every parameter of SortingTuning and sets the best values
+
+Parameters are calibrated one by one, others keep their current values. Every candidate value is measured on
+random int64, double and 16 bytes records inputs (string sortings grain on random words, parallel primitives grain
+on stable partition and scan of random int64) of several sizes
+up to maxSize, the chosen value has minimal sum
+of times relative to the best candidate of every input, so no input size dominates the choice
+
+\param options sizes and repetitions of measurements
+\param pool thread pool parallel sortings run on
+\param log stream measurements and chosen values are printed to
+*/
+void Calibrate(const CalibrationOptions& options, ThreadPool& pool, std::ostream& log);
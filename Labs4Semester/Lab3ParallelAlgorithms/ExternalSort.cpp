@@ -0,0 +1,540 @@
+/**
+\file
+\brief .cpp file with implementation of external sort
+*/
+
+#include "ExternalSort.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "Sorting.h"
+
+namespace {
+#ifdef _WIN32
+    const int directFlag = 0;
+
+    int OpenFile(const std::string& path, int flags) {
+        return _open(path.c_str(), flags | _O_BINARY, _S_IREAD | _S_IWRITE);
+    }
+
+    long long ReadFile(int descriptor, char* data, size_t size) {
+        return _read(descriptor, data, static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+    }
+
+    long long WriteFile(int descriptor, const char* data, size_t size) {
+        return _write(descriptor, data, static_cast<unsigned>(std::min<size_t>(size, 1 << 30)));
+    }
+
+    bool TruncateFile(int descriptor, uint64_t size) {
+        return _chsize_s(descriptor, static_cast<long long>(size)) == 0;
+    }
+
+    void CloseFile(int descriptor) {
+        _close(descriptor);
+    }
+#else
+#ifdef O_DIRECT
+    const int directFlag = O_DIRECT;
+#else
+    const int directFlag = 0;
+#endif
+
+    int OpenFile(const std::string& path, int flags) {
+        return open(path.c_str(), flags, 0644);
+    }
+
+    long long ReadFile(int descriptor, char* data, size_t size) {
+        return read(descriptor, data, size);
+    }
+
+    long long WriteFile(int descriptor, const char* data, size_t size) {
+        return write(descriptor, data, size);
+    }
+
+    bool TruncateFile(int descriptor, uint64_t size) {
+        return ftruncate(descriptor, static_cast<off_t>(size)) == 0;
+    }
+
+    void CloseFile(int descriptor) {
+        close(descriptor);
+    }
+#endif
+
+    const size_t directAlignment = 4096;
+    const size_t minMergeBuffer = 1 << 20;
+
+    size_t RoundUp(size_t value, size_t unit) {
+        return (value + unit - 1) / unit * unit;
+    }
+
+    class File {
+    public:
+        File(const std::string& path, int flags, bool direct)
+            : path(path)
+            , descriptor(direct && directFlag ? OpenFile(path, flags | directFlag) : -1) {
+            if (descriptor < 0) {
+                descriptor = OpenFile(path, flags);
+            }
+            if (descriptor < 0) {
+                throw std::runtime_error("can't open " + path + ": " + std::strerror(errno));
+            }
+        }
+
+        ~File() {
+            CloseFile(descriptor);
+        }
+
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        size_t Read(char* data, size_t size) {
+            size_t done = 0;
+            while (done < size) {
+                long long count = ReadFile(descriptor, data + done, size - done);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count < 0) {
+                    throw std::runtime_error("can't read " + path + ": " + std::strerror(errno));
+                }
+                if (count == 0) {
+                    break;
+                }
+                done += static_cast<size_t>(count);
+            }
+            return done;
+        }
+
+        void Write(const char* data, size_t size) {
+            size_t done = 0;
+            while (done < size) {
+                long long count = WriteFile(descriptor, data + done, size - done);
+                if (count < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (count <= 0) {
+                    throw std::runtime_error("can't write " + path + ": " + std::strerror(errno));
+                }
+                done += static_cast<size_t>(count);
+            }
+        }
+
+        void Truncate(uint64_t size) {
+            if (!TruncateFile(descriptor, size)) {
+                throw std::runtime_error("can't truncate " + path + ": " + std::strerror(errno));
+            }
+        }
+    private:
+        std::string path;
+        int descriptor;
+    };
+
+    struct AlignedDelete {
+        size_t alignment;
+
+        void operator()(char* data) const {
+            ::operator delete(data, std::align_val_t(alignment));
+        }
+    };
+
+    using AlignedBuffer = std::unique_ptr<char[], AlignedDelete>;
+
+    AlignedBuffer MakeBuffer(size_t size, size_t alignment) {
+        void* data = ::operator new(std::max(size, alignment), std::align_val_t(alignment));
+        return AlignedBuffer(static_cast<char*>(data), AlignedDelete{ alignment });
+    }
+
+    /**
+    reads run through two buffers: records are taken from one of them while the other is filled asynchronously
+    */
+    class RunReader {
+    public:
+        RunReader(const std::string& path, size_t bufferSize, size_t alignment, size_t recordSize, bool direct)
+            : file(path, O_RDONLY, direct)
+            , bufferSize(bufferSize)
+            , recordSize(recordSize) {
+            for (auto& buffer : buffers) {
+                buffer = MakeBuffer(bufferSize, alignment);
+            }
+            sizes[0] = file.Read(buffers[0].get(), bufferSize);
+            if (sizes[0] == bufferSize) {
+                ReadAhead(1);
+            }
+        }
+
+        ~RunReader() {
+            if (pending.valid()) {
+                pending.wait();
+            }
+        }
+
+        bool IsExhausted() const {
+            return position == sizes[current];
+        }
+
+        const char* GetRecord() const {
+            return buffers[current].get() + position;
+        }
+
+        void Next() {
+            position += recordSize;
+            if (position == sizes[current] && sizes[current] == bufferSize) {
+                current = 1 - current;
+                sizes[current] = pending.get();
+                position = 0;
+                if (sizes[current] == bufferSize) {
+                    ReadAhead(1 - current);
+                }
+            }
+        }
+    private:
+        void ReadAhead(size_t index) {
+            char* data = buffers[index].get();
+            pending = std::async(std::launch::async, [this, data]() { return file.Read(data, bufferSize); });
+        }
+
+        File file;
+        size_t bufferSize;
+        size_t recordSize;
+        AlignedBuffer buffers[2];
+        size_t sizes[2] = { 0, 0 };
+        size_t current = 0;
+        size_t position = 0;
+        std::future<size_t> pending;
+    };
+
+    /**
+    writes run through two buffers: records are put in one of them while the other is written asynchronously
+    */
+    class RunWriter {
+    public:
+        RunWriter(const std::string& path, size_t bufferSize, size_t alignment, bool direct)
+            : file(path, O_WRONLY | O_CREAT | O_TRUNC, direct)
+            , bufferSize(bufferSize)
+            , alignment(alignment) {
+            for (auto& buffer : buffers) {
+                buffer = MakeBuffer(bufferSize, alignment);
+            }
+        }
+
+        ~RunWriter() {
+            if (pending.valid()) {
+                pending.wait();
+            }
+        }
+
+        void Append(const char* record, size_t size) {
+            std::memcpy(buffers[current].get() + filled, record, size);
+            filled += size;
+            if (filled == bufferSize) {
+                Flush();
+            }
+        }
+
+        void Finish() {
+            Flush();
+            pending.get();
+            if (written % alignment) {
+                file.Truncate(written);
+            }
+        }
+    private:
+        void Flush() {
+            if (pending.valid()) {
+                pending.get();
+            }
+            char* data = buffers[current].get();
+            size_t size = RoundUp(filled, alignment);
+            std::memset(data + filled, 0, size - filled);
+            written += filled;
+            pending = std::async(std::launch::async, [this, data, size]() { file.Write(data, size); });
+            current = 1 - current;
+            filled = 0;
+        }
+
+        File file;
+        size_t bufferSize;
+        size_t alignment;
+        AlignedBuffer buffers[2];
+        size_t current = 0;
+        size_t filled = 0;
+        uint64_t written = 0;
+        std::future<void> pending;
+    };
+
+    /**
+    tournament tree of losers: internal node keeps loser of its match, so replay after winner changes
+    takes one comparison per level
+    */
+    template<typename Less>
+    class LoserTree {
+    public:
+        LoserTree(size_t count, Less less)
+            : count(count)
+            , losers(count)
+            , less(less) {
+            std::vector<size_t> winners(2 * count);
+            for (size_t i = 0; i < count; i++) {
+                winners[count + i] = i;
+            }
+            for (size_t node = count - 1; node > 0; node--) {
+                size_t left = winners[2 * node], right = winners[2 * node + 1];
+                bool rightWins = less(right, left);
+                winners[node] = rightWins ? right : left;
+                losers[node] = rightWins ? left : right;
+            }
+            winner = count > 1 ? winners[1] : 0;
+        }
+
+        size_t GetWinner() const {
+            return winner;
+        }
+
+        void Replay() {
+            size_t current = winner;
+            for (size_t node = (winner + count) / 2; node > 0; node /= 2) {
+                if (less(losers[node], current)) {
+                    std::swap(losers[node], current);
+                }
+            }
+            winner = current;
+        }
+    private:
+        size_t count;
+        std::vector<size_t> losers;
+        Less less;
+        size_t winner;
+    };
+}
+
+ExternalSortOptions ParseExternalSortOptions(int argc, char** argv) {
+    ExternalSortOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--direct") {
+            options.direct = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            throw std::invalid_argument("no value for option " + option);
+        }
+        std::string value = argv[++i];
+        if (option == "--input") {
+            options.inputPath = value;
+        }
+        else if (option == "--output") {
+            options.outputPath = value;
+        }
+        else if (option == "--temp") {
+            options.temporaryDirectory = value;
+        }
+        else if (option == "--record-size") {
+            options.recordSize = std::stoull(value);
+        }
+        else if (option == "--key-offset") {
+            options.keyOffset = std::stoull(value);
+        }
+        else if (option == "--key-size") {
+            options.keySize = std::stoull(value);
+        }
+        else if (option == "--memory") {
+            options.memoryBytes = std::stoull(value) << 20;
+        }
+        else {
+            throw std::invalid_argument("unknown option " + option);
+        }
+    }
+    if (options.inputPath.empty() || options.outputPath.empty()) {
+        throw std::invalid_argument("input and output paths are required");
+    }
+    return options;
+}
+
+double ExternalSortStatistics::GetThroughput() const {
+    double seconds = runGenerationSeconds + mergeSeconds;
+    return seconds > 0 ? static_cast<double>(bytes) / (1 << 20) / seconds : 0;
+}
+
+ExternalSort::ExternalSort(const ExternalSortOptions& options, ThreadPool& pool)
+    : options(options)
+    , pool(pool)
+    , alignment(options.direct ? directAlignment : 1)
+    , unitSize(std::lcm(std::max<size_t>(options.recordSize, 1), alignment)) {
+    if (options.recordSize == 0 || options.keySize == 0 || options.keySize > sizeof(uint64_t)
+        || options.keyOffset + options.keySize > options.recordSize) {
+        throw std::invalid_argument("key must be 1 to 8 bytes inside record");
+    }
+    if (options.memoryBytes < 4 * unitSize || options.memoryBytes < 2 * options.recordSize + 2 * sizeof(Entry)) {
+        throw std::invalid_argument("memory budget is too small for record size");
+    }
+    std::random_device device;
+    runPrefix = (std::filesystem::path(options.temporaryDirectory) / ("external_sort_" + std::to_string(device()) + "_")).string();
+}
+
+ExternalSortStatistics ExternalSort::Sort() {
+    ExternalSortStatistics statistics;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Run> runs = GenerateRuns();
+    auto generated = std::chrono::steady_clock::now();
+    statistics.runs = runs.size();
+    for (const auto& run : runs) {
+        statistics.bytes += run.bytes;
+    }
+    size_t fanIn = std::max<size_t>(3, options.memoryBytes / (2 * RoundUp(minMergeBuffer, unitSize))) - 1;
+    while (runs.size() > fanIn) {
+        std::vector<Run> merged;
+        for (size_t i = 0; i < runs.size(); i += fanIn) {
+            std::vector<Run> group(runs.begin() + i, runs.begin() + std::min(i + fanIn, runs.size()));
+            if (group.size() == 1) {
+                merged.push_back(group[0]);
+                continue;
+            }
+            Run run{ GetRunPath(), 0 };
+            for (const auto& part : group) {
+                run.bytes += part.bytes;
+            }
+            MergeRuns(group, run.path);
+            merged.push_back(run);
+        }
+        runs = std::move(merged);
+        statistics.mergePasses++;
+    }
+    if (runs.empty()) {
+        File output(options.outputPath, O_WRONLY | O_CREAT | O_TRUNC, false);
+    }
+    else if (runs.size() > 1 || runs[0].path != options.outputPath) {
+        MergeRuns(runs, options.outputPath);
+        statistics.mergePasses++;
+    }
+    auto finish = std::chrono::steady_clock::now();
+    statistics.runGenerationSeconds = std::chrono::duration<double>(generated - start).count();
+    statistics.mergeSeconds = std::chrono::duration<double>(finish - generated).count();
+    return statistics;
+}
+
+uint64_t ExternalSort::ReadKey(const char* record) const {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(record + options.keyOffset);
+    uint64_t key = 0;
+    for (size_t i = 0; i < options.keySize; i++) {
+        key = key << 8 | bytes[i];
+    }
+    return key;
+}
+
+std::vector<ExternalSort::Run> ExternalSort::GenerateRuns() {
+    using EntryIterator = std::vector<Entry>::iterator;
+    size_t recordSize = options.recordSize;
+    size_t chunkRecords = options.memoryBytes / (2 * recordSize + 2 * sizeof(Entry));
+    size_t chunkBytes = chunkRecords * recordSize;
+    size_t workers = pool.GetWorkersCount();
+    File input(options.inputPath, O_RDONLY, false);
+    AlignedBuffer chunk = MakeBuffer(chunkBytes, alignment);
+    AlignedBuffer sorted = MakeBuffer(RoundUp(chunkBytes, alignment), alignment);
+    std::vector<Entry> entries(chunkRecords);
+    std::vector<Run> runs;
+    std::future<void> pending;
+    while (true) {
+        size_t bytes = input.Read(chunk.get(), chunkBytes);
+        if (bytes % recordSize) {
+            throw std::runtime_error("size of " + options.inputPath + " is not multiple of record size");
+        }
+        if (bytes == 0) {
+            break;
+        }
+        size_t count = bytes / recordSize;
+        ParallelFor(pool, workers, [&](size_t worker) {
+            for (size_t i = count * worker / workers; i < count * (worker + 1) / workers; i++) {
+                entries[i] = { ReadKey(chunk.get() + i * recordSize), i };
+            }
+        });
+        RadixSort<EntryIterator>::SortParallel(entries.begin(), entries.begin() + count,
+            [](const Entry& entry) { return entry.key; }, pool);
+        if (pending.valid()) {
+            pending.get();
+        }
+        ParallelFor(pool, workers, [&](size_t worker) {
+            for (size_t i = count * worker / workers; i < count * (worker + 1) / workers; i++) {
+                std::memcpy(sorted.get() + i * recordSize, chunk.get() + entries[i].index * recordSize, recordSize);
+            }
+        });
+        bool last = bytes < chunkBytes;
+        runs.push_back({ last && runs.empty() ? options.outputPath : GetRunPath(), bytes });
+        Run run = runs.back();
+        pending = std::async(std::launch::async, [this, &sorted, run]() {
+            File file(run.path, O_WRONLY | O_CREAT | O_TRUNC, options.direct);
+            size_t size = RoundUp(run.bytes, alignment);
+            std::memset(sorted.get() + run.bytes, 0, size - run.bytes);
+            file.Write(sorted.get(), size);
+            if (size != run.bytes) {
+                file.Truncate(run.bytes);
+            }
+        });
+        if (last) {
+            break;
+        }
+    }
+    if (pending.valid()) {
+        pending.get();
+    }
+    return runs;
+}
+
+void ExternalSort::MergeRuns(const std::vector<Run>& runs, const std::string& outputPath) {
+    size_t recordSize = options.recordSize;
+    size_t bufferSize = std::max(unitSize, options.memoryBytes / (2 * (runs.size() + 1)) / unitSize * unitSize);
+    {
+        std::vector<std::unique_ptr<RunReader>> readers;
+        std::vector<uint64_t> keys(runs.size());
+        for (size_t i = 0; i < runs.size(); i++) {
+            readers.push_back(std::make_unique<RunReader>(runs[i].path, bufferSize, alignment, recordSize, options.direct));
+            if (!readers[i]->IsExhausted()) {
+                keys[i] = ReadKey(readers[i]->GetRecord());
+            }
+        }
+        auto less = [&readers, &keys](size_t left, size_t right) {
+            if (readers[left]->IsExhausted()) {
+                return false;
+            }
+            if (readers[right]->IsExhausted()) {
+                return true;
+            }
+            return keys[left] < keys[right] || (keys[left] == keys[right] && left < right);
+        };
+        LoserTree<decltype(less)> tree(runs.size(), less);
+        RunWriter writer(outputPath, bufferSize, alignment, options.direct);
+        for (size_t winner = tree.GetWinner(); !readers[winner]->IsExhausted(); winner = tree.GetWinner()) {
+            writer.Append(readers[winner]->GetRecord(), recordSize);
+            readers[winner]->Next();
+            if (!readers[winner]->IsExhausted()) {
+                keys[winner] = ReadKey(readers[winner]->GetRecord());
+            }
+            tree.Replay();
+        }
+        writer.Finish();
+    }
+    for (const auto& run : runs) {
+        std::filesystem::remove(run.path);
+    }
+}
+
+std::string ExternalSort::GetRunPath() {
+    return runPrefix + std::to_string(runsCount++) + ".run";
+}
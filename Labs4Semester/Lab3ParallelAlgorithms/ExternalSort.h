@@ -0,0 +1,109 @@
+/**
+\file
+\brief .h file with definition of external (out-of-core) sort of binary record files
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+/**
+\brief external sort options, parsed from command line
+*/
+struct ExternalSortOptions {
+    std::string inputPath;
+    std::string outputPath;
+    std::string temporaryDirectory = ".";
+    size_t recordSize = 8;
+    size_t keyOffset = 0;
+    size_t keySize = 8;
+    size_t memoryBytes = size_t(1) << 30;
+    bool direct = false;
+};
+
+/**
+\brief parses external sort options
+
+\param argc number of arguments
+\param argv arguments: --input PATH, --output PATH, --record-size N, --key-offset N, --key-size N,
+--memory MB, --temp DIR, --direct
+\return parsed options, defaults for missing ones
+\throw std::invalid_argument if option is unknown, has no value or input or output path is missing
+*/
+ExternalSortOptions ParseExternalSortOptions(int argc, char** argv);
+
+/**
+\brief statistics of external sort
+*/
+struct ExternalSortStatistics {
+    uint64_t bytes = 0;
+    size_t runs = 0;
+    size_t mergePasses = 0;
+    double runGenerationSeconds = 0;
+    double mergeSeconds = 0;
+
+    /**
+    \brief throughput getter
+
+    \return input megabytes sorted per second of run generation and merge
+    */
+    double GetThroughput() const;
+};
+
+/**
+\brief class that implements external sort of file of fixed size records
+
+Key is keySize bytes at keyOffset of every record compared as unsigned big-endian number,
+so records are ordered as memcmp of their keys. Sort is stable.
+Run generation reads chunks that fit in memory together with sorted copy and key-index pairs,
+sorts the pairs with parallel radix sort and writes runs
+while the next chunk is read and sorted. Runs are merged by loser tree, every run is read ahead
+asynchronously into the second of its two buffers, output is written asynchronously the same way.
+If there are too many runs for one merge, they are merged in several passes.
+With direct option temporary runs and output are written and read with O_DIRECT where it is supported
+*/
+class ExternalSort {
+public:
+    /**
+    \brief ExternalSort ctor
+
+    \param options record layout, memory budget and files
+    \param pool thread pool in-memory sorts run on
+    \throw std::invalid_argument if key doesn't fit in record or memory budget is too small
+    */
+    explicit ExternalSort(const ExternalSortOptions& options, ThreadPool& pool = ThreadPool::GetDefault());
+
+    /**
+    \brief sorts input file to output file
+
+    \return statistics of sort
+    \throw std::runtime_error if file can't be read or written or input size is not multiple of record size
+    */
+    ExternalSortStatistics Sort();
+private:
+    struct Run {
+        std::string path;
+        uint64_t bytes;
+    };
+
+    struct Entry {
+        uint64_t key;
+        size_t index;
+    };
+
+    uint64_t ReadKey(const char* record) const;
+    std::vector<Run> GenerateRuns();
+    void MergeRuns(const std::vector<Run>& runs, const std::string& outputPath);
+    std::string GetRunPath();
+
+    ExternalSortOptions options;
+    ThreadPool& pool;
+    size_t alignment;
+    size_t unitSize;
+    std::string runPrefix;
+    size_t runsCount = 0;
+};
@@ -0,0 +1,362 @@
+/**
+\file
+\brief .h file with implementations of parallel primitives: scans, reduction, partition, unique and set operations
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "Sorting.h"
+
+/**
+\brief class that implements parallel primitives that run on thread pool as sortings do
+
+Range is split in chunks, one per worker (fewer for small ranges), every algorithm is two or three
+passes over chunks: chunk summaries (sums, counts of kept elements) are found concurrently, combined sequentially
+(one value per chunk) and used by the last pass to write every chunk at its place.
+Ranges smaller than grain are processed by sequence standard algorithms, results are equal to standard algorithms
+*/
+class ParallelPrimitives {
+public:
+    /**
+    \brief parallel inclusive scan
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param output first element of output, may be equal to begin
+    \param pool thread pool scan runs on, default pool by default
+    \param operation associative binary operation, std::plus by default
+    \return next after last element of output
+    */
+    template<typename InputIterator, typename OutputIterator, typename Operation = std::plus<>>
+    static OutputIterator InclusiveScan(InputIterator begin, InputIterator end, OutputIterator output,
+                                        ThreadPool& pool = ThreadPool::GetDefault(), Operation operation = Operation()) {
+        using ValueType = typename std::iterator_traits<InputIterator>::value_type;
+        size_t size = end - begin;
+        std::vector<size_t> bounds = GetChunkBounds<ValueType>(size, pool);
+        size_t chunksCount = bounds.size() - 1;
+        if (chunksCount == 1) {
+            return std::inclusive_scan(begin, end, output, operation);
+        }
+        std::vector<ValueType> sums(chunksCount - 1);
+        ParallelFor(pool, chunksCount - 1, [&](size_t chunk) {
+            sums[chunk] = Reduce(begin + bounds[chunk], begin + bounds[chunk + 1], operation);
+        });
+        for (size_t chunk = 1; chunk < sums.size(); chunk++) {
+            sums[chunk] = operation(sums[chunk - 1], sums[chunk]);
+        }
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            InputIterator chunkBegin = begin + bounds[chunk], chunkEnd = begin + bounds[chunk + 1];
+            if (chunk == 0) {
+                std::inclusive_scan(chunkBegin, chunkEnd, output, operation);
+            }
+            else {
+                std::inclusive_scan(chunkBegin, chunkEnd, output + bounds[chunk], operation, sums[chunk - 1]);
+            }
+        });
+        return output + size;
+    }
+
+    /**
+    \brief parallel exclusive scan
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param output first element of output, may be equal to begin
+    \param init initial value
+    \param pool thread pool scan runs on, default pool by default
+    \param operation associative binary operation, std::plus by default
+    \return next after last element of output
+    */
+    template<typename InputIterator, typename OutputIterator, typename T, typename Operation = std::plus<>>
+    static OutputIterator ExclusiveScan(InputIterator begin, InputIterator end, OutputIterator output, T init,
+                                        ThreadPool& pool = ThreadPool::GetDefault(), Operation operation = Operation()) {
+        using ValueType = typename std::iterator_traits<InputIterator>::value_type;
+        size_t size = end - begin;
+        std::vector<size_t> bounds = GetChunkBounds<ValueType>(size, pool);
+        size_t chunksCount = bounds.size() - 1;
+        if (chunksCount == 1) {
+            return std::exclusive_scan(begin, end, output, init, operation);
+        }
+        std::vector<T> offsets(chunksCount, init);
+        ParallelFor(pool, chunksCount - 1, [&](size_t chunk) {
+            offsets[chunk + 1] = Reduce(begin + bounds[chunk], begin + bounds[chunk + 1], operation);
+        });
+        for (size_t chunk = 1; chunk < chunksCount; chunk++) {
+            offsets[chunk] = operation(offsets[chunk - 1], offsets[chunk]);
+        }
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            std::exclusive_scan(begin + bounds[chunk], begin + bounds[chunk + 1], output + bounds[chunk], offsets[chunk], operation);
+        });
+        return output + size;
+    }
+
+    /**
+    \brief parallel transform and reduce
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param init initial value
+    \param pool thread pool reduction runs on, default pool by default
+    \param reduce associative binary operation, std::plus by default
+    \param transform function applied to every element, Identity by default
+    \return init reduced with transformed elements in order of range, so reduce doesn't need to be commutative
+    */
+    template<typename Iterator, typename T, typename Reduce = std::plus<>, typename Transform = Identity>
+    static T TransformReduce(Iterator begin, Iterator end, T init, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Reduce reduce = Reduce(), Transform transform = Transform()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        std::vector<size_t> bounds = GetChunkBounds<ValueType>(end - begin, pool);
+        size_t chunksCount = bounds.size() - 1;
+        auto reduceRange = [&reduce, &transform](Iterator first, Iterator last, T value) {
+            for (; first != last; ++first) {
+                value = reduce(std::move(value), std::invoke(transform, *first));
+            }
+            return value;
+        };
+        if (chunksCount == 1) {
+            return reduceRange(begin, end, std::move(init));
+        }
+        std::vector<T> partials(chunksCount);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            Iterator chunkBegin = begin + bounds[chunk];
+            partials[chunk] = reduceRange(chunkBegin + 1, begin + bounds[chunk + 1], T(std::invoke(transform, *chunkBegin)));
+        });
+        for (auto& partial : partials) {
+            init = reduce(std::move(init), std::move(partial));
+        }
+        return init;
+    }
+
+    /**
+    \brief parallel stable partition
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param predicate predicate of elements of first group
+    \param pool thread pool partition runs on, default pool by default
+    \return first element of second group
+    \note predicate is called once for every element, elements are moved through scratch buffer
+    */
+    template<typename Iterator, typename Predicate>
+    static Iterator StablePartition(Iterator begin, Iterator end, Predicate predicate, ThreadPool& pool = ThreadPool::GetDefault()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        std::vector<size_t> bounds = GetChunkBounds<ValueType>(end - begin, pool);
+        size_t chunksCount = bounds.size() - 1;
+        if (chunksCount == 1) {
+            return std::stable_partition(begin, end, predicate);
+        }
+        std::vector<char> flags(end - begin);
+        std::vector<size_t> trueOffsets(chunksCount + 1, 0), falseOffsets(chunksCount + 1, 0);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+                flags[i] = predicate(*(begin + i)) ? 1 : 0;
+                trueOffsets[chunk + 1] += flags[i];
+            }
+            falseOffsets[chunk + 1] = bounds[chunk + 1] - bounds[chunk] - trueOffsets[chunk + 1];
+        });
+        std::partial_sum(trueOffsets.begin(), trueOffsets.end(), trueOffsets.begin());
+        falseOffsets[0] = trueOffsets[chunksCount];
+        std::partial_sum(falseOffsets.begin(), falseOffsets.end(), falseOffsets.begin());
+        std::vector<ValueType> buffer(end - begin);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            size_t truePosition = trueOffsets[chunk], falsePosition = falseOffsets[chunk];
+            for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+                buffer[flags[i] ? truePosition++ : falsePosition++] = std::move(*(begin + i));
+            }
+        });
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            std::move(buffer.begin() + bounds[chunk], buffer.begin() + bounds[chunk + 1], begin + bounds[chunk]);
+        });
+        return begin + trueOffsets[chunksCount];
+    }
+
+    /**
+    \brief parallel unique: removes all but first element of every group of consecutive equal elements
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool algorithm runs on, default pool by default
+    \param equal equivalence relation of elements, std::equal_to by default
+    \return next after last element of unique range
+    */
+    template<typename Iterator, typename Equal = std::equal_to<>>
+    static Iterator Unique(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(), Equal equal = Equal()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        std::vector<size_t> bounds = GetChunkBounds<ValueType>(end - begin, pool);
+        size_t chunksCount = bounds.size() - 1;
+        if (chunksCount == 1) {
+            return std::unique(begin, end, equal);
+        }
+        std::vector<char> isKept(end - begin);
+        std::vector<size_t> offsets(chunksCount + 1, 0);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+                isKept[i] = i == 0 || !equal(*(begin + (i - 1)), *(begin + i));
+                offsets[chunk + 1] += isKept[i];
+            }
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        std::vector<ValueType> buffer(offsets[chunksCount]);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            size_t position = offsets[chunk];
+            for (size_t i = bounds[chunk]; i < bounds[chunk + 1]; i++) {
+                if (isKept[i]) {
+                    buffer[position++] = std::move(*(begin + i));
+                }
+            }
+        });
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            std::move(buffer.begin() + offsets[chunk], buffer.begin() + offsets[chunk + 1], begin + offsets[chunk]);
+        });
+        return begin + offsets[chunksCount];
+    }
+
+    /**
+    \brief parallel union of sorted ranges
+
+    \param first1 first element of first range
+    \param last1 next after last element of first range
+    \param first2 first element of second range
+    \param last2 next after last element of second range
+    \param output first element of output
+    \param pool thread pool algorithm runs on, default pool by default
+    \param compare order of elements, std::less by default
+    \return next after last element of output
+    \note multiset union as std::set_union: max(m, n) copies of element with m copies in first range and n in second
+    */
+    template<typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare = std::less<>>
+    static OutputIterator SetUnion(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2, OutputIterator output,
+                                   ThreadPool& pool = ThreadPool::GetDefault(), Compare compare = Compare()) {
+        return SetOperation(first1, last1, first2, last2, output, pool, compare, [&compare](auto... arguments) {
+            return std::set_union(arguments..., compare);
+        });
+    }
+
+    /**
+    \brief parallel intersection of sorted ranges
+
+    \param first1 first element of first range
+    \param last1 next after last element of first range
+    \param first2 first element of second range
+    \param last2 next after last element of second range
+    \param output first element of output
+    \param pool thread pool algorithm runs on, default pool by default
+    \param compare order of elements, std::less by default
+    \return next after last element of output
+    \note multiset intersection as std::set_intersection: min(m, n) copies of element from first range
+    */
+    template<typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare = std::less<>>
+    static OutputIterator SetIntersection(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2, OutputIterator output,
+                                          ThreadPool& pool = ThreadPool::GetDefault(), Compare compare = Compare()) {
+        return SetOperation(first1, last1, first2, last2, output, pool, compare, [&compare](auto... arguments) {
+            return std::set_intersection(arguments..., compare);
+        });
+    }
+
+private:
+    /**
+    \brief output iterator that counts written elements
+    */
+    struct CountingIterator {
+        using iterator_category = std::output_iterator_tag;
+        using value_type = void;
+        using difference_type = ptrdiff_t;
+        using pointer = void;
+        using reference = void;
+
+        size_t* count;
+
+        CountingIterator& operator*() {
+            return *this;
+        }
+
+        template<typename T>
+        CountingIterator& operator=(const T&) {
+            (*count)++;
+            return *this;
+        }
+
+        CountingIterator& operator++() {
+            return *this;
+        }
+
+        CountingIterator operator++(int) {
+            return *this;
+        }
+    };
+
+    /**
+    \brief splits range in chunks
+
+    \param size number of elements
+    \param pool thread pool chunks are processed on
+    \return bounds of chunks: one chunk per worker, but every chunk has at least grain elements
+    */
+    template<typename ValueType>
+    static std::vector<size_t> GetChunkBounds(size_t size, ThreadPool& pool) {
+        size_t grain = static_cast<size_t>(SortingTuning::GetGrain<ValueType>(SortingTuning::PrimitivesGrain));
+        size_t chunksCount = std::clamp<size_t>(size / grain, 1, pool.GetWorkersCount());
+        std::vector<size_t> bounds(chunksCount + 1);
+        for (size_t chunk = 0; chunk <= chunksCount; chunk++) {
+            bounds[chunk] = size * chunk / chunksCount;
+        }
+        return bounds;
+    }
+
+    /**
+    \brief reduces non-empty range in order
+    */
+    template<typename Iterator, typename Operation>
+    static typename std::iterator_traits<Iterator>::value_type Reduce(Iterator begin, Iterator end, Operation& operation) {
+        typename std::iterator_traits<Iterator>::value_type result = *begin;
+        while (++begin != end) {
+            result = operation(std::move(result), *begin);
+        }
+        return result;
+    }
+
+    /**
+    \brief set operation of sorted ranges split by common splitters
+
+    \param operation sequence set operation: takes both ranges and output, returns next after last element of output
+    \note ranges are split at lower bounds of elements of the longer range, so equal elements of both ranges
+    get in the same chunk and chunks results are equal to parts of sequence result. Size of every chunk result
+    is counted first, then chunks write their results at their offsets
+    */
+    template<typename Iterator1, typename Iterator2, typename OutputIterator, typename Compare, typename Operation>
+    static OutputIterator SetOperation(Iterator1 first1, Iterator1 last1, Iterator2 first2, Iterator2 last2, OutputIterator output,
+                                       ThreadPool& pool, Compare& compare, Operation operation) {
+        using ValueType = typename std::iterator_traits<Iterator1>::value_type;
+        size_t size1 = last1 - first1, size2 = last2 - first2;
+        std::vector<size_t> bounds = GetChunkBounds<ValueType>(size1 + size2, pool);
+        size_t chunksCount = bounds.size() - 1;
+        if (chunksCount == 1) {
+            return operation(first1, last1, first2, last2, output);
+        }
+        std::vector<size_t> splits1(chunksCount + 1, size1), splits2(chunksCount + 1, size2);
+        splits1[0] = splits2[0] = 0;
+        for (size_t chunk = 1; chunk < chunksCount; chunk++) {
+            auto splitter = size1 >= size2 ? *(first1 + size1 * chunk / chunksCount) : *(first2 + size2 * chunk / chunksCount);
+            splits1[chunk] = std::lower_bound(first1, last1, splitter, compare) - first1;
+            splits2[chunk] = std::lower_bound(first2, last2, splitter, compare) - first2;
+        }
+        std::vector<size_t> offsets(chunksCount + 1, 0);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            operation(first1 + splits1[chunk], first1 + splits1[chunk + 1], first2 + splits2[chunk], first2 + splits2[chunk + 1],
+                CountingIterator{ &offsets[chunk + 1] });
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            operation(first1 + splits1[chunk], first1 + splits1[chunk + 1], first2 + splits2[chunk], first2 + splits2[chunk + 1],
+                output + offsets[chunk]);
+        });
+        return output + offsets[chunksCount];
+    }
+};
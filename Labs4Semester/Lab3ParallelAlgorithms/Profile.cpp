@@ -5,14 +5,204 @@
 
 #include "profile.h"
 
-LogDuration::LogDuration(const std::string& msg)
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <sstream>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    std::atomic<size_t> allocationsCount{ 0 };
+
+#ifdef __linux__
+    perf_event_attr MakeAttributes(size_t event) {
+        perf_event_attr attributes{};
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.inherit = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        switch (event) {
+        case PerfCounters::Cycles:
+            attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfCounters::Instructions:
+            attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfCounters::L1Misses:
+            attributes.type = PERF_TYPE_HW_CACHE;
+            attributes.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PerfCounters::LlcMisses:
+            attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfCounters::BranchMisses:
+            attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        case PerfCounters::ContextSwitches:
+            attributes.type = PERF_TYPE_SOFTWARE;
+            attributes.config = PERF_COUNT_SW_CONTEXT_SWITCHES;
+            attributes.exclude_kernel = 0;
+            break;
+        }
+        return attributes;
+    }
+
+    std::vector<pid_t> GetThreads() {
+        std::vector<pid_t> threads;
+        if (DIR* directory = opendir("/proc/self/task")) {
+            while (dirent* entry = readdir(directory)) {
+                if (entry->d_name[0] != '.') {
+                    threads.push_back(static_cast<pid_t>(std::atoi(entry->d_name)));
+                }
+            }
+            closedir(directory);
+        }
+        return threads;
+    }
+#endif
+}
+
+void* operator new(std::size_t size) {
+    allocationsCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+size_t GetAllocationsCount() {
+    return allocationsCount.load(std::memory_order_relaxed);
+}
+
+PerfCounters::PerfCounters() {
+#ifdef __linux__
+    std::vector<pid_t> threads = GetThreads();
+    for (size_t event = 0; event < EventsCount; event++) {
+        perf_event_attr attributes = MakeAttributes(event);
+        for (pid_t thread : threads) {
+            int descriptor = static_cast<int>(syscall(SYS_perf_event_open, &attributes, thread, -1, -1, PERF_FLAG_FD_CLOEXEC));
+            if (descriptor >= 0) {
+                descriptors[event].push_back(descriptor);
+            }
+            else if (descriptors[event].empty()) {
+                break;
+            }
+        }
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (const auto& eventDescriptors : descriptors) {
+        for (int descriptor : eventDescriptors) {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+PerfCounters::Values PerfCounters::Read() const {
+    Values values;
+#ifdef __linux__
+    for (size_t event = 0; event < EventsCount; event++) {
+        if (descriptors[event].empty()) {
+            continue;
+        }
+        uint64_t total = 0;
+        for (int descriptor : descriptors[event]) {
+            uint64_t data[3];
+            if (read(descriptor, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+                continue;
+            }
+            total += data[2] < data[1] ? static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]) : data[0];
+        }
+        values[event] = total;
+    }
+#endif
+    return values;
+}
+
+std::string PerfCounters::GetEventName(size_t event) {
+    switch (event) {
+    case Cycles:
+        return "cycles";
+    case Instructions:
+        return "instructions";
+    case L1Misses:
+        return "L1 misses";
+    case LlcMisses:
+        return "LLC misses";
+    case BranchMisses:
+        return "branch misses";
+    case ContextSwitches:
+        return "context switches";
+    }
+    return "unknown";
+}
+
+std::optional<double> PerfCounters::GetIpc(const Values& values) {
+    if (!values[Cycles] || !values[Instructions] || *values[Cycles] == 0) {
+        return std::nullopt;
+    }
+    return static_cast<double>(*values[Instructions]) / *values[Cycles];
+}
+
+std::string PerfCounters::ToString(const Values& values) {
+    std::ostringstream out;
+    for (size_t event = 0; event < EventsCount; event++) {
+        out << (event ? ", " : "") << GetEventName(event) << ": ";
+        if (values[event]) {
+            out << *values[event];
+        }
+        else {
+            out << "n/a";
+        }
+        if (event == Instructions) {
+            out << ", IPC: ";
+            if (auto ipc = GetIpc(values)) {
+                out << std::fixed << std::setprecision(2) << *ipc;
+            }
+            else {
+                out << "n/a";
+            }
+        }
+    }
+    return out.str();
+}
+
+LogDuration::LogDuration(const std::string& msg, bool counters)
     : message(msg + ": ")
-    , start(std::chrono::steady_clock::now()) {}
+    , counters(counters ? std::make_unique<PerfCounters>() : nullptr)
+    , start(std::chrono::steady_clock::now())
+    , allocations(GetAllocationsCount()) {}
 
 LogDuration::~LogDuration() {
     auto finish = std::chrono::steady_clock::now();
     auto dur = finish - start;
+    size_t allocated = GetAllocationsCount() - allocations;
     std::cerr << message
         << std::chrono::duration_cast<std::chrono::milliseconds>(dur).count()
-        << " ms" << std::endl;
+        << " ms, " << allocated << " allocations";
+    if (counters) {
+        std::cerr << ", " << PerfCounters::ToString(counters->Read());
+    }
+    std::cerr << std::endl;
 }
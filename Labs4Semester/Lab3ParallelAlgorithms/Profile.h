@@ -5,9 +5,96 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+\brief allocations counter getter
+
+\return number of allocations made through global operator new since program start
+\note global operator new and delete are replaced in Profile.cpp in order to count allocations
+*/
+size_t GetAllocationsCount();
+
+/**
+\brief class definition of hardware performance counters
+
+Counters are opened with perf_event_open for every thread of the process at construction,
+so work of thread pool workers is counted too, and summed on read. Threads started later are counted
+after they exit. Counters that can't be opened (not Linux, perf_event_paranoid, virtual machine) are unavailable
+*/
+class PerfCounters {
+public:
+    enum Event {
+        Cycles,
+        Instructions,
+        L1Misses,
+        LlcMisses,
+        BranchMisses,
+        ContextSwitches,
+        EventsCount
+    };
+
+    using Values = std::array<std::optional<uint64_t>, EventsCount>;
+
+    /**
+    \brief PerfCounters ctor
+
+    \note opens and starts counters
+    */
+    PerfCounters();
+
+    /**
+    \brief PerfCounters dtor
+
+    \note closes counters
+    */
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+    \brief reads counters
+
+    \return values since construction summed across threads, scaled if counters were multiplexed,
+    nullopt for unavailable counters
+    */
+    Values Read() const;
+
+    /**
+    \brief event name getter
+
+    \param event event index
+    \return name of event used in reports
+    */
+    static std::string GetEventName(size_t event);
+
+    /**
+    \brief instructions per cycle
+
+    \param values counters values
+    \return instructions per cycle, nullopt if cycles or instructions are unavailable
+    */
+    static std::optional<double> GetIpc(const Values& values);
+
+    /**
+    \brief formats counters values
+
+    \param values counters values
+    \return comma separated values with IPC, n/a for unavailable counters
+    */
+    static std::string ToString(const Values& values);
+private:
+    std::array<std::vector<int>, EventsCount> descriptors;
+};
 
 /**
 \brief class definition of profile
@@ -18,18 +105,21 @@ public:
     \brief LogDuration ctor
 
     \param msg message after duration calculated
+    \param counters true to log hardware counters of scope too
     */
-    explicit LogDuration(const std::string& msg = "");
+    explicit LogDuration(const std::string& msg = "", bool counters = false);
 
     /**
     \brief Visualizer dtor
 
-    \note message will be shown here
+    \note message will be shown here with number of allocations made in scope and counters if they are enabled
     */
     ~LogDuration();
 private:
     std::string message;
+    std::unique_ptr<PerfCounters> counters;
     std::chrono::steady_clock::time_point start;
+    size_t allocations;
 };
 
 #define UNIQ_ID_IMPL(lineno) _a_local_var_##lineno
@@ -37,3 +127,6 @@ private:
 
 #define LOG_DURATION(message) \
   LogDuration UNIQ_ID(__LINE__){message};
+
+#define LOG_COUNTERS(message) \
+  LogDuration UNIQ_ID(__LINE__){message, true};
@@ -5,329 +5,2526 @@
 
 #pragma once
 
-#include <future>
 #include <thread>
 #include <random>
 #include <vector>
 #include <list>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <tuple>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <memory>
+#include <functional>
+
+#include "ThreadPool.h"
+#include "SortingNetwork.h"
+#include "SortingTuning.h"
+
+/**
+\brief projection that returns its argument, default projection of sortings
+*/
+struct Identity {
+    template<typename T>
+    constexpr T&& operator()(T&& value) const noexcept {
+        return std::forward<T>(value);
+    }
+};
+
+/**
+\brief strict weak order of elements by comparator of their projections
+*/
+template<typename Compare, typename Projection>
+class ProjectedLess {
+public:
+    /**
+    \brief ProjectedLess ctor
+
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    ProjectedLess(Compare compare, Projection projection)
+        : compare(std::move(compare))
+        , projection(std::move(projection)) {}
+
+    template<typename Left, typename Right>
+    bool operator()(const Left& left, const Right& right) const {
+        return std::invoke(compare, std::invoke(projection, left), std::invoke(projection, right));
+    }
+private:
+    Compare compare;
+    Projection projection;
+};
+
+/**
+\brief order sortings compare elements with
+
+Natural order (std::less and Identity) is std::less<>, so LeafSort can use SortingNetwork for it.
+Comparator and projection are template parameters, so their calls are inlined
+*/
+template<typename ValueType, typename Compare, typename Projection>
+using LessOf = std::conditional_t<(std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<ValueType>>)
+                                  && std::is_same_v<Projection, Identity>, std::less<>, ProjectedLess<Compare, Projection>>;
+
+/**
+\brief makes order sortings compare elements with
+
+\param compare comparator of projections
+\param projection function that returns projection of element
+\return order of elements
+*/
+template<typename ValueType, typename Compare, typename Projection>
+LessOf<ValueType, Compare, Projection> MakeLess(Compare compare, Projection projection) {
+    if constexpr (std::is_same_v<LessOf<ValueType, Compare, Projection>, std::less<>>) {
+        return {};
+    }
+    else {
+        return { std::move(compare), std::move(projection) };
+    }
+}
+
+/**
+\brief makes scratch buffer sortings move elements of range into
+
+\param begin first element of range
+\param size number of elements of buffer, not greater than size of range
+\return buffer of value-initialized elements if they are default constructible, otherwise buffer of elements
+move-constructed from range and moved back, so range keeps its values and buffer holds moved-from elements
+*/
+template<typename Iterator>
+std::vector<typename std::iterator_traits<Iterator>::value_type> MakeScratchBuffer(Iterator begin, size_t size) {
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+    if constexpr (std::is_default_constructible_v<ValueType>) {
+        return std::vector<ValueType>(size);
+    }
+    else {
+        std::vector<ValueType> buffer(std::make_move_iterator(begin), std::make_move_iterator(begin + size));
+        std::move(buffer.begin(), buffer.end(), begin);
+        return buffer;
+    }
+}
+
+/**
+\brief class that implements quicksort sequence and parallel algorithms
+
+Pattern-robust introsort: pivot is median of 3 or ninther, partition is branchless (BlockQuicksort),
+after too many bad partitions range is sorted by heapsort, so sorting is O(n log n) on every input.
+Runs of elements equal to pivot of parent range are detected and skipped
+
+\tparam Compare comparator of projections of elements, std::less by default
+\tparam Projection function that returns projection of element, Identity by default
+*/
+template <typename Iterator, typename Compare = std::less<>, typename Projection = Identity>
+class QuickSort {
+public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    /**
+    \brief class that implements partition for quicksort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pivot pivot element
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \return position of pivot, elements before it are less than pivot, elements after it are not less
+    */
+    static Iterator Partition(Iterator begin, Iterator end, Iterator pivot,
+                              Compare compare = Compare(), Projection projection = Projection()) {
+        std::iter_swap(begin, pivot);
+        return PartitionRight(begin, end, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements sequence quicksort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note ranges not greater than LeafSort::GetMaxSize() are sorted by LeafSort
+    */
+    static void Sort(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        SortLoop(begin, end, Log2(end - begin), true, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel quicksort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note ranges not greater than SortingTuning grain are sorted sequentially
+    */
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        pool.Execute([begin, end, &pool, &less]() {SortParallelTask(begin, end, Log2(end - begin), true, pool, less); });
+    }
+
+    /**
+    \brief enables or disables parallel partition of large ranges in SortParallel
+
+    \param enabled true to partition ranges greater than parallelPartitionGrain by all workers
+    */
+    static void SetParallelPartition(bool enabled) {
+        parallelPartition.store(enabled, std::memory_order_relaxed);
+    }
+
+    /**
+    \brief checks if parallel partition is enabled
+
+    \return true if SortParallel partitions large ranges by all workers
+    */
+    static bool IsParallelPartitionEnabled() {
+        return parallelPartition.load(std::memory_order_relaxed);
+    }
+
+    /**
+    \brief class that implements sequence selection algorithm
+
+    \param begin first element of range
+    \param nth position of selected element
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note after call *nth is element that would be there in sorted range, elements before it are not greater,
+    elements after it are not less. Introselect on quicksort partition: O(n) on average, O(n log n) in the worst case
+    */
+    static void NthElement(Iterator begin, Iterator nth, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        if (nth < end) {
+            SelectLoop(begin, nth, end, MakeLess<ValueType>(compare, projection), nullptr);
+        }
+    }
+
+    /**
+    \brief class that implements parallel selection algorithm
+
+    \param begin first element of range
+    \param nth position of selected element
+    \param end next after last element of range
+    \param pool thread pool selection runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note ranges greater than parallelPartitionGrain are partitioned by all workers
+    */
+    static void NthElementParallel(Iterator begin, Iterator nth, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                                   Compare compare = Compare(), Projection projection = Projection()) {
+        if (nth < end) {
+            Less less = MakeLess<ValueType>(compare, projection);
+            pool.Execute([begin, nth, end, &pool, &less]() {SelectLoop(begin, nth, end, less, &pool); });
+        }
+    }
+
+    /**
+    \brief class that implements sequence partial sort algorithm
+
+    \param begin first element of range
+    \param middle next after last element that must be sorted
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note after call [begin, middle) are the smallest elements of range in sorted order, O(n + k log k) on average
+    */
+    static void PartialSort(Iterator begin, Iterator middle, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        if (begin < middle) {
+            Less less = MakeLess<ValueType>(compare, projection);
+            SelectLoop(begin, middle - 1, end, less, nullptr);
+            SortLoop(begin, middle - 1, Log2(middle - begin), true, less);
+        }
+    }
+
+    /**
+    \brief class that implements parallel partial sort algorithm
+
+    \param begin first element of range
+    \param middle next after last element that must be sorted
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    static void PartialSortParallel(Iterator begin, Iterator middle, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                                    Compare compare = Compare(), Projection projection = Projection()) {
+        if (begin < middle) {
+            Less less = MakeLess<ValueType>(compare, projection);
+            pool.Execute([begin, middle, end, &pool, &less]() {
+                SelectLoop(begin, middle - 1, end, less, &pool);
+                SortParallelTask(begin, middle - 1, Log2(middle - begin), true, pool, less);
+            });
+        }
+    }
+
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    static constexpr ptrdiff_t nintherThreshold = 128;
+    static constexpr size_t blockSize = 64;
+    static constexpr ptrdiff_t parallelPartitionGrain = 1 << 18;
+    static constexpr size_t parallelPartitionBlockSize = 4096;
+    inline static std::atomic<bool> parallelPartition{ true };
+
+    static int Log2(ptrdiff_t size) {
+        int log = 0;
+        while (size > 1) {
+            size >>= 1;
+            log++;
+        }
+        return log;
+    }
+
+    /**
+    \brief sorts three elements
+
+    \note after call *first <= *second <= *third
+    */
+    static void Sort3(Iterator first, Iterator second, Iterator third, const Less& less) {
+        if (less(*second, *first)) {
+            std::iter_swap(first, second);
+        }
+        if (less(*third, *second)) {
+            std::iter_swap(second, third);
+            if (less(*second, *first)) {
+                std::iter_swap(first, second);
+            }
+        }
+    }
+
+    /**
+    \brief moves pivot to begin: median of 3 for small ranges, ninther (median of medians) for large ones
+
+    \param begin first element of range
+    \param end next after last element of range
+    \note range must have at least 3 elements
+    */
+    static void ChoosePivot(Iterator begin, Iterator end, const Less& less) {
+        ptrdiff_t size = end - begin, half = size / 2;
+        if (size > nintherThreshold) {
+            Sort3(begin, begin + half, end - 1, less);
+            Sort3(begin + 1, begin + (half - 1), end - 2, less);
+            Sort3(begin + 2, begin + (half + 1), end - 3, less);
+            Sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+            std::iter_swap(begin, begin + half);
+        }
+        else {
+            Sort3(begin + half, begin, end - 1, less);
+        }
+    }
+
+    /**
+    \brief branchless partition by pivot in *begin
+
+    \param begin first element of range, pivot
+    \param end next after last element of range
+    \return position of pivot, elements before it are less than pivot, elements after it are not less
+
+    Elements that are on wrong side are found in blocks: comparisons only write offsets in buffer
+    and advance counter without branches, then found elements are swapped in pairs
+    */
+    static Iterator PartitionRight(Iterator begin, Iterator end, const Less& less) {
+        ValueType pivot = std::move(*begin);
+        Iterator first = begin, last = end;
+        while (++first < end && less(*first, pivot));
+        if (first - 1 == begin) {
+            while (first < last && !less(*--last, pivot));
+        }
+        else {
+            while (!less(*--last, pivot));
+        }
+        if (first < last) {
+            std::iter_swap(first, last);
+            first++;
+            unsigned char offsetsLeft[blockSize], offsetsRight[blockSize];
+            Iterator baseLeft = first, baseRight = last;
+            size_t countLeft = 0, countRight = 0, startLeft = 0, startRight = 0;
+            while (first < last) {
+                size_t unknown = last - first;
+                size_t leftSplit = countLeft == 0 ? (countRight == 0 ? unknown / 2 : unknown) : 0;
+                size_t rightSplit = countRight == 0 ? unknown - leftSplit : 0;
+                for (size_t i = 0, limit = std::min(leftSplit, blockSize); i < limit; i++) {
+                    offsetsLeft[countLeft] = static_cast<unsigned char>(i);
+                    countLeft += !less(*first, pivot);
+                    first++;
+                }
+                for (size_t i = 0, limit = std::min(rightSplit, blockSize); i < limit;) {
+                    offsetsRight[countRight] = static_cast<unsigned char>(++i);
+                    countRight += less(*--last, pivot);
+                }
+                size_t count = std::min(countLeft, countRight);
+                for (size_t i = 0; i < count; i++) {
+                    std::iter_swap(baseLeft + offsetsLeft[startLeft + i], baseRight - offsetsRight[startRight + i]);
+                }
+                countLeft -= count;
+                countRight -= count;
+                startLeft += count;
+                startRight += count;
+                if (countLeft == 0) {
+                    startLeft = 0;
+                    baseLeft = first;
+                }
+                if (countRight == 0) {
+                    startRight = 0;
+                    baseRight = last;
+                }
+            }
+            if (countLeft) {
+                while (countLeft--) {
+                    std::iter_swap(baseLeft + offsetsLeft[startLeft + countLeft], --last);
+                }
+                first = last;
+            }
+            if (countRight) {
+                while (countRight--) {
+                    std::iter_swap(baseRight - offsetsRight[startRight + countRight], first);
+                    first++;
+                }
+            }
+        }
+        Iterator pivotPosition = first - 1;
+        *begin = std::move(*pivotPosition);
+        *pivotPosition = std::move(pivot);
+        return pivotPosition;
+    }
+
+    /**
+    \brief partition by pivot in *begin that puts elements equal to pivot to the left
+
+    \param begin first element of range, pivot
+    \param end next after last element of range
+    \return position of pivot, elements before it are not greater than pivot, elements after it are greater
+    \note used when no element of range is less than pivot, so [begin, pivot position] are equal elements
+    */
+    static Iterator PartitionLeft(Iterator begin, Iterator end, const Less& less) {
+        ValueType pivot = std::move(*begin);
+        Iterator first = begin, last = end;
+        while (less(pivot, *--last));
+        if (last + 1 == end) {
+            while (first < last && !less(pivot, *++first));
+        }
+        else {
+            while (!less(pivot, *++first));
+        }
+        while (first < last) {
+            std::iter_swap(first, last);
+            while (less(pivot, *--last));
+            while (!less(pivot, *++first));
+        }
+        *begin = std::move(*last);
+        *last = std::move(pivot);
+        return last;
+    }
+
+    /**
+    \brief parallel partition by pivot in *begin
+
+    \param begin first element of range, pivot
+    \param end next after last element of range
+    \param pool thread pool partition runs on
+    \return position of pivot, elements before it are less than pivot, elements after it are not less
+
+    Every worker claims blocks from both ends of range with atomic counters and swaps elements between
+    its left and right block until one of them is finished, then claims next block from that side.
+    Blocks left unfinished are gathered next to unclaimed middle, which is partitioned sequentially
+    */
+    static Iterator PartitionParallel(Iterator begin, Iterator end, ThreadPool& pool, const Less& less) {
+        const ValueType& pivot = *begin;
+        Iterator first = begin + 1;
+        size_t size = end - first, blocksCount = size / parallelPartitionBlockSize;
+        auto leftBlock = [first](size_t index) { return first + index * parallelPartitionBlockSize; };
+        auto rightBlock = [first, size](size_t index) { return first + (size - (index + 1) * parallelPartitionBlockSize); };
+        std::atomic<size_t> claimed{ 0 }, leftClaimed{ 0 }, rightClaimed{ 0 };
+        std::vector<char> leftUnfinished(blocksCount, 0), rightUnfinished(blocksCount, 0);
+        auto claim = [&claimed, blocksCount](std::atomic<size_t>& side, size_t& index) {
+            if (claimed.fetch_add(1) >= blocksCount) {
+                return false;
+            }
+            index = side.fetch_add(1);
+            return true;
+        };
+        ParallelFor(pool, pool.GetWorkersCount(), [&](size_t) {
+            size_t leftIndex = 0, rightIndex = 0, leftPosition = 0, rightPosition = 0;
+            bool hasLeft = claim(leftClaimed, leftIndex);
+            bool hasRight = hasLeft && claim(rightClaimed, rightIndex);
+            while (hasLeft && hasRight) {
+                Iterator left = leftBlock(leftIndex), right = rightBlock(rightIndex);
+                while (true) {
+                    while (leftPosition < parallelPartitionBlockSize && less(*(left + leftPosition), pivot)) {
+                        leftPosition++;
+                    }
+                    while (rightPosition < parallelPartitionBlockSize && !less(*(right + rightPosition), pivot)) {
+                        rightPosition++;
+                    }
+                    if (leftPosition == parallelPartitionBlockSize || rightPosition == parallelPartitionBlockSize) {
+                        break;
+                    }
+                    std::iter_swap(left + leftPosition++, right + rightPosition++);
+                }
+                if (leftPosition == parallelPartitionBlockSize) {
+                    hasLeft = claim(leftClaimed, leftIndex);
+                    leftPosition = 0;
+                }
+                if (rightPosition == parallelPartitionBlockSize) {
+                    hasRight = claim(rightClaimed, rightIndex);
+                    rightPosition = 0;
+                }
+            }
+            if (hasLeft) {
+                leftUnfinished[leftIndex] = 1;
+            }
+            if (hasRight) {
+                rightUnfinished[rightIndex] = 1;
+            }
+        });
+        size_t leftDone = GatherUnfinished(leftUnfinished, leftClaimed, leftBlock);
+        size_t rightDone = GatherUnfinished(rightUnfinished, rightClaimed, rightBlock);
+        Iterator split = std::partition(leftBlock(leftDone), first + (size - rightDone * parallelPartitionBlockSize),
+            [&pivot, &less](const ValueType& value) { return less(value, pivot); });
+        Iterator pivotPosition = split - 1;
+        std::iter_swap(begin, pivotPosition);
+        return pivotPosition;
+    }
+
+    /**
+    \brief moves unfinished blocks of one side of parallel partition next to the middle of range
+
+    \param unfinished flags of unfinished blocks
+    \param count number of claimed blocks
+    \param block function that returns first element of block by its index
+    \return number of finished blocks, they get indexes [0, return value)
+    */
+    template<typename Block>
+    static size_t GatherUnfinished(std::vector<char>& unfinished, size_t count, Block block) {
+        size_t done = count - std::count(unfinished.begin(), unfinished.begin() + count, 1);
+        for (size_t i = 0, j = done; i < done; i++) {
+            if (unfinished[i]) {
+                while (unfinished[j]) {
+                    j++;
+                }
+                std::swap_ranges(block(i), block(i) + parallelPartitionBlockSize, block(j));
+                j++;
+            }
+        }
+        return done;
+    }
+
+    /**
+    \brief heapsort for ranges with too many bad partitions
+    */
+    static void HeapSort(Iterator begin, Iterator end, const Less& less) {
+        std::make_heap(begin, end, less);
+        std::sort_heap(begin, end, less);
+    }
+
+    /**
+    \brief partitions range and checks it
+
+    \param begin first element of range, becomes first element after equal elements
+    \param end next after last element of range
+    \param badAllowed number of bad partitions allowed, decremented on bad partition
+    \param leftmost true if there is no element before range
+    \param less order of elements
+    \param pool thread pool for parallel partition of large ranges, sequence partition if nullptr
+    \return position of pivot or end if range was consumed: equal elements were skipped
+    or range was sorted by heapsort
+    */
+    static Iterator PartitionStep(Iterator& begin, Iterator end, int& badAllowed, bool leftmost, const Less& less,
+                                  ThreadPool* pool = nullptr) {
+        ptrdiff_t size = end - begin;
+        ChoosePivot(begin, end, less);
+        if (!leftmost && !less(*(begin - 1), *begin)) {
+            begin = PartitionLeft(begin, end, less) + 1;
+            return end;
+        }
+        bool parallel = pool && pool->GetWorkersCount() > 1 && size > parallelPartitionGrain && IsParallelPartitionEnabled();
+        Iterator pivot = parallel ? PartitionParallel(begin, end, *pool, less) : PartitionRight(begin, end, less);
+        ptrdiff_t leftSize = pivot - begin, rightSize = end - (pivot + 1);
+        if ((leftSize < size / 8 || rightSize < size / 8) && --badAllowed <= 0) {
+            HeapSort(begin, end, less);
+            begin = end;
+            return end;
+        }
+        return pivot;
+    }
+
+    /**
+    \brief partitions range until nth element is pivot or it is in range sorted by leaf sort
+
+    \param begin first element of range
+    \param nth position of selected element, must be in range
+    \param end next after last element of range
+    \param less order of elements
+    \param pool thread pool for parallel partition of large ranges, sequence partition if nullptr
+    */
+    static void SelectLoop(Iterator begin, Iterator nth, Iterator end, const Less& less, ThreadPool* pool) {
+        int badAllowed = Log2(end - begin);
+        bool leftmost = true;
+        while (static_cast<size_t>(end - begin) > std::max<size_t>(LeafSort::GetMaxSize(), 3)) {
+            Iterator pivot = PartitionStep(begin, end, badAllowed, leftmost, less, pool);
+            if (pivot == end) {
+                if (nth < begin) {
+                    return;
+                }
+                continue;
+            }
+            if (nth == pivot) {
+                return;
+            }
+            if (nth < pivot) {
+                end = pivot;
+            }
+            else {
+                begin = pivot + 1;
+                leftmost = false;
+            }
+        }
+        LeafSort::Sort(begin, end, less);
+    }
+
+    static void SortLoop(Iterator begin, Iterator end, int badAllowed, bool leftmost, const Less& less) {
+        while (static_cast<size_t>(end - begin) > std::max<size_t>(LeafSort::GetMaxSize(), 3)) {
+            Iterator pivot = PartitionStep(begin, end, badAllowed, leftmost, less);
+            if (pivot == end) {
+                continue;
+            }
+            if (pivot - begin < end - pivot) {
+                SortLoop(begin, pivot, badAllowed, leftmost, less);
+                begin = pivot + 1;
+                leftmost = false;
+            }
+            else {
+                SortLoop(pivot + 1, end, badAllowed, false, less);
+                end = pivot;
+            }
+        }
+        LeafSort::Sort(begin, end, less);
+    }
+
+    static void SortParallelTask(Iterator begin, Iterator end, int badAllowed, bool leftmost, ThreadPool& pool, const Less& less) {
+        TaskGroup group(pool);
+        while (end - begin > SortingTuning::GetGrain<ValueType>(SortingTuning::QuickSortGrain)) {
+            Iterator pivot = PartitionStep(begin, end, badAllowed, leftmost, less, &pool);
+            if (pivot == end) {
+                continue;
+            }
+            group.Run([begin, pivot, badAllowed, leftmost, &pool, &less]() {
+                SortParallelTask(begin, pivot, badAllowed, leftmost, pool, less);
+            });
+            begin = pivot + 1;
+            leftmost = false;
+        }
+        SortLoop(begin, end, badAllowed, leftmost, less);
+        group.Wait();
+    }
+};
+
+/**
+\brief class that implements mergesort sequence and parallel algorithms (in place available)
+
+Sorting is stable, leaves are sorted by LeafSort::StableSort.
+Elements must be move constructible and move assignable, scratch buffers are made by MakeScratchBuffer,
+so default constructor is not required
+
+\tparam Compare comparator of projections of elements, std::less by default
+\tparam Projection function that returns projection of element, Identity by default
+*/
+template <typename Iterator, typename Compare = std::less<>, typename Projection = Identity>
+class MergeSort {
+public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    /**
+    \brief class that implements sequence mergesort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note scratch buffer is allocated once for the whole sorting
+    */
+    static void Sort(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        std::vector<ValueType> buffer = MakeScratchBuffer(begin, end - begin);
+        SortWithBuffer(begin, end, buffer.begin(), MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements sequence mergesort algorithm with caller-supplied scratch buffer
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param buffer first element of scratch buffer with at least end - begin elements
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note levels of recursion merge alternately from range to buffer and back, so there are no allocations
+    */
+    template<typename BufferIterator>
+    static void Sort(Iterator begin, Iterator end, BufferIterator buffer, Compare compare = Compare(), Projection projection = Projection()) {
+        SortWithBuffer(begin, end, buffer, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel mergesort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note scratch buffer is allocated once for the whole sorting
+    */
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        std::vector<ValueType> buffer = MakeScratchBuffer(begin, end - begin);
+        SortParallel(begin, end, buffer.begin(), pool, compare, projection);
+    }
+
+    /**
+    \brief class that implements parallel mergesort algorithm with caller-supplied scratch buffer
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param buffer first element of scratch buffer with at least end - begin elements
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note ranges not greater than SortingTuning grain are sorted sequentially
+    */
+    template<typename BufferIterator>
+    static void SortParallel(Iterator begin, Iterator end, BufferIterator buffer, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        pool.Execute([begin, end, buffer, &pool, &less]() {SortParallelTask(begin, end, buffer, pool, less); });
+    }
+
+    /**
+    \brief class that implements merge for mergesort algorithm
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note halves that are already in order are detected without allocation, otherwise range is moved
+    in scratch buffer allocated by every call, so repeated merges should supply buffer
+    */
+    static void Merge(Iterator begin, Iterator middle, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        if (begin == middle || middle == end || !less(*middle, *(middle - 1))) {
+            return;
+        }
+        std::vector<ValueType> buffer(std::make_move_iterator(begin), std::make_move_iterator(end));
+        auto bufferMiddle = buffer.begin() + (middle - begin);
+        MergeRanges(buffer.begin(), bufferMiddle, bufferMiddle, buffer.end(), begin, less);
+    }
+
+    /**
+    \brief class that implements merge for mergesort algorithm with caller-supplied scratch buffer
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param buffer first element of scratch buffer with at least end - begin elements
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    template<typename BufferIterator>
+    static void Merge(Iterator begin, Iterator middle, Iterator end, BufferIterator buffer,
+                      Compare compare = Compare(), Projection projection = Projection()) {
+        BufferIterator bufferMiddle = std::move(begin, middle, buffer);
+        BufferIterator bufferEnd = std::move(middle, end, bufferMiddle);
+        MergeRanges(buffer, bufferMiddle, bufferMiddle, bufferEnd, begin, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel merge for mergesort algorithm
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param pool thread pool merge runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note output is split in equal slices, bounds of slices in both halves are found by binary search (merge path),
+    slices are merged concurrently. Ranges smaller than SortingTuning::MergeGrain are merged sequentially.
+    Like Merge, allocates scratch buffer only for halves that are not in order
+    */
+    static void MergeParallel(Iterator begin, Iterator middle, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                              Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        if (begin == middle || middle == end || !less(*middle, *(middle - 1))) {
+            return;
+        }
+        std::vector<ValueType> buffer(std::make_move_iterator(begin), std::make_move_iterator(end));
+        auto bufferMiddle = buffer.begin() + (middle - begin);
+        pool.Execute([&]() {MergeRangesParallel(buffer.begin(), bufferMiddle, bufferMiddle, buffer.end(), begin, pool, less); });
+    }
+
+    /**
+    \brief class that implements parallel merge for mergesort algorithm with caller-supplied scratch buffer
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param buffer first element of scratch buffer with at least end - begin elements
+    \param pool thread pool merge runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    template<typename BufferIterator>
+    static void MergeParallel(Iterator begin, Iterator middle, Iterator end, BufferIterator buffer, ThreadPool& pool = ThreadPool::GetDefault(),
+                              Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        BufferIterator bufferMiddle = std::move(begin, middle, buffer);
+        BufferIterator bufferEnd = std::move(middle, end, bufferMiddle);
+        pool.Execute([&]() {MergeRangesParallel(buffer, bufferMiddle, bufferMiddle, bufferEnd, begin, pool, less); });
+    }
+
+    /**
+    \brief finds how many elements of left range are among first k elements of their stable merge
+
+    \param k number of elements in merged prefix
+    \param left first element of left sorted range
+    \param leftSize size of left range
+    \param right first element of right sorted range
+    \param rightSize size of right range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \return number of elements from left range, k minus it elements are from right range
+    */
+    template<typename InputIterator>
+    static size_t CoRank(size_t k, InputIterator left, size_t leftSize, InputIterator right, size_t rightSize,
+                         Compare compare = Compare(), Projection projection = Projection()) {
+        return FindCoRank(k, left, leftSize, right, rightSize, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements sequence mergesort algorithm in place
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note stable, O(1) additional memory, O(n log^2 n) time
+    */
+    static void SortInPlace(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        SortRangeInPlace(begin, end, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel mergesort algorithm in place
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    static void SortParallelInPlace(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                                    Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        pool.Execute([begin, end, &pool, &less]() {SortParallelInPlaceTask(begin, end, pool, less); });
+    }
+
+    /**
+    \brief class that implements merge for mergesort algorithm in place
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note stable rotation-based SymMerge: O(1) additional memory, O(n log n) time
+    */
+    static void MergeInPlace(Iterator begin, Iterator middle, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        MergeRangesInPlace(begin, middle, end, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel merge for mergesort algorithm in place
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param pool thread pool merge runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note two halves left after SymMerge rotation are merged concurrently
+    */
+    static void MergeInPlaceParallel(Iterator begin, Iterator middle, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                                     Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        pool.Execute([begin, middle, end, &pool, &less]() {MergeInPlaceParallelTask(begin, middle, end, pool, less); });
+    }
+
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    template<typename InputIterator>
+    static size_t FindCoRank(size_t k, InputIterator left, size_t leftSize, InputIterator right, size_t rightSize, const Less& less) {
+        size_t low = k > rightSize ? k - rightSize : 0;
+        size_t high = std::min(k, leftSize);
+        while (low < high) {
+            size_t i = low + (high - low) / 2;
+            size_t j = k - i;
+            if (j > 0 && !less(*(right + (j - 1)), *(left + i))) {
+                low = i + 1;
+            }
+            else {
+                high = i;
+            }
+        }
+        return low;
+    }
+
+    static void SortRangeInPlace(Iterator begin, Iterator end, const Less& less) {
+        if (static_cast<size_t>(end - begin) <= LeafSort::GetMaxSize()) {
+            LeafSort::StableSort(begin, end, less);
+        }
+        else {
+            Iterator middle = begin + (end - begin) / 2;
+            SortRangeInPlace(begin, middle, less);
+            SortRangeInPlace(middle, end, less);
+            MergeRangesInPlace(begin, middle, end, less);
+        }
+    }
+
+    static void MergeRangesInPlace(Iterator begin, Iterator middle, Iterator end, const Less& less) {
+        if (begin == middle || middle == end) {
+            return;
+        }
+        if (middle - begin == 1) {
+            std::rotate(begin, middle, std::lower_bound(middle, end, *begin, less));
+        }
+        else if (end - middle == 1) {
+            std::rotate(std::upper_bound(begin, middle, *middle, less), middle, end);
+        }
+        else {
+            auto [leftMiddle, center, rightMiddle] = SymMergeSplit(begin, middle, end, less);
+            MergeRangesInPlace(begin, leftMiddle, center, less);
+            MergeRangesInPlace(center, rightMiddle, end, less);
+        }
+    }
+
+    /**
+    \brief splits in place merge in two independent merges
+
+    \param begin first element of range
+    \param middle middle element of range
+    \param end next after last element of range
+    \param less order of elements
+    \return {m1, center, m2}: after rotation it is enough to merge [begin, m1) with [m1, center)
+    and [center, m2) with [m2, end)
+    */
+    static std::tuple<Iterator, Iterator, Iterator> SymMergeSplit(Iterator begin, Iterator middle, Iterator end, const Less& less) {
+        size_t size = end - begin, leftSize = middle - begin;
+        size_t half = size / 2, sum = half + leftSize;
+        size_t low = leftSize > half ? sum - size : 0;
+        size_t high = leftSize > half ? half : leftSize;
+        while (low < high) {
+            size_t current = low + (high - low) / 2;
+            if (!less(*(begin + (sum - 1 - current)), *(begin + current))) {
+                low = current + 1;
+            }
+            else {
+                high = current;
+            }
+        }
+        Iterator leftMiddle = begin + low, rightMiddle = begin + (sum - low);
+        if (leftMiddle < middle && middle < rightMiddle) {
+            std::rotate(leftMiddle, middle, rightMiddle);
+        }
+        return { leftMiddle, begin + half, rightMiddle };
+    }
+
+    static void MergeInPlaceParallelTask(Iterator begin, Iterator middle, Iterator end, ThreadPool& pool, const Less& less) {
+        if (end - begin <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeGrain) || begin == middle || middle == end) {
+            MergeRangesInPlace(begin, middle, end, less);
+        }
+        else {
+            auto [leftMiddle, center, rightMiddle] = SymMergeSplit(begin, middle, end, less);
+            TaskGroup group(pool);
+            group.Run([begin, leftMiddle, center, &pool, &less]() {MergeInPlaceParallelTask(begin, leftMiddle, center, pool, less); });
+            MergeInPlaceParallelTask(center, rightMiddle, end, pool, less);
+            group.Wait();
+        }
+    }
+
+    template<typename BufferIterator>
+    static void SortWithBuffer(Iterator begin, Iterator end, BufferIterator buffer, const Less& less) {
+        if (static_cast<size_t>(end - begin) <= LeafSort::GetMaxSize()) {
+            LeafSort::StableSort(begin, end, less);
+        }
+        else {
+            Iterator middle = begin + (end - begin) / 2;
+            BufferIterator bufferMiddle = buffer + (middle - begin);
+            SortToBuffer(begin, middle, buffer, less);
+            SortToBuffer(middle, end, bufferMiddle, less);
+            MergeRanges(buffer, bufferMiddle, bufferMiddle, buffer + (end - begin), begin, less);
+        }
+    }
+
+    /**
+    \brief sorts range and moves result in buffer
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param buffer first element of buffer sorted elements are moved in
+    \param less order of elements
+    \note range is used as scratch space
+    */
+    template<typename BufferIterator>
+    static void SortToBuffer(Iterator begin, Iterator end, BufferIterator buffer, const Less& less) {
+        if (static_cast<size_t>(end - begin) <= LeafSort::GetMaxSize()) {
+            LeafSort::StableSort(begin, end, less);
+            std::move(begin, end, buffer);
+        }
+        else {
+            Iterator middle = begin + (end - begin) / 2;
+            BufferIterator bufferMiddle = buffer + (middle - begin);
+            SortWithBuffer(begin, middle, buffer, less);
+            SortWithBuffer(middle, end, bufferMiddle, less);
+            MergeRanges(begin, middle, middle, end, buffer, less);
+        }
+    }
+
+    /**
+    \brief merges two sorted ranges into output, elements of left range go first among equal ones
+
+    \param left first element of left range
+    \param leftEnd next after last element of left range
+    \param right first element of right range
+    \param rightEnd next after last element of right range
+    \param current first element of output range
+    \param less order of elements
+    */
+    template<typename InputIterator, typename OutputIterator>
+    static void MergeRanges(InputIterator left, InputIterator leftEnd, InputIterator right, InputIterator rightEnd,
+                            OutputIterator current, const Less& less) {
+        while (left < leftEnd && right < rightEnd) {
+            if (less(*right, *left)) {
+                *current = std::move(*right);
+                right++;
+            }
+            else {
+                *current = std::move(*left);
+                left++;
+            }
+            current++;
+        }
+        for (; left < leftEnd; left++, current++) {
+            *current = std::move(*left);
+        }
+        for (; right < rightEnd; right++, current++) {
+            *current = std::move(*right);
+        }
+    }
+
+    /**
+    \brief merges two sorted ranges into output concurrently by slices of output
+
+    \param left first element of left range
+    \param leftEnd next after last element of left range
+    \param right first element of right range
+    \param rightEnd next after last element of right range
+    \param current first element of output range
+    \param pool thread pool merge runs on
+    \param less order of elements
+    \note must be called from worker of pool
+    */
+    template<typename InputIterator, typename OutputIterator>
+    static void MergeRangesParallel(InputIterator left, InputIterator leftEnd, InputIterator right, InputIterator rightEnd,
+                                    OutputIterator current, ThreadPool& pool, const Less& less) {
+        size_t leftSize = leftEnd - left, rightSize = rightEnd - right;
+        size_t size = leftSize + rightSize;
+        size_t slicesCount = std::min(pool.GetWorkersCount(), size / SortingTuning::GetGrain<ValueType>(SortingTuning::MergeGrain));
+        if (slicesCount < 2) {
+            MergeRanges(left, leftEnd, right, rightEnd, current, less);
+            return;
+        }
+        TaskGroup group(pool);
+        for (size_t slice = 0; slice < slicesCount; slice++) {
+            group.Run([=, &less]() {
+                size_t first = size * slice / slicesCount, last = size * (slice + 1) / slicesCount;
+                size_t i1 = FindCoRank(first, left, leftSize, right, rightSize, less);
+                size_t i2 = FindCoRank(last, left, leftSize, right, rightSize, less);
+                MergeRanges(left + i1, left + i2, right + (first - i1), right + (last - i2), current + first, less);
+            });
+        }
+        group.Wait();
+    }
+
+    template<typename BufferIterator>
+    static void SortParallelTask(Iterator begin, Iterator end, BufferIterator buffer, ThreadPool& pool, const Less& less) {
+        if (end - begin <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeSortGrain)) {
+            SortWithBuffer(begin, end, buffer, less);
+        }
+        else {
+            Iterator middle = begin + (end - begin) / 2;
+            BufferIterator bufferMiddle = buffer + (middle - begin);
+            TaskGroup group(pool);
+            group.Run([begin, middle, buffer, &pool, &less]() {SortParallelToBufferTask(begin, middle, buffer, pool, less); });
+            SortParallelToBufferTask(middle, end, bufferMiddle, pool, less);
+            group.Wait();
+            MergeRangesParallel(buffer, bufferMiddle, bufferMiddle, buffer + (end - begin), begin, pool, less);
+        }
+    }
+
+    template<typename BufferIterator>
+    static void SortParallelToBufferTask(Iterator begin, Iterator end, BufferIterator buffer, ThreadPool& pool, const Less& less) {
+        if (end - begin <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeSortGrain)) {
+            SortToBuffer(begin, end, buffer, less);
+        }
+        else {
+            Iterator middle = begin + (end - begin) / 2;
+            BufferIterator bufferMiddle = buffer + (middle - begin);
+            TaskGroup group(pool);
+            group.Run([begin, middle, buffer, &pool, &less]() {SortParallelTask(begin, middle, buffer, pool, less); });
+            SortParallelTask(middle, end, bufferMiddle, pool, less);
+            group.Wait();
+            MergeRangesParallel(begin, middle, middle, end, buffer, pool, less);
+        }
+    }
+
+    static void SortParallelInPlaceTask(Iterator begin, Iterator end, ThreadPool& pool, const Less& less) {
+        if (end - begin <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeSortGrain)) {
+            SortRangeInPlace(begin, end, less);
+        }
+        else {
+            Iterator middle = begin + (end - begin) / 2;
+            TaskGroup group(pool);
+            group.Run([begin, middle, &pool, &less]() {SortParallelInPlaceTask(begin, middle, pool, less); });
+            SortParallelInPlaceTask(middle, end, pool, less);
+            group.Wait();
+            MergeInPlaceParallelTask(begin, middle, end, pool, less);
+        }
+    }
+};
+
+/**
+\brief class that implements adaptive natural mergesort sequence and parallel algorithms
+
+Range is split in natural runs: non-descending runs are kept, strictly descending runs are reversed,
+runs shorter than minimal run are extended by insertion sort. Runs are merged in powersort order
+(run stack with node powers), so merges are nearly optimal for given run lengths.
+Merge skips prefix of left run and suffix of right run that are in place and switches to galloping
+when one run wins many times in a row, so sorted and almost sorted ranges are sorted in about O(n).
+Sorting is stable
+
+\tparam Compare comparator of projections of elements, std::less by default
+\tparam Projection function that returns projection of element, Identity by default
+*/
+template <typename Iterator, typename Compare = std::less<>, typename Projection = Identity>
+class NaturalMergeSort {
+public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    /**
+    \brief class that implements sequence natural mergesort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    static void Sort(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        size_t size = end - begin;
+        std::vector<size_t> bounds{ 0 };
+        FindRuns(begin, 0, size, GetMinRun(size), bounds, less);
+        if (bounds.size() > 2) {
+            std::vector<ValueType> buffer = MakeScratchBuffer(begin, size / 2);
+            MergeRuns(begin, bounds, 0, bounds.size() - 1, buffer.begin(), less);
+        }
+    }
+
+    /**
+    \brief class that implements parallel natural mergesort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note every worker finds runs of own chunk, runs of adjacent chunks are joined if they are in order,
+    then runs are merged by balanced tree of tasks:
+    halves of runs are merged concurrently, large merges are done by MergeSort::MergeParallel
+    */
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        size_t size = end - begin;
+        size_t chunksCount = pool.GetWorkersCount();
+        if (static_cast<ptrdiff_t>(size) <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeSortGrain) || chunksCount == 1) {
+            Sort(begin, end, compare, projection);
+            return;
+        }
+        Less less = MakeLess<ValueType>(compare, projection);
+        size_t minRun = GetMinRun(size / chunksCount);
+        std::vector<std::vector<size_t>> chunkBounds(chunksCount);
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            FindRuns(begin, size * chunk / chunksCount, size * (chunk + 1) / chunksCount, minRun, chunkBounds[chunk], less);
+        });
+        std::vector<size_t> bounds{ 0 };
+        for (const auto& runs : chunkBounds) {
+            if (bounds.size() > 1 && !less(*(begin + bounds.back()), *(begin + bounds.back() - 1))) {
+                bounds.pop_back();
+            }
+            bounds.insert(bounds.end(), runs.begin(), runs.end());
+        }
+        if (bounds.size() > 2) {
+            std::vector<ValueType> buffer = MakeScratchBuffer(begin, size);
+            pool.Execute([&]() {MergeRunsTask(begin, bounds, 0, bounds.size() - 1, buffer.begin(), pool, less); });
+        }
+    }
+
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    static constexpr size_t initialMinGallop = 7;
+
+    /**
+    \brief minimal run length getter
+
+    \param size number of elements
+    \return length from 32 to 64, size divided by it is close to power of two, so merges are balanced
+    */
+    static size_t GetMinRun(size_t size) {
+        size_t remainder = 0;
+        while (size >= 64) {
+            remainder |= size & 1;
+            size >>= 1;
+        }
+        return size + remainder;
+    }
+
+    /**
+    \brief finds runs of part of range, makes them non-descending
+
+    \param begin first element of range
+    \param first index of first element of part
+    \param last index of next after last element of part
+    \param minRun minimal run length, shorter runs are extended by insertion sort
+    \param bounds ends of runs are appended to it
+    \param less order of elements
+    */
+    static void FindRuns(Iterator begin, size_t first, size_t last, size_t minRun, std::vector<size_t>& bounds, const Less& less) {
+        while (first < last) {
+            Iterator runBegin = begin + first, runEnd = runBegin + 1, partEnd = begin + last;
+            if (runEnd < partEnd && less(*runEnd, *runBegin)) {
+                while (++runEnd < partEnd && less(*runEnd, *(runEnd - 1)));
+                std::reverse(runBegin, runEnd);
+            }
+            else {
+                while (runEnd < partEnd && !less(*runEnd, *(runEnd - 1))) {
+                    runEnd++;
+                }
+            }
+            if (static_cast<size_t>(runEnd - runBegin) < minRun) {
+                runEnd = runBegin + std::min(minRun, last - first);
+                LeafSort::InsertionSort(runBegin, runEnd, less);
+            }
+            first = runEnd - begin;
+            bounds.push_back(first);
+        }
+    }
+
+    /**
+    \brief power of boundary between two adjacent runs in powersort
+
+    \param first index of first element of left run
+    \param leftSize size of left run
+    \param rightSize size of right run
+    \param size number of elements of range
+    \return depth of boundary in perfectly balanced merge tree
+    */
+    static int GetPower(size_t first, size_t leftSize, size_t rightSize, size_t size) {
+        size_t a = 2 * first + leftSize, b = a + leftSize + rightSize;
+        int power = 0;
+        while (true) {
+            power++;
+            if (a >= size) {
+                a -= size;
+                b -= size;
+            }
+            else if (b >= size) {
+                break;
+            }
+            a <<= 1;
+            b <<= 1;
+        }
+        return power;
+    }
+
+    /**
+    \brief merges runs in powersort order
+
+    \param begin first element of range
+    \param bounds bounds of runs: run i is [begin + bounds[i], begin + bounds[i + 1])
+    \param first index of first merged run
+    \param last index of next after last merged run
+    \param buffer scratch buffer with at least half of elements of merged runs
+    \param less order of elements
+    */
+    template<typename BufferIterator>
+    static void MergeRuns(Iterator begin, const std::vector<size_t>& bounds, size_t first, size_t last, BufferIterator buffer,
+                          const Less& less) {
+        struct Run {
+            size_t begin;
+            size_t end;
+            int power;
+        };
+        size_t offset = bounds[first], size = bounds[last] - offset;
+        size_t minGallop = initialMinGallop;
+        std::vector<Run> stack;
+        auto mergeTop = [&]() {
+            Run right = stack.back();
+            stack.pop_back();
+            Run& left = stack.back();
+            MergeAdjacent(begin + left.begin, begin + right.begin, begin + right.end, buffer, less, minGallop);
+            left.end = right.end;
+        };
+        for (size_t run = first; run < last; run++) {
+            Run current{ bounds[run], bounds[run + 1], 0 };
+            if (!stack.empty()) {
+                const Run& top = stack.back();
+                current.power = GetPower(top.begin - offset, top.end - top.begin, current.end - current.begin, size);
+                while (stack.size() > 1 && stack.back().power > current.power) {
+                    mergeTop();
+                }
+            }
+            stack.push_back(current);
+        }
+        while (stack.size() > 1) {
+            mergeTop();
+        }
+    }
+
+    /**
+    \brief merges runs by balanced tree of tasks
+
+    \param begin first element of range
+    \param bounds bounds of runs: run i is [begin + bounds[i], begin + bounds[i + 1])
+    \param first index of first merged run
+    \param last index of next after last merged run
+    \param buffer scratch buffer, element begin + i uses buffer + i
+    \param pool thread pool merges run on
+    \param less order of elements
+    */
+    template<typename BufferIterator>
+    static void MergeRunsTask(Iterator begin, const std::vector<size_t>& bounds, size_t first, size_t last, BufferIterator buffer,
+                              ThreadPool& pool, const Less& less) {
+        if (last - first < 2) {
+            return;
+        }
+        if (static_cast<ptrdiff_t>(bounds[last] - bounds[first]) <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeSortGrain)) {
+            MergeRuns(begin, bounds, first, last, buffer + bounds[first], less);
+            return;
+        }
+        size_t middleOffset = bounds[first] + (bounds[last] - bounds[first]) / 2;
+        size_t middle = std::upper_bound(bounds.begin() + first + 1, bounds.begin() + last - 1, middleOffset) - bounds.begin();
+        if (middle - 1 > first && middleOffset - bounds[middle - 1] < bounds[middle] - middleOffset) {
+            middle--;
+        }
+        TaskGroup group(pool);
+        group.Run([begin, &bounds, first, middle, buffer, &pool, &less]() {
+            MergeRunsTask(begin, bounds, first, middle, buffer, pool, less);
+        });
+        MergeRunsTask(begin, bounds, middle, last, buffer, pool, less);
+        group.Wait();
+
+        Iterator left = begin + bounds[first], right = begin + bounds[middle], rightEnd = begin + bounds[last];
+        left = GallopFirst(left, right, [&](const ValueType& value) { return less(*right, value); });
+        rightEnd = GallopLast(right, rightEnd, [&](const ValueType& value) { return less(value, *(right - 1)); });
+        if (left == right || right == rightEnd) {
+            return;
+        }
+        if (static_cast<ptrdiff_t>(rightEnd - left) > SortingTuning::GetGrain<ValueType>(SortingTuning::MergeGrain)) {
+            MergeSort<Iterator, Less>::MergeParallel(left, right, rightEnd, buffer + (left - begin), pool, less);
+        }
+        else {
+            size_t minGallop = initialMinGallop;
+            MergeAdjacent(left, right, rightEnd, buffer + (left - begin), less, minGallop);
+        }
+    }
+
+    /**
+    \brief finds first element of sorted range that is after given one, exponential search from the beginning
+
+    \param first first element of range
+    \param last next after last element of range
+    \param isAfter predicate that is false for some prefix of range and true for the rest
+    \return first element that satisfies predicate or last
+    */
+    template<typename RandomIterator, typename Predicate>
+    static RandomIterator GallopFirst(RandomIterator first, RandomIterator last, Predicate isAfter) {
+        ptrdiff_t size = last - first, low = 0, high = 1;
+        while (high <= size && !isAfter(*(first + (high - 1)))) {
+            low = high;
+            high = 2 * high + 1;
+        }
+        high = std::min(high, size);
+        return std::partition_point(first + low, first + high, [&isAfter](const ValueType& value) { return !isAfter(value); });
+    }
+
+    /**
+    \brief finds first element of sorted range that is not before given one, exponential search from the end
+
+    \param first first element of range
+    \param last next after last element of range
+    \param isBefore predicate that is true for some prefix of range and false for the rest
+    \return first element that doesn't satisfy predicate or last
+    */
+    template<typename RandomIterator, typename Predicate>
+    static RandomIterator GallopLast(RandomIterator first, RandomIterator last, Predicate isBefore) {
+        ptrdiff_t size = last - first, low = 0, high = 1;
+        while (high <= size && !isBefore(*(last - high))) {
+            low = high;
+            high = 2 * high + 1;
+        }
+        high = std::min(high, size);
+        return std::partition_point(last - high, last - low, isBefore);
+    }
+
+    /**
+    \brief merges two adjacent sorted runs
+
+    \param begin first element of left run
+    \param middle first element of right run
+    \param end next after last element of right run
+    \param buffer scratch buffer with at least min(middle - begin, end - middle) elements
+    \param less order of elements
+    \param minGallop number of wins in a row that switches merge to galloping, adapted during merges
+    \note elements of left run that are not greater than first element of right run and elements of right run
+    that are not less than last element of left run are already in place, they are skipped by galloping
+    */
+    template<typename BufferIterator>
+    static void MergeAdjacent(Iterator begin, Iterator middle, Iterator end, BufferIterator buffer, const Less& less, size_t& minGallop) {
+        begin = GallopFirst(begin, middle, [&](const ValueType& value) { return less(*middle, value); });
+        if (begin == middle) {
+            return;
+        }
+        end = GallopLast(middle, end, [&](const ValueType& value) { return less(value, *(middle - 1)); });
+        if (middle == end) {
+            return;
+        }
+        if (middle - begin <= end - middle) {
+            BufferIterator bufferEnd = std::move(begin, middle, buffer);
+            MergeLow(buffer, bufferEnd, middle, end, begin, less, minGallop);
+        }
+        else {
+            BufferIterator bufferEnd = std::move(middle, end, buffer);
+            MergeHigh(begin, middle, buffer, bufferEnd, end, less, minGallop);
+        }
+    }
+
+    /**
+    \brief merges from the beginning, left run is in buffer
+
+    \param left first element of left run in buffer
+    \param leftEnd next after last element of left run in buffer
+    \param right first element of right run
+    \param rightEnd next after last element of right run
+    \param current first element of output, left run was there
+    \param less order of elements
+    \param minGallop number of wins in a row that switches merge to galloping
+    */
+    template<typename BufferIterator>
+    static void MergeLow(BufferIterator left, BufferIterator leftEnd, Iterator right, Iterator rightEnd, Iterator current,
+                         const Less& less, size_t& minGallop) {
+        while (left != leftEnd && right != rightEnd) {
+            size_t leftWins = 0, rightWins = 0;
+            while (left != leftEnd && right != rightEnd && std::max(leftWins, rightWins) < minGallop) {
+                if (less(*right, *left)) {
+                    *current++ = std::move(*right++);
+                    rightWins++;
+                    leftWins = 0;
+                }
+                else {
+                    *current++ = std::move(*left++);
+                    leftWins++;
+                    rightWins = 0;
+                }
+            }
+            while (left != leftEnd && right != rightEnd) {
+                BufferIterator leftStop = GallopFirst(left, leftEnd, [&](const ValueType& value) { return less(*right, value); });
+                size_t leftCount = leftStop - left;
+                current = std::move(left, leftStop, current);
+                left = leftStop;
+                if (left == leftEnd) {
+                    break;
+                }
+                Iterator rightStop = GallopFirst(right, rightEnd, [&](const ValueType& value) { return !less(value, *left); });
+                size_t rightCount = rightStop - right;
+                current = std::move(right, rightStop, current);
+                right = rightStop;
+                if (leftCount < initialMinGallop && rightCount < initialMinGallop) {
+                    minGallop++;
+                    break;
+                }
+                minGallop = std::max<size_t>(minGallop - 1, 1);
+            }
+        }
+        std::move(left, leftEnd, current);
+    }
+
+    /**
+    \brief merges from the end, right run is in buffer
+
+    \param left first element of left run
+    \param leftEnd next after last element of left run
+    \param right first element of right run in buffer
+    \param rightEnd next after last element of right run in buffer
+    \param currentEnd next after last element of output, right run was before it
+    \param less order of elements
+    \param minGallop number of wins in a row that switches merge to galloping
+    */
+    template<typename BufferIterator>
+    static void MergeHigh(Iterator left, Iterator leftEnd, BufferIterator right, BufferIterator rightEnd, Iterator currentEnd,
+                          const Less& less, size_t& minGallop) {
+        while (left != leftEnd && right != rightEnd) {
+            size_t leftWins = 0, rightWins = 0;
+            while (left != leftEnd && right != rightEnd && std::max(leftWins, rightWins) < minGallop) {
+                if (less(*(rightEnd - 1), *(leftEnd - 1))) {
+                    *--currentEnd = std::move(*--leftEnd);
+                    leftWins++;
+                    rightWins = 0;
+                }
+                else {
+                    *--currentEnd = std::move(*--rightEnd);
+                    rightWins++;
+                    leftWins = 0;
+                }
+            }
+            while (left != leftEnd && right != rightEnd) {
+                BufferIterator rightStart = GallopLast(right, rightEnd, [&](const ValueType& value) { return less(value, *(leftEnd - 1)); });
+                size_t rightCount = rightEnd - rightStart;
+                currentEnd = std::move_backward(rightStart, rightEnd, currentEnd);
+                rightEnd = rightStart;
+                if (right == rightEnd) {
+                    break;
+                }
+                Iterator leftStart = GallopLast(left, leftEnd, [&](const ValueType& value) { return !less(*(rightEnd - 1), value); });
+                size_t leftCount = leftEnd - leftStart;
+                currentEnd = std::move_backward(leftStart, leftEnd, currentEnd);
+                leftEnd = leftStart;
+                if (leftCount < initialMinGallop && rightCount < initialMinGallop) {
+                    minGallop++;
+                    break;
+                }
+                minGallop = std::max<size_t>(minGallop - 1, 1);
+            }
+        }
+        std::move_backward(right, rightEnd, currentEnd);
+    }
+};
+
+/**
+\brief class that implements parallel multiway mergesort algorithm
+
+Range is split in one chunk per worker and chunks are sorted concurrently by sequence mergesort.
+Then exact splitters of output are found by multisequence selection: every worker gets equal slice of output
+and parts of all chunks that form it, and merges them by loser tree in one pass.
+Binary merge tree of MergeSort::SortParallel moves every element log2(workers) times after chunks are sorted,
+multiway merge moves it twice (to buffer and back), so it needs less memory bandwidth on large ranges.
+Sorting is stable
+
+\tparam Compare comparator of projections of elements, std::less by default
+\tparam Projection function that returns projection of element, Identity by default
+*/
+template <typename Iterator, typename Compare = std::less<>, typename Projection = Identity>
+class MultiwayMergeSort {
+public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    /**
+    \brief class that implements parallel multiway mergesort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        std::vector<ValueType> buffer = MakeScratchBuffer(begin, end - begin);
+        SortParallel(begin, end, buffer.begin(), pool, compare, projection);
+    }
+
+    /**
+    \brief class that implements parallel multiway mergesort algorithm with caller-supplied scratch buffer
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param buffer first element of scratch buffer with at least end - begin elements
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note number of merged chunks is number of workers of pool, small ranges are sorted by sequence mergesort
+    */
+    template<typename BufferIterator>
+    static void SortParallel(Iterator begin, Iterator end, BufferIterator buffer, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        size_t size = end - begin;
+        size_t waysCount = pool.GetWorkersCount();
+        if (static_cast<ptrdiff_t>(size) <= SortingTuning::GetGrain<ValueType>(SortingTuning::MergeSortGrain) || waysCount == 1) {
+            MergeSort<Iterator, Less>::Sort(begin, end, buffer, less);
+            return;
+        }
+        std::vector<size_t> chunkBounds(waysCount + 1);
+        for (size_t way = 0; way <= waysCount; way++) {
+            chunkBounds[way] = size * way / waysCount;
+        }
+        ParallelFor(pool, waysCount, [&](size_t way) {
+            Iterator chunkBegin = begin + chunkBounds[way], chunkEnd = begin + chunkBounds[way + 1];
+            MergeSort<Iterator, Less>::Sort(chunkBegin, chunkEnd, buffer + chunkBounds[way], less);
+            std::move(chunkBegin, chunkEnd, buffer + chunkBounds[way]);
+        });
+
+        std::vector<std::vector<size_t>> splits(waysCount + 1);
+        ParallelFor(pool, waysCount + 1, [&](size_t slice) {
+            splits[slice] = SelectSplit(buffer, chunkBounds, size * slice / waysCount, less);
+        });
+        ParallelFor(pool, waysCount, [&](size_t slice) {
+            std::vector<std::pair<BufferIterator, BufferIterator>> sequences;
+            sequences.reserve(waysCount);
+            for (size_t way = 0; way < waysCount; way++) {
+                sequences.emplace_back(buffer + splits[slice][way], buffer + splits[slice + 1][way]);
+            }
+            MergeSequences(sequences, begin + size * slice / waysCount, less);
+        });
+    }
+
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    /**
+    \brief finds number of elements before given one in stable merge of sorted chunks
+
+    \param buffer first element of chunks
+    \param chunkBounds bounds of chunks: chunk i is [buffer + chunkBounds[i], buffer + chunkBounds[i + 1])
+    \param way chunk of element
+    \param position index of element
+    \param less order of elements
+    \return rank of element: equal elements of previous chunks are before it, of next chunks are after it
+    */
+    template<typename BufferIterator>
+    static size_t GetRank(BufferIterator buffer, const std::vector<size_t>& chunkBounds, size_t way, size_t position, const Less& less) {
+        const ValueType& value = *(buffer + position);
+        size_t rank = position - chunkBounds[way];
+        for (size_t other = 0; other + 1 < chunkBounds.size(); other++) {
+            BufferIterator first = buffer + chunkBounds[other], last = buffer + chunkBounds[other + 1];
+            if (other < way) {
+                rank += std::upper_bound(first, last, value, less) - first;
+            }
+            else if (other > way) {
+                rank += std::lower_bound(first, last, value, less) - first;
+            }
+        }
+        return rank;
+    }
+
+    /**
+    \brief multisequence selection: splits sorted chunks by rank
+
+    \param buffer first element of chunks
+    \param chunkBounds bounds of chunks: chunk i is [buffer + chunkBounds[i], buffer + chunkBounds[i + 1])
+    \param rank number of elements before split
+    \param less order of elements
+    \return index of split of every chunk, elements before splits are exactly rank first elements of stable merge
+    \note rank of element grows along its chunk, so split of every chunk is found by binary search
+    */
+    template<typename BufferIterator>
+    static std::vector<size_t> SelectSplit(BufferIterator buffer, const std::vector<size_t>& chunkBounds, size_t rank, const Less& less) {
+        std::vector<size_t> split(chunkBounds.size() - 1);
+        for (size_t way = 0; way < split.size(); way++) {
+            size_t low = chunkBounds[way], high = chunkBounds[way + 1];
+            while (low < high) {
+                size_t middle = low + (high - low) / 2;
+                if (GetRank(buffer, chunkBounds, way, middle, less) < rank) {
+                    low = middle + 1;
+                }
+                else {
+                    high = middle;
+                }
+            }
+            split[way] = low;
+        }
+        return split;
+    }
+
+    /**
+    \brief merges sorted sequences by loser tree
+
+    \param sequences first and next after last elements of sequences
+    \param output first element of output
+    \param less order of elements
+    \note tree node keeps loser of its subtree, so next winner is found by replaying path of previous one:
+    log2(ways) comparisons per element, equal elements are taken from sequences in their order
+    */
+    template<typename BufferIterator>
+    static void MergeSequences(std::vector<std::pair<BufferIterator, BufferIterator>>& sequences, Iterator output, const Less& less) {
+        size_t waysCount = sequences.size(), leaves = 1, count = 0;
+        while (leaves < waysCount) {
+            leaves <<= 1;
+        }
+        for (const auto& sequence : sequences) {
+            count += sequence.second - sequence.first;
+        }
+        std::vector<char> isExhausted(leaves, true);
+        for (size_t way = 0; way < waysCount; way++) {
+            isExhausted[way] = sequences[way].first == sequences[way].second;
+        }
+        auto isBefore = [&sequences, &isExhausted, &less](size_t way, size_t other) {
+            if (isExhausted[way] || isExhausted[other]) {
+                return !isExhausted[way];
+            }
+            return way < other ? !less(*sequences[other].first, *sequences[way].first) : less(*sequences[way].first, *sequences[other].first);
+        };
+        std::vector<size_t> losers(leaves), winners(2 * leaves);
+        for (size_t leaf = 0; leaf < leaves; leaf++) {
+            winners[leaves + leaf] = leaf;
+        }
+        for (size_t node = leaves - 1; node > 0; node--) {
+            size_t left = winners[2 * node], right = winners[2 * node + 1];
+            bool isLeftWinner = isBefore(left, right);
+            winners[node] = isLeftWinner ? left : right;
+            losers[node] = isLeftWinner ? right : left;
+        }
+        size_t winner = winners[1];
+        for (; count > 0; count--) {
+            *output++ = std::move(*sequences[winner].first++);
+            isExhausted[winner] = sequences[winner].first == sequences[winner].second;
+            for (size_t node = (winner + leaves) / 2; node > 0; node /= 2) {
+                if (isBefore(losers[node], winner)) {
+                    std::swap(losers[node], winner);
+                }
+            }
+        }
+    }
+};
+
+/**
+\brief class that implements slowsort sequence and parallel algorithms
+
+\tparam Compare comparator of projections of elements, std::less by default
+\tparam Projection function that returns projection of element, Identity by default
+*/
+template <typename Iterator, typename Compare = std::less<>, typename Projection = Identity>
+class SlowSort {
+public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    /**
+    \brief class that implements sequence slowsort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    static void Sort(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        SortRange(begin, end, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel slowsort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        pool.Execute([begin, end, &pool, &less]() {SortParallelTask(begin, end, pool, less); });
+    }
+
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    static void SortRange(Iterator begin, Iterator end, const Less& less) {
+        if (end - begin < 2) {
+            return;
+        }
+        else {
+            size_t middle = (end - begin) / 2;
+            SortRange(begin, begin + middle, less);
+            SortRange(begin + middle, end, less);
+            end--;
+            if (less(*end, *(begin + middle - 1))) {
+                std::swap(*end, *(begin + middle - 1));
+            }
+            SortRange(begin, end, less);
+        }
+    }
+
+    static void SortParallelTask(Iterator begin, Iterator end, ThreadPool& pool, const Less& less) {
+        if (end - begin < std::max<ptrdiff_t>(2, SortingTuning::GetGrain<ValueType>(SortingTuning::SlowSortGrain))) {
+            SortRange(begin, end, less);
+        }
+        else {
+            size_t middle = (end - begin) / 2;
+            {
+                TaskGroup group(pool);
+                group.Run([begin, middle, &pool, &less]() {SortParallelTask(begin, begin + middle, pool, less); });
+                SortParallelTask(begin + middle, end, pool, less);
+                group.Wait();
+            }
+            end--;
+            if (less(*end, *(begin + middle - 1))) {
+                std::swap(*end, *(begin + middle - 1));
+            }
+            SortParallelTask(begin, end, pool, less);
+        }
+    }
+};
 
 /**
-\brief class that implements quicksort sequence and parallel algorithms
+\brief class that implements samplesort sequence and parallel algorithms
+
+Range is distributed in buckets by splitters chosen from oversampled random sample,
+elements equal to some splitter get own bucket that doesn't need sorting, then buckets are sorted independently
+
+\tparam Compare comparator of projections of elements, std::less by default
+\tparam Projection function that returns projection of element, Identity by default
 */
-template <typename Iterator>
-class QuickSort {
+template <typename Iterator, typename Compare = std::less<>, typename Projection = Identity>
+class SampleSort {
 public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
 
     /**
-    \brief class that implements partition for quicksort algorithm
+    \brief class that implements sequence samplesort algorithm
 
     \param begin first element of range
     \param end next after last element of range
-    \param pivot pivot element
+    \param compare comparator of projections
+    \param projection function that returns projection of element
     */
-    static Iterator Partition(Iterator begin, Iterator end, Iterator pivot) {
-        Iterator left = begin, right = end;
-        while (true) {
-            while (*(++left) < *begin) {
-                if (left == end - 1) break;
+    static void Sort(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        SortRange(begin, end, MakeLess<ValueType>(compare, projection));
+    }
+
+    /**
+    \brief class that implements parallel samplesort algorithm
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \note number of buckets is equal to number of workers in pool
+    */
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                             Compare compare = Compare(), Projection projection = Projection()) {
+        Less less = MakeLess<ValueType>(compare, projection);
+        pool.Execute([begin, end, &pool, &less]() {SortParallelTask(begin, end, pool, less); });
+    }
+
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    static void SortRange(Iterator begin, Iterator end, const Less& less) {
+        if (static_cast<size_t>(end - begin) < SortingTuning::Get(SortingTuning::SampleSortCutoff)) {
+            QuickSort<Iterator, Less>::Sort(begin, end, less);
+        }
+        else {
+            std::vector<size_t> bounds = Distribute(begin, end, sequenceBucketsCount, nullptr, less);
+            for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+                SortRange(begin + bounds[i], begin + bounds[i + 1], less);
             }
-            while (*begin < *(--right)) {
-                if (right == begin) break;
+        }
+    }
+
+    static void SortParallelTask(Iterator begin, Iterator end, ThreadPool& pool, const Less& less) {
+        size_t size = end - begin;
+        size_t workersCount = pool.GetWorkersCount();
+        if (end - begin < SortingTuning::GetGrain<ValueType>(SortingTuning::SampleSortGrain) || workersCount == 1) {
+            SortRange(begin, end, less);
+        }
+        else {
+            std::vector<size_t> bounds = Distribute(begin, end, workersCount, &pool, less);
+            TaskGroup group(pool);
+            for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+                Iterator bucketBegin = begin + bounds[i], bucketEnd = begin + bounds[i + 1];
+                if (bounds[i + 1] - bounds[i] > 2 * size / workersCount) {
+                    group.Run([bucketBegin, bucketEnd, &pool, &less]() {SortParallelTask(bucketBegin, bucketEnd, pool, less); });
+                }
+                else {
+                    group.Run([bucketBegin, bucketEnd, &less]() {SortRange(bucketBegin, bucketEnd, less); });
+                }
             }
-            if (left >= right) break;
-            std::swap(*left, *right);
+            group.Wait();
         }
-        std::swap(*begin, *right);
-        return right;
     }
 
     /**
-    \brief class that implements sequence quicksort algorithm
+    \brief distributes range in buckets
 
     \param begin first element of range
     \param end next after last element of range
+    \param bucketsCount number of buckets between splitters
+    \param pool thread pool for parallel classification and scatter, sequence if nullptr
+    \param less order of elements
+    \return bounds of buckets: bucket i is [begin + bounds[i], begin + bounds[i + 1]),
+    odd buckets contain elements equal to splitters
     */
-    static void Sort(Iterator begin, Iterator end) {
-        if (end - begin > 1) {
-            auto pivot = begin + rng()%(end-begin);
-            auto p = Partition(begin, end, pivot);
-            Sort(begin, p);
-            Sort(p + 1, end);
+    static std::vector<size_t> Distribute(Iterator begin, Iterator end, size_t bucketsCount, ThreadPool* pool, const Less& less) {
+        size_t size = end - begin;
+        std::vector<ValueType> splitters = ChooseSplitters(begin, end, bucketsCount, less);
+        size_t classesCount = 2 * splitters.size() + 1;
+        size_t chunksCount = pool ? pool->GetWorkersCount() : 1;
+        auto chunkBegin = [size, chunksCount](size_t chunk) { return size * chunk / chunksCount; };
+
+        std::vector<uint32_t> oracle(size);
+        std::vector<std::vector<size_t>> counts(chunksCount, std::vector<size_t>(classesCount, 0));
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++) {
+                oracle[i] = Classify(*(begin + i), splitters, less);
+                counts[chunk][oracle[i]]++;
+            }
+        });
+
+        std::vector<size_t> bounds(classesCount + 1, 0);
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < classesCount; bucket++) {
+            bounds[bucket] = offset;
+            for (size_t chunk = 0; chunk < chunksCount; chunk++) {
+                size_t count = counts[chunk][bucket];
+                counts[chunk][bucket] = offset;
+                offset += count;
+            }
         }
+        bounds[classesCount] = offset;
+
+        std::vector<ValueType> buffer(std::make_move_iterator(begin), std::make_move_iterator(end));
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++) {
+                *(begin + counts[chunk][oracle[i]]++) = std::move(buffer[i]);
+            }
+        });
+        return bounds;
     }
 
     /**
-    \brief class that implements parallel quicksort algorithm
+    \brief chooses splitters from oversampled random sample
 
     \param begin first element of range
     \param end next after last element of range
+    \param bucketsCount number of buckets between splitters
+    \param less order of elements
+    \return sorted splitters, bucketsCount - 1 elements
     */
-    static void SortParallel(Iterator begin, Iterator end) {
-        if (end - begin > 1) {
-            auto pivot = begin;
-            auto p = Partition(begin, end, pivot);
-            if (end - begin > 5000) {
-                std::future<void> f1 = std::async(std::launch::async, [begin, p]() {SortParallel(begin, p); });
-                SortParallel(p + 1, end);
-            }
-            else {
-                Sort(begin, p);
-                Sort(p + 1, end);
-            }
+    static std::vector<ValueType> ChooseSplitters(Iterator begin, Iterator end, size_t bucketsCount, const Less& less) {
+        size_t size = end - begin;
+        std::vector<ValueType> sample;
+        sample.reserve(bucketsCount * oversampling);
+        for (size_t i = 0; i < bucketsCount * oversampling; i++) {
+            sample.push_back(*(begin + rng() % size));
+        }
+        std::sort(sample.begin(), sample.end(), less);
+        std::vector<ValueType> splitters;
+        splitters.reserve(bucketsCount - 1);
+        for (size_t i = 1; i < bucketsCount; i++) {
+            splitters.push_back(sample[i * oversampling]);
         }
+        return splitters;
     }
 
-private:
-    inline static std::mt19937 rng{ std::random_device()()};
+    /**
+    \brief finds bucket of element
+
+    \param value element to classify
+    \param splitters sorted splitters
+    \param less order of elements
+    \return 2 * i + 1 if value is equal to splitter i, otherwise 2 * i where i is number of smaller splitters
+    */
+    static uint32_t Classify(const ValueType& value, const std::vector<ValueType>& splitters, const Less& less) {
+        size_t i = std::lower_bound(splitters.begin(), splitters.end(), value, less) - splitters.begin();
+        if (i < splitters.size() && !less(value, splitters[i])) {
+            return static_cast<uint32_t>(2 * i + 1);
+        }
+        return static_cast<uint32_t>(2 * i);
+    }
+
+    static constexpr size_t sequenceBucketsCount = 64;
+    static constexpr size_t oversampling = 32;
+    inline static thread_local std::mt19937 rng{ std::random_device()() };
 };
 
+
 /**
-\brief class that implements mergesort sequence and parallel algorithms (in place available)
+\brief class that implements LSD radix sort sequence and parallel algorithms
+
+Works for integral and floating point keys: signed and IEEE-754 keys are mapped to unsigned bits
+with the same order. Sorting is stable, every pass moves elements between range and buffer
+
+\tparam DigitBits bits in one digit: 8, 11 or 16
 */
-template <typename Iterator>
-class MergeSort {
+template <typename Iterator, size_t DigitBits = 8>
+class RadixSort {
+    static_assert(DigitBits == 8 || DigitBits == 11 || DigitBits == 16, "digit must have 8, 11 or 16 bits");
 public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
 
     /**
-    \brief class that implements sequence mergesort algorithm
+    \brief class that implements sequence radix sort algorithm
 
     \param begin first element of range
     \param end next after last element of range
+    \note elements must be integral or floating point
     */
     static void Sort(Iterator begin, Iterator end) {
-        if (begin < end - 1) {
-            Iterator middle = begin + (end - begin) / 2;
-            Sort(begin, middle);
-            Sort(middle, end);
-            Merge(begin, middle, end);
-        }
+        Sort(begin, end, [](const ValueType& value) { return value; });
     }
 
     /**
-    \brief class that implements parallel mergesort algorithm
+    \brief class that implements sequence radix sort algorithm by key
 
     \param begin first element of range
     \param end next after last element of range
+    \param key function that returns integral or floating point key of element
     */
-    static void SortParallel(Iterator begin, Iterator end) {
-        if (begin < end - 1) {
-            Iterator middle = begin + (end - begin) / 2;
-            if (end - begin > 5000) {
-                std::future<void> f1 = std::async(std::launch::async, [begin, middle]() {SortParallel(begin, middle); });
-                SortParallel(middle, end);
-            }
-            else {
-                Sort(begin, middle);
-                Sort(middle, end);
-            }
-            Merge(begin, middle, end);
-        }
+    template<typename KeyExtractor>
+    static void Sort(Iterator begin, Iterator end, KeyExtractor key) {
+        SortByKey(begin, end, key, nullptr);
     }
 
     /**
-    \brief class that implements merge for mergesort algorithm
+    \brief class that implements parallel radix sort algorithm
 
     \param begin first element of range
-    \param middle middle element of range
     \param end next after last element of range
+    \param pool thread pool sorting runs on, default pool by default
+    \note elements must be integral or floating point
     */
-    static void Merge(Iterator begin, Iterator middle, Iterator end) {
-        using ValueType = typename std::iterator_traits<Iterator>::value_type;
-        std::vector<ValueType> left(begin, middle);
-        std::vector<ValueType> right(middle, end);
-        Iterator i = left.begin();
-        Iterator j = right.begin();
-        Iterator current = begin;
-        while (i < left.end() && j < right.end()) {
-            if (*i < *j) {
-                *current = *i;
-                i++;
-            }
-            else {
-                *current = *j;
-                j++;
-            }
-            current++;
-        }
-        for (; i < left.end(); i++, current++) {
-            *current = *i;
-        }
-        for (; j < right.end(); j++, current++) {
-            *current = *j;
-        }
+    static void SortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault()) {
+        SortParallel(begin, end, [](const ValueType& value) { return value; }, pool);
     }
 
     /**
-    \brief class that implements sequence mergesort algorithm in place
+    \brief class that implements parallel radix sort algorithm by key
 
     \param begin first element of range
     \param end next after last element of range
+    \param key function that returns integral or floating point key of element
+    \param pool thread pool sorting runs on, default pool by default
+    \note every worker builds histogram of own chunk, offsets are found by parallel prefix sum
     */
-    static void SortInPlace(Iterator begin, Iterator end) {
-        if (begin < end - 1) {
-            Iterator middle = begin + (end - begin) / 2;
-            SortInPlace(begin, middle);
-            SortInPlace(middle, end);
-            MergeInPlace(begin, middle, end);
+    template<typename KeyExtractor>
+    static void SortParallel(Iterator begin, Iterator end, KeyExtractor key, ThreadPool& pool = ThreadPool::GetDefault()) {
+        if (end - begin < SortingTuning::GetGrain<ValueType>(SortingTuning::RadixSortGrain)) {
+            SortByKey(begin, end, key, nullptr);
+        }
+        else {
+            SortByKey(begin, end, key, &pool);
         }
     }
 
     /**
-    \brief class that implements parallel mergesort algorithm in place
+    \brief maps key to unsigned bits with the same order
 
-    \param begin first element of range
-    \param end next after last element of range
+    \param key integral or floating point key
+    \return unsigned integer of the same size
     */
-    static void SortParallelInPlace(Iterator begin, Iterator end) {
-        if (begin < end - 1) {
-            Iterator middle = begin + (end - begin) / 2;
-            if (end - begin > 5000) {
-                std::future<void> f1 = std::async(std::launch::async, [begin, middle]() {SortParallelInPlace(begin, middle); });
-                SortParallelInPlace(middle, end);
-            }
-            else {
-                SortInPlace(begin, middle);
-                SortInPlace(middle, end);
+    template<typename Key>
+    static auto ToOrderedBits(Key key) {
+        static_assert(std::is_arithmetic_v<Key> && sizeof(Key) <= 8, "key must be integral or floating point up to 8 bytes");
+        using Bits = UnsignedOfSize<sizeof(Key)>;
+        constexpr Bits sign = Bits(1) << (sizeof(Key) * 8 - 1);
+        Bits bits;
+        std::memcpy(&bits, &key, sizeof(Key));
+        if constexpr (std::is_floating_point_v<Key>) {
+            return (bits & sign) ? Bits(~bits) : Bits(bits | sign);
+        }
+        else if constexpr (std::is_signed_v<Key>) {
+            return Bits(bits ^ sign);
+        }
+        else {
+            return bits;
+        }
+    }
+
+private:
+    template<size_t Size>
+    using UnsignedOfSize = std::conditional_t<Size == 1, uint8_t,
+                           std::conditional_t<Size == 2, uint16_t,
+                           std::conditional_t<Size == 4, uint32_t, uint64_t>>>;
+
+    using Counts = std::vector<std::vector<size_t>>;
+
+    static constexpr size_t radix = size_t(1) << DigitBits;
+
+    template<typename KeyExtractor>
+    static void SortByKey(Iterator begin, Iterator end, KeyExtractor& key, ThreadPool* pool) {
+        size_t size = end - begin;
+        if (size < 2) {
+            return;
+        }
+        using Bits = decltype(ToOrderedBits(key(*begin)));
+        constexpr size_t passesCount = (sizeof(Bits) * 8 + DigitBits - 1) / DigitBits;
+        size_t chunksCount = pool ? pool->GetWorkersCount() : 1;
+        std::vector<ValueType> buffer = MakeScratchBuffer(begin, size);
+        Counts counts(chunksCount, std::vector<size_t>(radix));
+        bool inBuffer = false;
+        for (size_t pass = 0; pass < passesCount; pass++) {
+            size_t shift = pass * DigitBits;
+            auto digit = [&key, shift](const ValueType& value) {
+                return static_cast<size_t>(ToOrderedBits(key(value)) >> shift) & (radix - 1);
+            };
+            bool moved = inBuffer ? Pass(buffer.begin(), begin, size, digit, counts, pool)
+                                  : Pass(begin, buffer.begin(), size, digit, counts, pool);
+            if (moved) {
+                inBuffer = !inBuffer;
             }
-            MergeInPlace(begin, middle, end);
+        }
+        if (inBuffer) {
+            ParallelFor(pool, chunksCount, [&](size_t chunk) {
+                size_t first = size * chunk / chunksCount, last = size * (chunk + 1) / chunksCount;
+                std::move(buffer.begin() + first, buffer.begin() + last, begin + first);
+            });
         }
     }
 
     /**
-    \brief class that implements merge for mergesort algorithm in place
+    \brief stable distribution of elements by one digit
 
-    \param begin first element of range
-    \param middle middle element of range
-    \param end next after last element of range
+    \param source first element of source range
+    \param destination first element of destination range
+    \param size number of elements
+    \param digit function that returns digit of element
+    \param counts per chunk histograms, reused between passes
+    \param pool thread pool pass runs on, sequence if nullptr
+    \return false if all elements have the same digit and nothing was moved
     */
-    static void MergeInPlace(Iterator begin, Iterator middle, Iterator end) {
-        using ValueType = typename std::iterator_traits<Iterator>::value_type;
-        Iterator begin2 = middle;
-        while (begin < middle && begin2 < end) {
-            if (*begin2 < *begin) {
-                ValueType value = *begin2;
-                Iterator cur = begin2;
-                while (cur != begin) {
-                    *cur = *(cur - 1);
-                    cur--;
+    template<typename Source, typename Destination, typename Digit>
+    static bool Pass(Source source, Destination destination, size_t size, Digit& digit, Counts& counts, ThreadPool* pool) {
+        size_t chunksCount = counts.size();
+        auto chunkBegin = [size, chunksCount](size_t chunk) { return size * chunk / chunksCount; };
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            std::fill(counts[chunk].begin(), counts[chunk].end(), 0);
+            for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++) {
+                counts[chunk][digit(*(source + i))]++;
+            }
+        });
+
+        auto digitBegin = [chunksCount](size_t block) { return radix * block / chunksCount; };
+        std::vector<size_t> blockOffsets(chunksCount + 1, 0);
+        std::atomic<bool> sameDigit{ false };
+        ParallelFor(pool, chunksCount, [&](size_t block) {
+            size_t total = 0;
+            for (size_t d = digitBegin(block); d < digitBegin(block + 1); d++) {
+                size_t digitTotal = 0;
+                for (size_t chunk = 0; chunk < chunksCount; chunk++) {
+                    digitTotal += counts[chunk][d];
                 }
-                *begin = value;
-                middle++;
-                begin2++;
+                if (digitTotal == size) {
+                    sameDigit = true;
+                }
+                total += digitTotal;
             }
-            begin++;
+            blockOffsets[block + 1] = total;
+        });
+        if (sameDigit) {
+            return false;
+        }
+        for (size_t block = 0; block < chunksCount; block++) {
+            blockOffsets[block + 1] += blockOffsets[block];
         }
+        ParallelFor(pool, chunksCount, [&](size_t block) {
+            size_t offset = blockOffsets[block];
+            for (size_t d = digitBegin(block); d < digitBegin(block + 1); d++) {
+                for (size_t chunk = 0; chunk < chunksCount; chunk++) {
+                    size_t count = counts[chunk][d];
+                    counts[chunk][d] = offset;
+                    offset += count;
+                }
+            }
+        });
+
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            for (size_t i = chunkBegin(chunk); i < chunkBegin(chunk + 1); i++) {
+                *(destination + counts[chunk][digit(*(source + i))]++) = std::move(*(source + i));
+            }
+        });
+        return true;
     }
 };
 
 /**
-\brief class that implements slowsort sequence and parallel algorithms
+\brief class that implements sorting of key column with payload and argsort on top of sorting algorithm
+
+Keys are sorted together with indexes of their elements, so wide elements and payload are moved only once,
+by permutation. Results are stable if algorithm is stable (MergeSort)
+
+\tparam Algorithm QuickSort, MergeSort or SampleSort
+\tparam Compare comparator of projections of keys, std::less by default
+\tparam Projection function that returns projection of key, Identity by default
 */
-template <typename Iterator>
-class SlowSort {
+template <template<typename...> class Algorithm = QuickSort, typename Compare = std::less<>, typename Projection = Identity>
+class IndirectSort {
 public:
+    /**
+    \brief sequence argsort
+
+    \param begin first key
+    \param end next after last key
+    \param compare comparator of projections
+    \param projection function that returns projection of key
+    \return permutation: indexes of keys in sorted order
+    */
+    template<typename Iterator>
+    static std::vector<size_t> ArgSort(Iterator begin, Iterator end, Compare compare = Compare(), Projection projection = Projection()) {
+        return MakePermutation(begin, end, nullptr, compare, projection);
+    }
 
     /**
-    \brief class that implements sequence slowsort algorithm
+    \brief parallel argsort
+
+    \param begin first key
+    \param end next after last key
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of key
+    \return permutation: indexes of keys in sorted order
+    */
+    template<typename Iterator>
+    static std::vector<size_t> ArgSortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault(),
+                                               Compare compare = Compare(), Projection projection = Projection()) {
+        using Key = typename std::iterator_traits<Iterator>::value_type;
+        ptrdiff_t grain = SortingTuning::GetGrain<Entry<Key>>(SortingTuning::IndirectSortGrain);
+        return MakePermutation(begin, end, end - begin < grain ? nullptr : &pool, compare, projection);
+    }
+
+    /**
+    \brief sequence sort of key column with payload column
+
+    \param keysBegin first key
+    \param keysEnd next after last key
+    \param payloadBegin payload of first key, payload is permuted the same way as keys
+    \param compare comparator of projections
+    \param projection function that returns projection of key
+    */
+    template<typename KeyIterator, typename PayloadIterator>
+    static void SortByKey(KeyIterator keysBegin, KeyIterator keysEnd, PayloadIterator payloadBegin,
+                          Compare compare = Compare(), Projection projection = Projection()) {
+        SortWithPayload(keysBegin, keysEnd, payloadBegin, nullptr, compare, projection);
+    }
+
+    /**
+    \brief parallel sort of key column with payload column
+
+    \param keysBegin first key
+    \param keysEnd next after last key
+    \param payloadBegin payload of first key, payload is permuted the same way as keys
+    \param pool thread pool sorting runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of key
+    */
+    template<typename KeyIterator, typename PayloadIterator>
+    static void SortByKeyParallel(KeyIterator keysBegin, KeyIterator keysEnd, PayloadIterator payloadBegin,
+        ThreadPool& pool = ThreadPool::GetDefault(), Compare compare = Compare(), Projection projection = Projection()) {
+        using Key = typename std::iterator_traits<KeyIterator>::value_type;
+        ptrdiff_t grain = SortingTuning::GetGrain<Entry<Key>>(SortingTuning::IndirectSortGrain);
+        SortWithPayload(keysBegin, keysEnd, payloadBegin, keysEnd - keysBegin < grain ? nullptr : &pool, compare, projection);
+    }
+
+    /**
+    \brief sequence permutation of range
 
     \param begin first element of range
-    \param end next after last element of range
+    \param permutation indexes of elements in new order, range has permutation.size() elements
     */
-    static void Sort(Iterator begin, Iterator end) {
-        if (end - begin < 2) {
-            return;
-        }
-        else {
-            size_t middle = (end - begin) / 2;
-            Sort(begin, begin + middle);
-            Sort(begin + middle, end);
-            end--;
-            if (*end < *(begin + middle - 1)) {
-                std::swap(*end, *(begin + middle - 1));
-            }
-            Sort(begin, end);
-        }
+    template<typename Iterator>
+    static void Permute(Iterator begin, const std::vector<size_t>& permutation) {
+        Permute(begin, permutation.size(), [&permutation](size_t i) { return permutation[i]; }, nullptr);
     }
 
     /**
-    \brief class that implements parallel slowsort algorithm
+    \brief parallel permutation of range
 
     \param begin first element of range
-    \param end next after last element of range
+    \param permutation indexes of elements in new order, range has permutation.size() elements
+    \param pool thread pool permutation runs on, default pool by default
+    */
+    template<typename Iterator>
+    static void PermuteParallel(Iterator begin, const std::vector<size_t>& permutation, ThreadPool& pool = ThreadPool::GetDefault()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        ptrdiff_t grain = SortingTuning::GetGrain<ValueType>(SortingTuning::IndirectSortGrain);
+        Permute(begin, permutation.size(), [&permutation](size_t i) { return permutation[i]; },
+            static_cast<ptrdiff_t>(permutation.size()) < grain ? nullptr : &pool);
+    }
+private:
+    template<typename Key>
+    struct Entry {
+        Key key;
+        size_t index;
+    };
+
+    /**
+    \brief projection of entry: projection of its key
     */
-    static void SortParallel(Iterator begin, Iterator end) {
-        if (end - begin < 50) {
-            Sort(begin, end);
+    struct EntryProjection {
+        Projection projection;
+
+        template<typename Key>
+        decltype(auto) operator()(const Entry<Key>& entry) const {
+            return std::invoke(projection, entry.key);
         }
-        else {
-            size_t middle = (end - begin) / 2;
-            {
-                std::future<void> f1 = std::async(std::launch::async, [begin, middle]() {SortParallel(begin, begin + middle); });
-                SortParallel(begin + middle, end);
+    };
+
+    template<typename Iterator>
+    static std::vector<size_t> MakePermutation(Iterator begin, Iterator end, ThreadPool* pool, Compare& compare, Projection& projection) {
+        using Key = typename std::iterator_traits<Iterator>::value_type;
+        size_t size = end - begin;
+        std::vector<Entry<Key>> entries(size);
+        ForEachSlice<Entry<Key>>(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                entries[i] = { begin[i], i };
             }
-            end--;
-            if (*end < *(begin + middle - 1)) {
-                std::swap(*end, *(begin + middle - 1));
+        });
+        SortEntries(entries, pool, compare, projection);
+        std::vector<size_t> permutation(size);
+        ForEachSlice<Entry<Key>>(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                permutation[i] = entries[i].index;
+            }
+        });
+        return permutation;
+    }
+
+    template<typename KeyIterator, typename PayloadIterator>
+    static void SortWithPayload(KeyIterator keysBegin, KeyIterator keysEnd, PayloadIterator payloadBegin, ThreadPool* pool,
+                                Compare& compare, Projection& projection) {
+        using Key = typename std::iterator_traits<KeyIterator>::value_type;
+        size_t size = keysEnd - keysBegin;
+        std::vector<Entry<Key>> entries(size);
+        ForEachSlice<Entry<Key>>(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                entries[i] = { std::move(keysBegin[i]), i };
+            }
+        });
+        SortEntries(entries, pool, compare, projection);
+        ForEachSlice<Entry<Key>>(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                keysBegin[i] = std::move(entries[i].key);
             }
-            SortParallel(begin, end);
+        });
+        Permute(payloadBegin, size, [&entries](size_t i) { return entries[i].index; }, pool);
+    }
+
+    template<typename Key>
+    static void SortEntries(std::vector<Entry<Key>>& entries, ThreadPool* pool, Compare& compare, Projection& projection) {
+        using EntryIterator = typename std::vector<Entry<Key>>::iterator;
+        using EntrySort = Algorithm<EntryIterator, Compare, EntryProjection>;
+        if (pool) {
+            EntrySort::SortParallel(entries.begin(), entries.end(), *pool, compare, EntryProjection{ projection });
         }
+        else {
+            EntrySort::Sort(entries.begin(), entries.end(), compare, EntryProjection{ projection });
+        }
+    }
+
+    template<typename Iterator, typename Index>
+    static void Permute(Iterator begin, size_t size, Index index, ThreadPool* pool) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        std::vector<ValueType> permuted = MakeScratchBuffer(begin, size);
+        ForEachSlice<ValueType>(size, pool, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; i++) {
+                permuted[i] = std::move(begin[index(i)]);
+            }
+        });
+        ForEachSlice<ValueType>(size, pool, [&](size_t first, size_t last) {
+            std::move(permuted.begin() + first, permuted.begin() + last, begin + first);
+        });
+    }
+
+    /**
+    \brief calls function for every slice of range, at most one slice for every worker and one for every grain
+
+    \tparam ValueType type of processed elements, grain is IndirectSortGrain for it
+    \param size number of elements
+    \param pool thread pool slices are processed on, one slice if nullptr
+    \param function function that takes first and next after last index of slice
+    */
+    template<typename ValueType, typename Function>
+    static void ForEachSlice(size_t size, ThreadPool* pool, Function&& function) {
+        size_t grain = static_cast<size_t>(SortingTuning::GetGrain<ValueType>(SortingTuning::IndirectSortGrain));
+        size_t slicesCount = pool ? std::clamp<size_t>(size / grain, 1, pool->GetWorkersCount()) : 1;
+        ParallelFor(slicesCount > 1 ? pool : nullptr, slicesCount, [&](size_t slice) {
+            function(size * slice / slicesCount, size * (slice + 1) / slicesCount);
+        });
     }
 };
 
 /**
-\brief class that implements samplesort sequence and parallel algorithms
+\brief class that implements top-k selection: k smallest elements in given order
+
+Streaming variant keeps bounded heap with the greatest of kept elements on top, every pushed element
+costs O(log k) and replaces top if it is less. Selection from range is done by heaps of chunks for small k
+and by QuickSort::PartialSort of copy for large k
+
+\tparam Compare comparator of projections of elements, std::less by default (std::greater selects the greatest)
+\tparam Projection function that returns projection of element, Identity by default
 */
-template <typename Iterator>
-class SampleSort {
+template <typename ValueType, typename Compare = std::less<>, typename Projection = Identity>
+class TopK {
 public:
+    /**
+    \brief TopK ctor
+
+    \param k number of kept elements
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    */
+    explicit TopK(size_t k, Compare compare = Compare(), Projection projection = Projection())
+        : k(k)
+        , less(MakeLess<ValueType>(compare, projection)) {
+        heap.reserve(k);
+    }
 
     /**
-    \brief class that implements sequence samplesort algorithm
+    \brief pushes element in stream
+
+    \param value element
+    */
+    void Push(const ValueType& value) {
+        if (heap.size() < k) {
+            heap.push_back(value);
+            std::push_heap(heap.begin(), heap.end(), less);
+        }
+        else if (k > 0 && less(value, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), less);
+            heap.back() = value;
+            std::push_heap(heap.begin(), heap.end(), less);
+        }
+    }
+
+    /**
+    \brief pushes all elements kept by other stream
+
+    \param other stream with the same order
+    */
+    void Merge(const TopK& other) {
+        for (const auto& value : other.heap) {
+            Push(value);
+        }
+    }
+
+    /**
+    \brief size getter
+
+    \return number of kept elements, min(k, number of pushed elements)
+    */
+    size_t GetSize() const {
+        return heap.size();
+    }
+
+    /**
+    \brief extracts kept elements, stream becomes empty
+
+    \return k smallest pushed elements in sorted order
+    */
+    std::vector<ValueType> Extract() {
+        std::sort_heap(heap.begin(), heap.end(), less);
+        std::vector<ValueType> result = std::move(heap);
+        heap.clear();
+        return result;
+    }
+
+    /**
+    \brief sequence top-k selection from range
 
     \param begin first element of range
     \param end next after last element of range
+    \param k number of selected elements
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \return k smallest elements of range in sorted order, range is not changed
     */
-    static void Sort(Iterator begin, Iterator end) {
-        if (end - begin < 1000) {
-            QuickSort<Iterator>::Sort(begin, end);
+    template<typename Iterator>
+    static std::vector<ValueType> Find(Iterator begin, Iterator end, size_t k, Compare compare = Compare(), Projection projection = Projection()) {
+        size_t size = end - begin;
+        if (IsLarge(k, size)) {
+            std::vector<ValueType> copy(begin, end);
+            using CopyIterator = typename std::vector<ValueType>::iterator;
+            QuickSort<CopyIterator, Compare, Projection>::PartialSort(copy.begin(), copy.begin() + std::min(k, size), copy.end(),
+                compare, projection);
+            copy.resize(std::min(k, size));
+            return copy;
         }
-        else {
-            Iterator middle1 = begin + (end - begin) / 4;
-            Iterator middle2 = begin + (end - begin) / 2;
-            Iterator middle3 = begin + (end - begin) *3 / 4;
-            Sort(begin, middle1);
-            Sort(middle1, middle2);
-            Sort(middle2, middle3);
-            Sort(middle3, end);
-            MergeSort<Iterator>::Merge(begin, middle1, middle2);
-            MergeSort<Iterator>::Merge(middle2, middle3, end);
-            MergeSort<Iterator>::Merge(begin, middle2, end);
+        TopK topK(k, compare, projection);
+        for (Iterator current = begin; current != end; ++current) {
+            topK.Push(*current);
         }
+        return topK.Extract();
     }
 
     /**
-    \brief class that implements parallel samplewsort algorithm
+    \brief parallel top-k selection from range
 
     \param begin first element of range
     \param end next after last element of range
+    \param k number of selected elements
+    \param pool thread pool selection runs on, default pool by default
+    \param compare comparator of projections
+    \param projection function that returns projection of element
+    \return k smallest elements of range in sorted order, range is not changed
+    \note for small k every worker streams own chunk in its heap, then heaps are merged
     */
-    static void SortParallel(Iterator begin, Iterator end) {
-        if (end - begin < 5000) {
-            Sort(begin, end);
+    template<typename Iterator>
+    static std::vector<ValueType> FindParallel(Iterator begin, Iterator end, size_t k, ThreadPool& pool = ThreadPool::GetDefault(),
+                                               Compare compare = Compare(), Projection projection = Projection()) {
+        size_t size = end - begin;
+        size_t chunksCount = pool.GetWorkersCount();
+        if (static_cast<ptrdiff_t>(size) < SortingTuning::GetGrain<ValueType>(SortingTuning::QuickSortGrain) || chunksCount == 1) {
+            return Find(begin, end, k, compare, projection);
         }
-        else {
-            Iterator middle1 = begin + (end - begin) / 4;
-            Iterator middle2 = begin + (end - begin) / 2;
-            Iterator middle3 = begin + (end - begin) * 3 / 4; 
-            {
-                std::future<void> f1 = std::async(std::launch::async, [begin, middle1]() {SortParallel(begin, middle1); });
-                std::future<void> f2 = std::async(std::launch::async, [middle1, middle2]() {SortParallel(middle1, middle2); });
-                std::future<void> f3 = std::async(std::launch::async, [middle2, middle3]() {SortParallel(middle2, middle3); });
-                SortParallel(middle3, end);
+        if (IsLarge(k, size)) {
+            std::vector<ValueType> copy(size);
+            ParallelFor(pool, chunksCount, [&](size_t chunk) {
+                size_t first = size * chunk / chunksCount, last = size * (chunk + 1) / chunksCount;
+                std::copy(begin + first, begin + last, copy.begin() + first);
+            });
+            using CopyIterator = typename std::vector<ValueType>::iterator;
+            QuickSort<CopyIterator, Compare, Projection>::PartialSortParallel(copy.begin(), copy.begin() + std::min(k, size), copy.end(),
+                pool, compare, projection);
+            copy.resize(std::min(k, size));
+            return copy;
+        }
+        std::vector<TopK> chunks(chunksCount, TopK(k, compare, projection));
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            size_t first = size * chunk / chunksCount, last = size * (chunk + 1) / chunksCount;
+            for (size_t i = first; i < last; i++) {
+                chunks[chunk].Push(*(begin + i));
             }
-            MergeSort<Iterator>::Merge(begin, middle1, middle2);
-            MergeSort<Iterator>::Merge(middle2, middle3, end);
-            MergeSort<Iterator>::Merge(begin, middle2, end);
+        });
+        for (size_t chunk = 1; chunk < chunksCount; chunk++) {
+            chunks[0].Merge(chunks[chunk]);
         }
+        return chunks[0].Extract();
     }
-};
\ No newline at end of file
+private:
+    using Less = LessOf<ValueType, Compare, Projection>;
+
+    /**
+    \brief checks if selection is cheaper by partial sort of copy than by heap
+
+    \param k number of selected elements
+    \param size number of elements of range
+    \return true if k is greater than 1/16 of range
+    */
+    static bool IsLarge(size_t k, size_t size) {
+        return k > size / 16;
+    }
+
+    size_t k;
+    Less less;
+    std::vector<ValueType> heap;
+};
@@ -0,0 +1,445 @@
+/**
+\file
+\brief .h file with sorting networks for small blocks, used as leaf sort of sortings
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SORTING_NETWORK_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SORTING_NETWORK_AVX2
+#else
+#define SORTING_NETWORK_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+/**
+\brief class that implements bitonic sorting network for blocks of up to 64 numbers
+
+Block is padded with maximal value to power of two size. AVX2 kernel is chosen at runtime
+if processor supports it, scalar kernel otherwise. Supported types: int32_t, int64_t, float, double.
+Compare-exchange swaps elements only if they are strictly out of order, so elements that are equal
+but not identical (-0.0 and +0.0) are kept as they are
+*/
+class SortingNetwork {
+public:
+    static constexpr size_t maxSize = 64;   ///<maximal size of block
+
+    /**
+    \brief sorts block with best kernel available on current processor
+
+    \param data first element of block
+    \param size size of block, not greater than maxSize
+    */
+    template<typename T>
+    static void Sort(T* data, size_t size) {
+#ifdef SORTING_NETWORK_X86
+        if (HasAvx2()) {
+            SortAvx2(data, size);
+            return;
+        }
+#endif
+        SortScalar(data, size);
+    }
+
+    /**
+    \brief sorts block with scalar kernel
+
+    \param data first element of block
+    \param size size of block, not greater than maxSize
+    */
+    template<typename T>
+    static void SortScalar(T* data, size_t size) {
+        alignas(32) T block[maxSize];
+        size_t padded = Pad(data, size, block, 1);
+        for (size_t k = 2; k <= padded; k *= 2) {
+            for (size_t j = k / 2; j > 0; j /= 2) {
+                for (size_t i = 0; i < padded; i++) {
+                    size_t partner = i ^ j;
+                    bool ascending = (i & k) == 0;
+                    if (partner > i && (ascending ? block[partner] < block[i] : block[i] < block[partner])) {
+                        std::swap(block[i], block[partner]);
+                    }
+                }
+            }
+        }
+        std::copy(block, block + size, data);
+    }
+
+#ifdef SORTING_NETWORK_X86
+    /**
+    \brief sorts block with AVX2 kernel
+
+    \param data first element of block
+    \param size size of block, not greater than maxSize
+    \note processor must support AVX2
+    */
+    template<typename T>
+    SORTING_NETWORK_AVX2 static void SortAvx2(T* data, size_t size) {
+        using Ops = Avx2Ops<T>;
+        alignas(32) T block[maxSize];
+        size_t padded = Pad(data, size, block, Ops::lanes);
+        for (size_t k = 2; k <= padded; k *= 2) {
+            for (size_t j = k / 2; j > 0; j /= 2) {
+                if (j >= Ops::lanes) {
+                    for (size_t i = 0; i < padded; i += Ops::lanes) {
+                        if (i & j) {
+                            continue;
+                        }
+                        auto first = Ops::Load(block + i), second = Ops::Load(block + i + j);
+                        bool ascending = (i & k) == 0;
+                        __m256i swap = ascending ? Ops::Less(second, first) : Ops::Less(first, second);
+                        Ops::Store(block + i, Ops::Blend(first, second, swap));
+                        Ops::Store(block + i + j, Ops::Blend(second, first, swap));
+                    }
+                }
+                else {
+                    for (size_t i = 0; i < padded; i += Ops::lanes) {
+                        auto value = Ops::Load(block + i);
+                        auto partner = Ops::Exchange(value, j);
+                        __m256i swap = _mm256_blendv_epi8(Ops::Less(value, partner), Ops::Less(partner, value), Ops::TakeLowMask(i, j, k));
+                        Ops::Store(block + i, Ops::Blend(value, partner, swap));
+                    }
+                }
+            }
+        }
+        std::copy(block, block + size, data);
+    }
+#endif
+
+    /**
+    \brief checks if processor supports AVX2
+
+    \return true if AVX2 kernels can be used
+    \note checked once
+    */
+    static bool HasAvx2() {
+        static const bool hasAvx2 = DetectAvx2();
+        return hasAvx2;
+    }
+
+private:
+    /**
+    \brief copies block in aligned buffer and pads it with maximal value
+
+    \param data first element of block
+    \param size size of block
+    \param block aligned buffer with maxSize elements
+    \param lanes minimal padded size
+    \return padded size, power of two
+    */
+    template<typename T>
+    static size_t Pad(const T* data, size_t size, T* block, size_t lanes) {
+        size_t padded = lanes;
+        while (padded < size) {
+            padded *= 2;
+        }
+        std::copy(data, data + size, block);
+        T sentinel = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+        std::fill(block + size, block + padded, sentinel);
+        return padded;
+    }
+
+    static bool DetectAvx2() {
+#if defined(SORTING_NETWORK_X86) && defined(_MSC_VER) && !defined(__clang__)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 6) != 6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif defined(SORTING_NETWORK_X86)
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+#ifdef SORTING_NETWORK_X86
+    template<typename T>
+    struct Avx2Ops;
+#endif
+};
+
+#ifdef SORTING_NETWORK_X86
+/**
+\brief AVX2 operations on 8 int32_t lanes
+*/
+template<>
+struct SortingNetwork::Avx2Ops<int32_t> {
+    using Vector = __m256i;
+    static constexpr size_t lanes = 8;
+
+    SORTING_NETWORK_AVX2 static Vector Load(const int32_t* data) {
+        return _mm256_load_si256(reinterpret_cast<const __m256i*>(data));
+    }
+
+    SORTING_NETWORK_AVX2 static void Store(int32_t* data, Vector value) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(data), value);
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i Less(Vector first, Vector second) {
+        return _mm256_cmpgt_epi32(second, first);
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Exchange(Vector value, size_t distance) {
+        __m256 floats = _mm256_castsi256_ps(value);
+        if (distance == 4) {
+            return _mm256_castps_si256(_mm256_permute2f128_ps(floats, floats, 0x01));
+        }
+        if (distance == 2) {
+            return _mm256_castps_si256(_mm256_permute_ps(floats, _MM_SHUFFLE(1, 0, 3, 2)));
+        }
+        return _mm256_castps_si256(_mm256_permute_ps(floats, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Blend(Vector ifZero, Vector ifOne, __m256i mask) {
+        return _mm256_blendv_epi8(ifZero, ifOne, mask);
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i TakeLowMask(size_t base, size_t distance, size_t stage) {
+        __m256i index = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(base)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(static_cast<int>(distance))), _mm256_setzero_si256());
+        __m256i ascending = _mm256_cmpeq_epi32(_mm256_and_si256(index, _mm256_set1_epi32(static_cast<int>(stage))), _mm256_setzero_si256());
+        return _mm256_cmpeq_epi32(lower, ascending);
+    }
+};
+
+/**
+\brief AVX2 operations on 8 float lanes
+*/
+template<>
+struct SortingNetwork::Avx2Ops<float> {
+    using Vector = __m256;
+    static constexpr size_t lanes = 8;
+
+    SORTING_NETWORK_AVX2 static Vector Load(const float* data) {
+        return _mm256_load_ps(data);
+    }
+
+    SORTING_NETWORK_AVX2 static void Store(float* data, Vector value) {
+        _mm256_store_ps(data, value);
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i Less(Vector first, Vector second) {
+        return _mm256_castps_si256(_mm256_cmp_ps(first, second, _CMP_LT_OQ));
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Exchange(Vector value, size_t distance) {
+        if (distance == 4) {
+            return _mm256_permute2f128_ps(value, value, 0x01);
+        }
+        if (distance == 2) {
+            return _mm256_permute_ps(value, _MM_SHUFFLE(1, 0, 3, 2));
+        }
+        return _mm256_permute_ps(value, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Blend(Vector ifZero, Vector ifOne, __m256i mask) {
+        return _mm256_blendv_ps(ifZero, ifOne, _mm256_castsi256_ps(mask));
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i TakeLowMask(size_t base, size_t distance, size_t stage) {
+        return Avx2Ops<int32_t>::TakeLowMask(base, distance, stage);
+    }
+};
+
+/**
+\brief AVX2 operations on 4 int64_t lanes
+*/
+template<>
+struct SortingNetwork::Avx2Ops<int64_t> {
+    using Vector = __m256i;
+    static constexpr size_t lanes = 4;
+
+    SORTING_NETWORK_AVX2 static Vector Load(const int64_t* data) {
+        return _mm256_load_si256(reinterpret_cast<const __m256i*>(data));
+    }
+
+    SORTING_NETWORK_AVX2 static void Store(int64_t* data, Vector value) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(data), value);
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i Less(Vector first, Vector second) {
+        return _mm256_cmpgt_epi64(second, first);
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Exchange(Vector value, size_t distance) {
+        if (distance == 2) {
+            return _mm256_permute4x64_epi64(value, _MM_SHUFFLE(1, 0, 3, 2));
+        }
+        return _mm256_permute4x64_epi64(value, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Blend(Vector ifZero, Vector ifOne, __m256i mask) {
+        return _mm256_blendv_epi8(ifZero, ifOne, mask);
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i TakeLowMask(size_t base, size_t distance, size_t stage) {
+        __m256i index = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(base)), _mm256_setr_epi64x(0, 1, 2, 3));
+        __m256i lower = _mm256_cmpeq_epi64(_mm256_and_si256(index, _mm256_set1_epi64x(static_cast<long long>(distance))), _mm256_setzero_si256());
+        __m256i ascending = _mm256_cmpeq_epi64(_mm256_and_si256(index, _mm256_set1_epi64x(static_cast<long long>(stage))), _mm256_setzero_si256());
+        return _mm256_cmpeq_epi64(lower, ascending);
+    }
+};
+
+/**
+\brief AVX2 operations on 4 double lanes
+*/
+template<>
+struct SortingNetwork::Avx2Ops<double> {
+    using Vector = __m256d;
+    static constexpr size_t lanes = 4;
+
+    SORTING_NETWORK_AVX2 static Vector Load(const double* data) {
+        return _mm256_load_pd(data);
+    }
+
+    SORTING_NETWORK_AVX2 static void Store(double* data, Vector value) {
+        _mm256_store_pd(data, value);
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i Less(Vector first, Vector second) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(first, second, _CMP_LT_OQ));
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Exchange(Vector value, size_t distance) {
+        if (distance == 2) {
+            return _mm256_permute2f128_pd(value, value, 0x01);
+        }
+        return _mm256_permute_pd(value, 0x5);
+    }
+
+    SORTING_NETWORK_AVX2 static Vector Blend(Vector ifZero, Vector ifOne, __m256i mask) {
+        return _mm256_blendv_pd(ifZero, ifOne, _mm256_castsi256_pd(mask));
+    }
+
+    SORTING_NETWORK_AVX2 static __m256i TakeLowMask(size_t base, size_t distance, size_t stage) {
+        return Avx2Ops<int64_t>::TakeLowMask(base, distance, stage);
+    }
+};
+#endif
+
+/**
+\brief class that implements leaf sort of small ranges for all sortings
+
+Ranges of signed 32/64-bit integers, floats and doubles in natural order are sorted by SortingNetwork,
+other types and orders are sorted by stable insertion sort. StableSort is for stable sortings, it doesn't use network for floats
+*/
+class LeafSort {
+public:
+    /**
+    \brief maximal leaf size getter
+
+    \return ranges not greater than this size are sorted by leaf sort
+    */
+    static size_t GetMaxSize() {
+        return maxSize.load(std::memory_order_relaxed);
+    }
+
+    /**
+    \brief sets maximal leaf size
+
+    \param size new maximal leaf size, from 1 to SortingNetwork::maxSize
+    */
+    static void SetMaxSize(size_t size) {
+        maxSize.store(std::clamp<size_t>(size, 1, SortingNetwork::maxSize), std::memory_order_relaxed);
+    }
+
+    /**
+    \brief sorts small range
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param less strict weak order of elements, std::less by default
+    \note range must not be greater than SortingNetwork::maxSize.
+    SortingNetwork is used only for natural order, other orders are sorted by insertion sort
+    */
+    template<typename Iterator, typename Less = std::less<>>
+    static void Sort(Iterator begin, Iterator end, const Less& less = Less()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        using Key = NetworkKey<ValueType>;
+        size_t size = end - begin;
+        if (size < 2) {
+            return;
+        }
+        if constexpr (std::is_void_v<Key> || !(std::is_same_v<Less, std::less<>> || std::is_same_v<Less, std::less<ValueType>>)) {
+            InsertionSort(begin, end, less);
+        }
+        else {
+            Key block[SortingNetwork::maxSize];
+            std::transform(begin, end, block, [](const ValueType& value) { return static_cast<Key>(value); });
+            SortingNetwork::Sort(block, size);
+            std::transform(block, block + size, begin, [](Key value) { return static_cast<ValueType>(value); });
+        }
+    }
+
+    /**
+    \brief sorts small range keeping order of equal elements
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param less strict weak order of elements, std::less by default
+    \note SortingNetwork is used for integers only: equal floats can still differ (-0.0 and 0.0),
+    and network doesn't keep their order, so floats are sorted by insertion sort
+    */
+    template<typename Iterator, typename Less = std::less<>>
+    static void StableSort(Iterator begin, Iterator end, const Less& less = Less()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        if constexpr (std::is_floating_point_v<ValueType>) {
+            InsertionSort(begin, end, less);
+        }
+        else {
+            Sort(begin, end, less);
+        }
+    }
+
+    /**
+    \brief stable insertion sort
+
+    \param begin first element of range
+    \param end next after last element of range
+    \param less strict weak order of elements, std::less by default
+    */
+    template<typename Iterator, typename Less = std::less<>>
+    static void InsertionSort(Iterator begin, Iterator end, const Less& less = Less()) {
+        using ValueType = typename std::iterator_traits<Iterator>::value_type;
+        if (end - begin < 2) {
+            return;
+        }
+        for (Iterator i = begin + 1; i < end; i++) {
+            ValueType value = std::move(*i);
+            Iterator j = i;
+            for (; j > begin && less(value, *(j - 1)); j--) {
+                *j = std::move(*(j - 1));
+            }
+            *j = std::move(value);
+        }
+    }
+
+private:
+    template<typename T>
+    using NetworkKey = std::conditional_t<std::is_same_v<T, float> || std::is_same_v<T, double>, T,
+                       std::conditional_t<std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4, int32_t,
+                       std::conditional_t<std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8, int64_t, void>>>;
+
+    inline static std::atomic<size_t> maxSize{ SortingNetwork::maxSize };
+};
@@ -0,0 +1,81 @@
+/**
+\file
+\brief .cpp file with implementation of tunable thresholds of sortings
+*/
+
+#include "SortingTuning.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    const char* names[SortingTuning::ParametersCount] = { "quicksort_grain", "mergesort_grain", "merge_grain",
+        "samplesort_grain", "samplesort_cutoff", "slowsort_grain", "radixsort_grain", "indirectsort_grain", "stringsort_grain", "primitives_grain" };
+
+    /**
+    \brief loads config file at startup, errors are reported and defaults are kept
+    */
+    bool LoadAtStartup() {
+        try {
+            return SortingTuning::Load(SortingTuning::GetDefaultPath());
+        }
+        catch (const std::exception& e) {
+            SortingTuning::Reset();
+            std::cerr << "sorting tuning is not loaded: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    const bool loaded = LoadAtStartup();
+}
+
+const char* SortingTuning::GetName(Parameter parameter) {
+    return names[parameter];
+}
+
+void SortingTuning::Reset() {
+    for (size_t parameter = 0; parameter < ParametersCount; parameter++) {
+        Set(static_cast<Parameter>(parameter), defaults[parameter]);
+    }
+}
+
+bool SortingTuning::Load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        std::istringstream words(line);
+        std::string name;
+        if (!(words >> name) || name[0] == '#') {
+            continue;
+        }
+        auto parameter = std::find_if(std::begin(names), std::end(names), [&name](const char* known) { return name == known; });
+        long long value = 0;
+        if (parameter == std::end(names) || !(words >> value) || value <= 0) {
+            throw std::runtime_error("invalid line in " + path + ": " + line);
+        }
+        Set(static_cast<Parameter>(parameter - std::begin(names)), static_cast<size_t>(value));
+    }
+    return true;
+}
+
+void SortingTuning::Save(const std::string& path) {
+    std::ofstream out(path);
+    out << "# sortings tuning: parameter value" << std::endl;
+    for (size_t parameter = 0; parameter < ParametersCount; parameter++) {
+        out << names[parameter] << ' ' << Get(static_cast<Parameter>(parameter)) << std::endl;
+    }
+    if (!out) {
+        throw std::runtime_error("can't write " + path);
+    }
+}
+
+std::string SortingTuning::GetDefaultPath() {
+    const char* path = std::getenv("SORTING_TUNING");
+    return path ? path : "sorting_tuning.cfg";
+}
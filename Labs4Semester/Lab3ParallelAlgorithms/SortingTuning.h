@@ -0,0 +1,120 @@
+/**
+\file
+\brief .h file with definition of tunable thresholds of sortings
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+\brief class that holds tunable thresholds of sortings and parallel primitives: parallel grains and sequential cutoffs
+
+Defaults are replaced at startup by values from config file if it exists: path is taken from
+SORTING_TUNING environment variable, sorting_tuning.cfg in working directory by default.
+Config file is written by calibration, every line is name of parameter and its value, lines starting with # are comments
+*/
+class SortingTuning {
+public:
+    /**
+    \brief tunable parameters
+    */
+    enum Parameter {
+        QuickSortGrain,
+        MergeSortGrain,
+        MergeGrain,
+        SampleSortGrain,
+        SampleSortCutoff,
+        SlowSortGrain,
+        RadixSortGrain,
+        IndirectSortGrain,
+        StringSortGrain,
+        PrimitivesGrain,
+        ParametersCount
+    };
+
+    /**
+    \brief parameter getter
+
+    \param parameter tunable parameter
+    \return current value of parameter
+    */
+    static size_t Get(Parameter parameter) {
+        return values[parameter].load(std::memory_order_relaxed);
+    }
+
+    /**
+    \brief grain getter for type of elements
+
+    \param parameter grain parameter
+    \return number of elements parallel sorting splits ranges down to, smaller ranges are sorted sequentially
+    \note grains are tuned for elements up to 8 bytes, they are proportionally greater (up to 8 times) for wider ones:
+    moving them is bound by memory bandwidth shared by workers, so splitting small ranges of them doesn't pay for tasks
+    */
+    template<typename ValueType>
+    static ptrdiff_t GetGrain(Parameter parameter) {
+        return static_cast<ptrdiff_t>(Get(parameter)) * grainScale<ValueType>;
+    }
+
+    /**
+    \brief sets parameter
+
+    \param parameter tunable parameter
+    \param value new value, raised to minimum of parameter: 1 for grains, 2 for SlowSort grain
+    (it splits ranges in halves and merges them by last element) and 256 for SampleSort cutoff
+    (smaller ranges don't fill buckets of sequential distribution)
+    */
+    static void Set(Parameter parameter, size_t value) {
+        values[parameter].store(std::max(value, minimums[parameter]), std::memory_order_relaxed);
+    }
+
+    /**
+    \brief parameter name getter
+
+    \param parameter tunable parameter
+    \return name of parameter in config file
+    */
+    static const char* GetName(Parameter parameter);
+
+    /**
+    \brief sets all parameters to defaults
+    */
+    static void Reset();
+
+    /**
+    \brief loads parameters from config file, parameters missing in file keep their values
+
+    \param path path of config file
+    \return false if file can't be opened
+    \throw std::runtime_error if line of file is not known parameter with positive value
+    */
+    static bool Load(const std::string& path);
+
+    /**
+    \brief saves all parameters to config file
+
+    \param path path of config file
+    \throw std::runtime_error if file can't be written
+    */
+    static void Save(const std::string& path);
+
+    /**
+    \brief default config file path getter
+
+    \return value of SORTING_TUNING environment variable if it is set, otherwise sorting_tuning.cfg
+    */
+    static std::string GetDefaultPath();
+private:
+    template<typename ValueType>
+    static constexpr ptrdiff_t grainScale = std::clamp<ptrdiff_t>(sizeof(ValueType) / sizeof(uint64_t), 1, 8);
+
+    static constexpr size_t minimums[ParametersCount] = { 1, 1, 1, 1, 256, 2, 1, 1, 1, 1 };
+    static constexpr size_t defaults[ParametersCount] = { 5000, 5000, 50'000, 5000, 1000, 50, 5000, 5000, 5000, 10'000 };
+
+    inline static std::atomic<size_t> values[ParametersCount] = { defaults[0], defaults[1], defaults[2], defaults[3],
+        defaults[4], defaults[5], defaults[6], defaults[7], defaults[8], defaults[9] };
+};
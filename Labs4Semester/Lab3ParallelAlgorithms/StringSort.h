@@ -0,0 +1,603 @@
+/**
+\file
+\brief .h file with implementations of string sortings
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "Sorting.h"
+
+/**
+\brief class that implements string sortings: multikey quicksort, MSD radix sort and mergesort with LCP merge
+
+Generic sortings compare whole strings again and again, these ones look only at characters after common prefix
+of sorted group. Range is sorted as array of entries: index of string and cache of its 8 characters at current depth
+packed in big-endian number, so one comparison of entries compares 8 characters and strings are read only
+when caches are refreshed. Sorted strings are moved to their places at the end
+
+\tparam Iterator random access iterator of strings: std::string or other type with data() and size() of chars
+*/
+template <typename Iterator>
+class StringSort {
+public:
+    using ValueType = typename std::iterator_traits<Iterator>::value_type;
+
+    /**
+    \brief sequence multikey quicksort
+
+    \param begin first string of range
+    \param end next after last string of range
+    \note ternary partition by cached 8 characters, group of equal caches goes 8 characters deeper
+    */
+    static void MultikeyQuickSort(Iterator begin, Iterator end) {
+        std::vector<Entry> entries = MakeEntries(begin, end, nullptr);
+        MultikeyQuickSortTask(begin, entries.begin(), entries.end(), 0, nullptr);
+        Place(begin, entries, nullptr);
+    }
+
+    /**
+    \brief parallel multikey quicksort
+
+    \param begin first string of range
+    \param end next after last string of range
+    \param pool thread pool sorting runs on, default pool by default
+    \note parts of partition that are greater than grain are sorted concurrently
+    */
+    static void MultikeyQuickSortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault()) {
+        std::vector<Entry> entries = MakeEntries(begin, end, &pool);
+        pool.Execute([&]() {MultikeyQuickSortTask(begin, entries.begin(), entries.end(), 0, &pool); });
+        Place(begin, entries, &pool);
+    }
+
+    /**
+    \brief sequence MSD radix sort
+
+    \param begin first string of range
+    \param end next after last string of range
+    \note character of every step is taken from cache, so string is read once per 8 steps,
+    groups smaller than radixSortCutoff are sorted by multikey quicksort
+    */
+    static void RadixSort(Iterator begin, Iterator end) {
+        std::vector<Entry> entries = MakeEntries(begin, end, nullptr);
+        std::vector<Entry> buffer(entries.size());
+        RadixSortTask(begin, entries.begin(), entries.end(), buffer.begin(), 0, nullptr);
+        Place(begin, entries, nullptr);
+    }
+
+    /**
+    \brief parallel MSD radix sort
+
+    \param begin first string of range
+    \param end next after last string of range
+    \param pool thread pool sorting runs on, default pool by default
+    \note buckets that are greater than grain are sorted concurrently
+    */
+    static void RadixSortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault()) {
+        std::vector<Entry> entries = MakeEntries(begin, end, &pool);
+        std::vector<Entry> buffer(entries.size());
+        pool.Execute([&]() {RadixSortTask(begin, entries.begin(), entries.end(), buffer.begin(), 0, &pool); });
+        Place(begin, entries, &pool);
+    }
+
+    /**
+    \brief parallel mergesort with LCP merge
+
+    \param begin first string of range
+    \param end next after last string of range
+    \param pool thread pool sorting runs on, default pool by default
+    \note one chunk per worker is sorted by MSD radix sort, then chunks are merged by balanced tree of tasks,
+    merges greater than merge grain are split in parts that are merged concurrently.
+    Every sorted sequence keeps longest common prefixes (LCP) of adjacent strings, merge compares strings
+    only after their known common prefix with last output string, so every character is compared about once
+    */
+    static void MergeSortParallel(Iterator begin, Iterator end, ThreadPool& pool = ThreadPool::GetDefault()) {
+        size_t size = end - begin;
+        size_t chunksCount = pool.GetWorkersCount();
+        if (static_cast<ptrdiff_t>(size) <= SortingTuning::GetGrain<Entry>(SortingTuning::StringSortGrain) || chunksCount == 1) {
+            RadixSort(begin, end);
+            return;
+        }
+        std::vector<Entry> entries = MakeEntries(begin, end, &pool);
+        std::vector<Entry> buffer(size);
+        std::vector<size_t> lcps(size), lcpsBuffer(size);
+        std::vector<size_t> chunkBounds(chunksCount + 1);
+        for (size_t chunk = 0; chunk <= chunksCount; chunk++) {
+            chunkBounds[chunk] = size * chunk / chunksCount;
+        }
+        ParallelFor(pool, chunksCount, [&](size_t chunk) {
+            size_t first = chunkBounds[chunk], last = chunkBounds[chunk + 1];
+            RadixSortTask(begin, entries.begin() + first, entries.begin() + last, buffer.begin() + first, 0, nullptr);
+            lcps[first] = 0;
+            for (size_t i = first + 1; i < last; i++) {
+                lcps[i] = GetLcp(GetString(begin, entries[i - 1]), GetString(begin, entries[i]), 0);
+            }
+        });
+        pool.Execute([&]() {
+            MergeChunksTask(begin, chunkBounds, 0, chunksCount, entries.begin(), lcps.begin(), buffer.begin(), lcpsBuffer.begin(), pool);
+        });
+        Place(begin, entries, &pool);
+    }
+
+private:
+    /**
+    \brief sorted entry: cached characters of string and its index
+    */
+    struct Entry {
+        uint64_t cache;
+        size_t index;
+    };
+
+    using EntryIterator = typename std::vector<Entry>::iterator;
+    using LcpIterator = std::vector<size_t>::iterator;
+
+    /**
+    \brief part of partition of multikey quicksort: range of entries and length of their common prefix
+    */
+    struct Part {
+        EntryIterator first;
+        EntryIterator last;
+        size_t depth;
+    };
+
+    static constexpr size_t cacheSize = sizeof(uint64_t);
+    static constexpr ptrdiff_t insertionSortSize = 16;
+    static constexpr ptrdiff_t radixSortCutoff = 1024;
+    static constexpr size_t classesCount = 257;
+
+    static std::string_view GetString(Iterator begin, const Entry& entry) {
+        const ValueType& string = *(begin + entry.index);
+        return std::string_view(string.data(), string.size());
+    }
+
+    /**
+    \brief packs characters of string in big-endian number
+
+    \param string string
+    \param depth index of first character
+    \return 8 characters from depth, missing characters after end of string are zeros
+    */
+    static uint64_t GetCache(std::string_view string, size_t depth) {
+        uint64_t cache = 0;
+        for (size_t i = 0; i < cacheSize; i++) {
+            cache <<= 8;
+            if (depth + i < string.size()) {
+                cache |= static_cast<unsigned char>(string[depth + i]);
+            }
+        }
+        return cache;
+    }
+
+    /**
+    \brief finds longest common prefix of strings
+
+    \param left string
+    \param right string
+    \param from length of known common prefix
+    \return length of longest common prefix
+    \note strings are compared by 8 characters while they are equal
+    */
+    static size_t GetLcp(std::string_view left, std::string_view right, size_t from) {
+        size_t size = std::min(left.size(), right.size());
+        for (; from + cacheSize <= size; from += cacheSize) {
+            uint64_t leftWord, rightWord;
+            std::memcpy(&leftWord, left.data() + from, cacheSize);
+            std::memcpy(&rightWord, right.data() + from, cacheSize);
+            if (leftWord != rightWord) {
+                break;
+            }
+        }
+        while (from < size && left[from] == right[from]) {
+            from++;
+        }
+        return from;
+    }
+
+    /**
+    \brief finds common prefix of all strings of group
+
+    \param strings first string of range
+    \param begin first entry
+    \param end next after last entry
+    \param depth length of known common prefix
+    \return length of common prefix
+    */
+    static size_t GetCommonPrefix(Iterator strings, EntryIterator begin, EntryIterator end, size_t depth) {
+        std::string_view first = GetString(strings, *begin);
+        for (EntryIterator entry = begin + 1; entry < end && first.size() > depth; ++entry) {
+            first = first.substr(0, GetLcp(first, GetString(strings, *entry), depth));
+        }
+        return first.size();
+    }
+
+    static std::vector<Entry> MakeEntries(Iterator begin, Iterator end, ThreadPool* pool) {
+        size_t size = end - begin;
+        std::vector<Entry> entries(size);
+        ptrdiff_t grain = SortingTuning::GetGrain<Entry>(SortingTuning::StringSortGrain);
+        size_t chunksCount = pool && static_cast<ptrdiff_t>(size) > grain ? pool->GetWorkersCount() : 1;
+        ParallelFor(chunksCount > 1 ? pool : nullptr, chunksCount, [&](size_t chunk) {
+            for (size_t i = size * chunk / chunksCount; i < size * (chunk + 1) / chunksCount; i++) {
+                entries[i] = { GetCache(std::string_view((begin + i)->data(), (begin + i)->size()), 0), i };
+            }
+        });
+        return entries;
+    }
+
+    /**
+    \brief moves strings to their places in sorted order
+    */
+    static void Place(Iterator begin, const std::vector<Entry>& entries, ThreadPool* pool) {
+        std::vector<size_t> permutation(entries.size());
+        for (size_t i = 0; i < entries.size(); i++) {
+            permutation[i] = entries[i].index;
+        }
+        ptrdiff_t grain = SortingTuning::GetGrain<ValueType>(SortingTuning::StringSortGrain);
+        if (pool && static_cast<ptrdiff_t>(entries.size()) > grain) {
+            IndirectSort<>::PermuteParallel(begin, permutation, *pool);
+        }
+        else {
+            IndirectSort<>::Permute(begin, permutation);
+        }
+    }
+
+    static void RefreshCaches(Iterator strings, EntryIterator begin, EntryIterator end, size_t depth) {
+        for (EntryIterator entry = begin; entry != end; ++entry) {
+            entry->cache = GetCache(GetString(strings, *entry), depth);
+        }
+    }
+
+    /**
+    \brief compares strings with common prefix of given length
+
+    \param strings first string of range
+    \param left entry of string
+    \param right entry of string
+    \param depth length of common prefix, caches are characters at depth
+    \return true if left string is less than right one
+    \note equal caches with string ended inside them differ only by zero characters, so shorter string is less
+    */
+    static bool IsLess(Iterator strings, const Entry& left, const Entry& right, size_t depth) {
+        if (left.cache != right.cache) {
+            return left.cache < right.cache;
+        }
+        std::string_view leftString = GetString(strings, left), rightString = GetString(strings, right);
+        size_t offset = depth + cacheSize;
+        if (std::min(leftString.size(), rightString.size()) <= offset) {
+            return leftString.size() < rightString.size();
+        }
+        return leftString.substr(offset) < rightString.substr(offset);
+    }
+
+    static void InsertionSort(Iterator strings, EntryIterator begin, EntryIterator end, size_t depth) {
+        for (EntryIterator i = begin; i < end; ++i) {
+            Entry entry = *i;
+            EntryIterator j = i;
+            for (; j > begin && IsLess(strings, entry, *(j - 1), depth); --j) {
+                *j = *(j - 1);
+            }
+            *j = entry;
+        }
+    }
+
+    /**
+    \brief multikey quicksort of entries with common prefix
+
+    \param strings first string of range
+    \param begin first entry
+    \param end next after last entry
+    \param depth length of common prefix, caches are characters at depth
+    \param pool thread pool for parallel sorting, sequence if nullptr
+    \note loop goes on with the largest of less, equal and greater parts, other parts are not greater than half
+    of range, so recursion depth is logarithmic
+    */
+    static void MultikeyQuickSortTask(Iterator strings, EntryIterator begin, EntryIterator end, size_t depth, ThreadPool* pool) {
+        if (pool && end - begin <= SortingTuning::GetGrain<Entry>(SortingTuning::StringSortGrain)) {
+            pool = nullptr;
+        }
+        std::optional<TaskGroup> group;
+        if (pool) {
+            group.emplace(*pool);
+        }
+        auto sortPart = [strings, pool, &group](EntryIterator first, EntryIterator last, size_t partDepth) {
+            if (group && last - first > SortingTuning::GetGrain<Entry>(SortingTuning::StringSortGrain)) {
+                group->Run([strings, first, last, partDepth, pool]() { MultikeyQuickSortTask(strings, first, last, partDepth, pool); });
+            }
+            else {
+                MultikeyQuickSortTask(strings, first, last, partDepth, nullptr);
+            }
+        };
+        while (end - begin > insertionSortSize) {
+            uint64_t a = begin->cache, b = (begin + (end - begin) / 2)->cache, c = (end - 1)->cache;
+            uint64_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+            EntryIterator less = begin, current = begin, greater = end;
+            while (current < greater) {
+                if (current->cache < pivot) {
+                    std::iter_swap(less++, current++);
+                }
+                else if (current->cache > pivot) {
+                    std::iter_swap(current, --greater);
+                }
+                else {
+                    ++current;
+                }
+            }
+            bool isCommon = less == begin && greater == end;
+            EntryIterator equalBegin = less;
+            if ((pivot & 0xff) == 0) {
+                size_t offset = depth + cacheSize;
+                EntryIterator finished = std::partition(less, greater, [strings, offset](const Entry& entry) {
+                    return GetString(strings, entry).size() <= offset;
+                });
+                std::sort(less, finished, [strings](const Entry& left, const Entry& right) {
+                    return GetString(strings, left).size() < GetString(strings, right).size();
+                });
+                equalBegin = finished;
+            }
+            size_t equalDepth = depth + cacheSize;
+            if (isCommon && equalBegin != greater) {
+                equalDepth = GetCommonPrefix(strings, equalBegin, greater, equalDepth);
+            }
+            RefreshCaches(strings, equalBegin, greater, equalDepth);
+
+            Part parts[] = { { begin, less, depth }, { equalBegin, greater, equalDepth }, { greater, end, depth } };
+            Part* largest = std::max_element(std::begin(parts), std::end(parts), [](const Part& left, const Part& right) {
+                return left.last - left.first < right.last - right.first;
+            });
+            for (Part& part : parts) {
+                if (&part != largest) {
+                    sortPart(part.first, part.last, part.depth);
+                }
+            }
+            begin = largest->first;
+            end = largest->last;
+            depth = largest->depth;
+        }
+        InsertionSort(strings, begin, end, depth);
+        if (group) {
+            group->Wait();
+        }
+    }
+
+    /**
+    \brief skips characters at depth that are equal for all entries
+
+    \param begin first entry
+    \param end next after last entry
+    \param depth length of common prefix, increased by number of skipped characters
+    \return true if all characters of caches are skipped, so caches must be refreshed
+    \note zero characters are not skipped, they can be ends of strings
+    */
+    static bool SkipCommonCharacters(EntryIterator begin, EntryIterator end, size_t& depth) {
+        uint64_t difference = 0;
+        for (EntryIterator entry = begin + 1; entry < end; ++entry) {
+            difference |= entry->cache ^ begin->cache;
+        }
+        for (size_t offset = depth % cacheSize; offset < cacheSize; offset++) {
+            unsigned shift = static_cast<unsigned>(8 * (cacheSize - 1 - offset));
+            if (((difference >> shift) & 0xff) != 0 || ((begin->cache >> shift) & 0xff) == 0) {
+                return false;
+            }
+            depth++;
+        }
+        return true;
+    }
+
+    /**
+    \brief MSD radix sort of entries with common prefix
+
+    \param strings first string of range
+    \param begin first entry
+    \param end next after last entry
+    \param buffer scratch buffer with end - begin entries
+    \param depth length of common prefix, caches are characters at depth rounded down to multiple of 8
+    \param pool thread pool for parallel sorting, sequence if nullptr
+    \note class 0 is ended strings, class c + 1 is strings with character c at depth,
+    characters that are common for all entries are skipped without distribution, if they fill whole caches
+    common prefix is found by comparing strings
+    */
+    static void RadixSortTask(Iterator strings, EntryIterator begin, EntryIterator end, EntryIterator buffer, size_t depth,
+                              ThreadPool* pool) {
+        if (end - begin < radixSortCutoff) {
+            MultikeyQuickSortTask(strings, begin, end, depth - depth % cacheSize, nullptr);
+            return;
+        }
+        while (SkipCommonCharacters(begin, end, depth)) {
+            depth = GetCommonPrefix(strings, begin, end, depth);
+            RefreshCaches(strings, begin, end, depth - depth % cacheSize);
+        }
+        if (pool && end - begin <= SortingTuning::GetGrain<Entry>(SortingTuning::StringSortGrain)) {
+            pool = nullptr;
+        }
+        unsigned shift = static_cast<unsigned>(8 * (cacheSize - 1 - depth % cacheSize));
+        std::vector<uint16_t> oracle(end - begin);
+        size_t bounds[classesCount + 1] = {};
+        for (ptrdiff_t i = 0; i < end - begin; i++) {
+            const Entry& entry = *(begin + i);
+            uint16_t character = static_cast<uint16_t>((entry.cache >> shift) & 0xff);
+            oracle[i] = character ? character + 1 : (GetString(strings, entry).size() > depth ? 1 : 0);
+            bounds[oracle[i] + 1]++;
+        }
+        for (size_t bucket = 1; bucket <= classesCount; bucket++) {
+            bounds[bucket] += bounds[bucket - 1];
+        }
+        size_t positions[classesCount];
+        std::copy(bounds, bounds + classesCount, positions);
+        for (ptrdiff_t i = 0; i < end - begin; i++) {
+            *(buffer + positions[oracle[i]]++) = *(begin + i);
+        }
+        std::copy(buffer, buffer + (end - begin), begin);
+
+        size_t nextDepth = depth + 1;
+        std::optional<TaskGroup> group;
+        if (pool) {
+            group.emplace(*pool);
+        }
+        for (size_t bucket = 1; bucket < classesCount; bucket++) {
+            EntryIterator first = begin + bounds[bucket], last = begin + bounds[bucket + 1];
+            EntryIterator bucketBuffer = buffer + bounds[bucket];
+            if (last - first < 2) {
+                continue;
+            }
+            auto sortBucket = [strings, first, last, bucketBuffer, nextDepth](ThreadPool* bucketPool) {
+                if (nextDepth % cacheSize == 0) {
+                    RefreshCaches(strings, first, last, nextDepth);
+                }
+                RadixSortTask(strings, first, last, bucketBuffer, nextDepth, bucketPool);
+            };
+            if (group && last - first > SortingTuning::GetGrain<Entry>(SortingTuning::StringSortGrain)) {
+                group->Run([sortBucket, pool]() { sortBucket(pool); });
+            }
+            else {
+                sortBucket(nullptr);
+            }
+        }
+        if (group) {
+            group->Wait();
+        }
+    }
+
+    static size_t NextLcp(EntryIterator current, EntryIterator end, LcpIterator lcp) {
+        return current != end ? *lcp : 0;
+    }
+
+    /**
+    \brief merges sorted sequences with LCP arrays
+
+    \param strings first string of range
+    \param left first entry of left sequence
+    \param leftEnd next after last entry of left sequence
+    \param leftLcps LCP of every entry of left sequence with previous one
+    \param right first entry of right sequence
+    \param rightEnd next after last entry of right sequence
+    \param rightLcps LCP of every entry of right sequence with previous one
+    \param output first entry of output
+    \param outputLcps LCP of every output entry with previous one, first one is LCP with empty string
+    \note leftLcp and rightLcp are LCP of current entries with last output one: entry with greater one is less,
+    strings are compared only when they are equal and only after them
+    */
+    static void LcpMerge(Iterator strings, EntryIterator left, EntryIterator leftEnd, LcpIterator leftLcps,
+                         EntryIterator right, EntryIterator rightEnd, LcpIterator rightLcps, EntryIterator output, LcpIterator outputLcps) {
+        size_t leftLcp = 0, rightLcp = 0;
+        while (left != leftEnd && right != rightEnd) {
+            if (leftLcp > rightLcp) {
+                *output++ = *left++;
+                *outputLcps++ = leftLcp;
+                leftLcp = NextLcp(left, leftEnd, ++leftLcps);
+            }
+            else if (rightLcp > leftLcp) {
+                *output++ = *right++;
+                *outputLcps++ = rightLcp;
+                rightLcp = NextLcp(right, rightEnd, ++rightLcps);
+            }
+            else {
+                std::string_view leftString = GetString(strings, *left), rightString = GetString(strings, *right);
+                size_t lcp = GetLcp(leftString, rightString, leftLcp);
+                bool isLeftFirst = lcp == leftString.size() ||
+                    (lcp < rightString.size() && static_cast<unsigned char>(leftString[lcp]) < static_cast<unsigned char>(rightString[lcp]));
+                if (isLeftFirst) {
+                    *output++ = *left++;
+                    *outputLcps++ = leftLcp;
+                    rightLcp = lcp;
+                    leftLcp = NextLcp(left, leftEnd, ++leftLcps);
+                }
+                else {
+                    *output++ = *right++;
+                    *outputLcps++ = rightLcp;
+                    leftLcp = lcp;
+                    rightLcp = NextLcp(right, rightEnd, ++rightLcps);
+                }
+            }
+        }
+        if (left != leftEnd) {
+            *leftLcps = leftLcp;
+            std::copy(left, leftEnd, output);
+            std::copy(leftLcps, leftLcps + (leftEnd - left), outputLcps);
+        }
+        if (right != rightEnd) {
+            *rightLcps = rightLcp;
+            std::copy(right, rightEnd, output);
+            std::copy(rightLcps, rightLcps + (rightEnd - right), outputLcps);
+        }
+    }
+
+    /**
+    \brief merges adjacent sorted sequences with LCP arrays by parts that are merged concurrently
+
+    \param strings first string of range
+    \param begin first entry of left sequence
+    \param middle first entry of right sequence
+    \param end next after last entry of right sequence
+    \param lcps LCP of every entry with previous one in its sequence
+    \param output first entry of output
+    \param outputLcps LCP of every output entry with previous one, first one is LCP with empty string
+    \param pool thread pool merge runs on
+    \note parts of output are bounded by co-ranks as in MergeSort::MergeRangesParallel, LcpMerge of part starts
+    from empty string, so LCP of first entry of every part is found again after all parts are merged
+    */
+    static void LcpMergeParallel(Iterator strings, EntryIterator begin, EntryIterator middle, EntryIterator end, LcpIterator lcps,
+                                 EntryIterator output, LcpIterator outputLcps, ThreadPool& pool) {
+        size_t leftSize = middle - begin, rightSize = end - middle;
+        size_t size = leftSize + rightSize;
+        size_t partsCount = std::min(pool.GetWorkersCount(), size / SortingTuning::GetGrain<Entry>(SortingTuning::MergeGrain));
+        if (partsCount < 2) {
+            LcpMerge(strings, begin, middle, lcps, middle, end, lcps + leftSize, output, outputLcps);
+            return;
+        }
+        auto less = [strings](const Entry& left, const Entry& right) { return GetString(strings, left) < GetString(strings, right); };
+        using Merge = MergeSort<EntryIterator, decltype(less)>;
+        TaskGroup group(pool);
+        for (size_t part = 0; part < partsCount; part++) {
+            group.Run([=, &less]() {
+                size_t first = size * part / partsCount, last = size * (part + 1) / partsCount;
+                size_t i1 = Merge::CoRank(first, begin, leftSize, middle, rightSize, less);
+                size_t i2 = Merge::CoRank(last, begin, leftSize, middle, rightSize, less);
+                LcpMerge(strings, begin + i1, begin + i2, lcps + i1, middle + (first - i1), middle + (last - i2),
+                    lcps + leftSize + (first - i1), output + first, outputLcps + first);
+            });
+        }
+        group.Wait();
+        for (size_t part = 1; part < partsCount; part++) {
+            size_t first = size * part / partsCount;
+            *(outputLcps + first) = GetLcp(GetString(strings, *(output + (first - 1))), GetString(strings, *(output + first)), 0);
+        }
+    }
+
+    /**
+    \brief merges sorted chunks by balanced tree of tasks
+
+    \param strings first string of range
+    \param chunkBounds bounds of chunks
+    \param first index of first merged chunk
+    \param last index of next after last merged chunk
+    \param entries first entry of range
+    \param lcps LCP of every entry with previous one in its chunk
+    \param buffer scratch buffer of entries
+    \param lcpsBuffer scratch buffer of LCP
+    \param pool thread pool merges run on
+    */
+    static void MergeChunksTask(Iterator strings, const std::vector<size_t>& chunkBounds, size_t first, size_t last,
+                                EntryIterator entries, LcpIterator lcps, EntryIterator buffer, LcpIterator lcpsBuffer, ThreadPool& pool) {
+        if (last - first < 2) {
+            return;
+        }
+        size_t middle = first + (last - first) / 2;
+        TaskGroup group(pool);
+        group.Run([=, &chunkBounds, &pool]() {
+            MergeChunksTask(strings, chunkBounds, first, middle, entries, lcps, buffer, lcpsBuffer, pool);
+        });
+        MergeChunksTask(strings, chunkBounds, middle, last, entries, lcps, buffer, lcpsBuffer, pool);
+        group.Wait();
+
+        size_t begin = chunkBounds[first], split = chunkBounds[middle], end = chunkBounds[last];
+        LcpMergeParallel(strings, entries + begin, entries + split, entries + end, lcps + begin, buffer + begin, lcpsBuffer + begin, pool);
+        std::copy(buffer + begin, buffer + end, entries + begin);
+        std::copy(lcpsBuffer + begin, lcpsBuffer + end, lcps + begin);
+    }
+};
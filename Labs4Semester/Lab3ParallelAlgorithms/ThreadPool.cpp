@@ -0,0 +1,135 @@
+/**
+\file
+\brief .cpp file with implementation of work-stealing thread pool and task group
+*/
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t workersCount) {
+    if (workersCount == 0) {
+        workersCount = 1;
+    }
+    workers.reserve(workersCount);
+    for (size_t i = 0; i < workersCount; i++) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    threads.reserve(workersCount);
+    for (size_t i = 0; i < workersCount; i++) {
+        threads.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stop = true;
+    }
+    sleepCondition.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::GetWorkersCount() const {
+    return workers.size();
+}
+
+void ThreadPool::Submit(Task task) {
+    size_t index = IsWorkerThread() ? currentIndex : nextWorker++ % workers.size();
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    pendingTasks++;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_one();
+}
+
+bool ThreadPool::RunPendingTask() {
+    Task task;
+    size_t index = IsWorkerThread() ? currentIndex : workers.size();
+    if ((index < workers.size() && PopTask(index, task)) || StealTask(index, task)) {
+        task();
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::IsWorkerThread() const {
+    return currentPool == this;
+}
+
+ThreadPool& ThreadPool::GetDefault() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::WorkerLoop(size_t index) {
+    currentPool = this;
+    currentIndex = index;
+    while (true) {
+        if (RunPendingTask()) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() { return stop || pendingTasks > 0; });
+        if (stop && pendingTasks == 0) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::PopTask(size_t index, Task& task) {
+    std::lock_guard<std::mutex> lock(workers[index]->mutex);
+    if (workers[index]->tasks.empty()) {
+        return false;
+    }
+    task = std::move(workers[index]->tasks.back());
+    workers[index]->tasks.pop_back();
+    pendingTasks--;
+    return true;
+}
+
+bool ThreadPool::StealTask(size_t index, Task& task) {
+    for (size_t i = 1; i <= workers.size(); i++) {
+        size_t victim = (index + i) % workers.size();
+        if (victim == index) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(workers[victim]->mutex);
+        if (!workers[victim]->tasks.empty()) {
+            task = std::move(workers[victim]->tasks.front());
+            workers[victim]->tasks.pop_front();
+            pendingTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool(pool) {}
+
+TaskGroup::~TaskGroup() {
+    Join();
+}
+
+void TaskGroup::Wait() {
+    Join();
+    std::lock_guard<std::mutex> lock(exceptionMutex);
+    if (exception) {
+        std::exception_ptr thrown = exception;
+        exception = nullptr;
+        std::rethrow_exception(thrown);
+    }
+}
+
+void TaskGroup::Join() {
+    while (pending > 0) {
+        if (!pool.RunPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,229 @@
+/**
+\file
+\brief .h file with definition of work-stealing thread pool and task group
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+\brief class definition of work-stealing thread pool
+
+Every worker owns a deque of tasks: it pushes and pops its own tasks from the back,
+idle workers steal from the front of other deques. Number of workers is fixed at construction
+*/
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+    \brief ThreadPool ctor
+
+    \param workersCount number of worker threads, hardware concurrency by default
+    */
+    explicit ThreadPool(size_t workersCount = std::thread::hardware_concurrency());
+
+    /**
+    \brief ThreadPool dtor
+
+    \note waits for all workers to finish
+    */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+    \brief workers count getter
+
+    \return number of worker threads
+    */
+    size_t GetWorkersCount() const;
+
+    /**
+    \brief pushes task in the pool
+
+    \param task task to execute
+    \note from worker thread task is pushed in own deque, otherwise deques are chosen in turn
+    */
+    void Submit(Task task);
+
+    /**
+    \brief executes one pending task if there is any
+
+    \return true if some task was executed
+    \note used by waiting threads to help instead of blocking
+    */
+    bool RunPendingTask();
+
+    /**
+    \brief checks if current thread is worker of this pool
+
+    \return true if current thread is worker of this pool
+    */
+    bool IsWorkerThread() const;
+
+    /**
+    \brief runs function on the pool and waits for it
+
+    \param function function to run
+    \note if called from worker of this pool, function is called directly
+    */
+    template<typename Function>
+    void Execute(Function&& function) {
+        if (IsWorkerThread()) {
+            function();
+            return;
+        }
+        auto promise = std::make_shared<std::promise<void>>();
+        std::future<void> future = promise->get_future();
+        Submit([promise, &function]() {
+            try {
+                function();
+                promise->set_value();
+            }
+            catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        future.get();
+    }
+
+    /**
+    \brief default pool getter
+
+    \return pool with hardware concurrency workers, created on first call
+    */
+    static ThreadPool& GetDefault();
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void WorkerLoop(size_t index);
+    bool PopTask(size_t index, Task& task);
+    bool StealTask(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pendingTasks{ 0 };
+    std::atomic<size_t> nextWorker{ 0 };
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    bool stop = false;
+
+    inline static thread_local ThreadPool* currentPool = nullptr;
+    inline static thread_local size_t currentIndex = 0;
+};
+
+/**
+\brief class definition of fork/join task group
+
+Tasks are forked with Run and joined with Wait, waiting thread executes pending tasks meanwhile
+*/
+class TaskGroup {
+public:
+    /**
+    \brief TaskGroup ctor
+
+    \param pool pool tasks are executed on
+    */
+    explicit TaskGroup(ThreadPool& pool);
+
+    /**
+    \brief TaskGroup dtor
+
+    \note waits for all forked tasks
+    */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+    \brief forks task
+
+    \param function function to execute
+    */
+    template<typename Function>
+    void Run(Function&& function) {
+        pending++;
+        pool.Submit([this, function = std::forward<Function>(function)]() mutable {
+            try {
+                function();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            pending--;
+        });
+    }
+
+    /**
+    \brief joins all forked tasks
+
+    \note rethrows first exception thrown by tasks
+    */
+    void Wait();
+private:
+    void Join();
+
+    ThreadPool& pool;
+    std::atomic<size_t> pending{ 0 };
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+};
+
+/**
+\brief calls function for every index in range [0, count) concurrently and waits for all calls
+
+\param pool thread pool function is called on
+\param count number of indexes
+\param function function that takes index
+*/
+template<typename Function>
+void ParallelFor(ThreadPool& pool, size_t count, Function&& function) {
+    pool.Execute([&pool, count, &function]() {
+        TaskGroup group(pool);
+        for (size_t i = 1; i < count; i++) {
+            group.Run([&function, i]() {function(i); });
+        }
+        if (count > 0) {
+            function(0);
+        }
+        group.Wait();
+    });
+}
+
+/**
+\brief calls function for every index in range [0, count), concurrently if pool is given
+
+\param pool thread pool function is called on, indexes are processed in sequence if nullptr
+\param count number of indexes
+\param function function that takes index
+*/
+template<typename Function>
+void ParallelFor(ThreadPool* pool, size_t count, Function&& function) {
+    if (pool) {
+        ParallelFor(*pool, count, function);
+    }
+    else {
+        for (size_t i = 0; i < count; i++) {
+            function(i);
+        }
+    }
+}
@@ -7,11 +7,26 @@
 #include <random>
 #include <string>
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <execution>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <type_traits>
 
+#include "Benchmark.h"
+#include "Calibration.h"
+#include "ExternalSort.h"
+#include "ParallelPrimitives.h"
 #include "Profile.h"
 #include "Sorting.h"
+#include "SortingTuning.h"
+#include "StringSort.h"
+#include "ThreadPool.h"
+#include "SortingNetwork.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT
 
@@ -20,7 +35,7 @@
 /**
 \brief effective sorts tests
 
-\note quicksort, mergesort, mergesort in place, sample sort tests
+\note quicksort, mergesort, mergesort in place, natural mergesort, multiway mergesort, sample sort tests
 */
 TEST_CASE("testing effective sorts") {
     std::vector<long>v;
@@ -58,6 +73,19 @@ TEST_CASE("testing effective sorts") {
         MergeSort<std::vector<long>::iterator>::SortParallel(almost_sorted.begin(), almost_sorted.end());
         MergeSort<std::vector<long>::iterator>::SortParallel(almost_reverse_sorted.begin(), almost_reverse_sorted.end());
     }
+    SUBCASE("mergesort with scratch buffer sequence") {
+        std::vector<long> buffer(v.size());
+        MergeSort<std::vector<long>::iterator>::Sort(v.begin(), v.end(), buffer.begin());
+        MergeSort<std::vector<long>::iterator>::Sort(almost_sorted.begin(), almost_sorted.end(), buffer.begin());
+        MergeSort<std::vector<long>::iterator>::Sort(almost_reverse_sorted.begin(), almost_reverse_sorted.end(), buffer.begin());
+    }
+    SUBCASE("mergesort with scratch buffer parallel") {
+        std::vector<long> buffer(v.size());
+        ThreadPool pool(4);
+        MergeSort<std::vector<long>::iterator>::SortParallel(v.begin(), v.end(), buffer.begin(), pool);
+        MergeSort<std::vector<long>::iterator>::SortParallel(almost_sorted.begin(), almost_sorted.end(), buffer.begin(), pool);
+        MergeSort<std::vector<long>::iterator>::SortParallel(almost_reverse_sorted.begin(), almost_reverse_sorted.end(), buffer.begin(), pool);
+    }
     SUBCASE("mergesort in place sequence") {
         MergeSort<std::vector<long>::iterator>::SortInPlace(v.begin(), v.end());
         MergeSort<std::vector<long>::iterator>::SortInPlace(almost_sorted.begin(), almost_sorted.end());
@@ -68,6 +96,22 @@ TEST_CASE("testing effective sorts") {
         MergeSort<std::vector<long>::iterator>::SortParallelInPlace(almost_sorted.begin(), almost_sorted.end());
         MergeSort<std::vector<long>::iterator>::SortParallelInPlace(almost_reverse_sorted.begin(), almost_reverse_sorted.end());
     }
+    SUBCASE("natural mergesort sequence") {
+        NaturalMergeSort<std::vector<long>::iterator>::Sort(v.begin(), v.end());
+        NaturalMergeSort<std::vector<long>::iterator>::Sort(almost_sorted.begin(), almost_sorted.end());
+        NaturalMergeSort<std::vector<long>::iterator>::Sort(almost_reverse_sorted.begin(), almost_reverse_sorted.end());
+    }
+    SUBCASE("natural mergesort parallel") {
+        NaturalMergeSort<std::vector<long>::iterator>::SortParallel(v.begin(), v.end());
+        NaturalMergeSort<std::vector<long>::iterator>::SortParallel(almost_sorted.begin(), almost_sorted.end());
+        NaturalMergeSort<std::vector<long>::iterator>::SortParallel(almost_reverse_sorted.begin(), almost_reverse_sorted.end());
+    }
+    SUBCASE("multiway mergesort parallel") {
+        ThreadPool pool(4);
+        MultiwayMergeSort<std::vector<long>::iterator>::SortParallel(v.begin(), v.end(), pool);
+        MultiwayMergeSort<std::vector<long>::iterator>::SortParallel(almost_sorted.begin(), almost_sorted.end(), pool);
+        MultiwayMergeSort<std::vector<long>::iterator>::SortParallel(almost_reverse_sorted.begin(), almost_reverse_sorted.end(), pool);
+    }
     SUBCASE("samplesort sequence") {
         SampleSort<std::vector<long>::iterator>::Sort(v.begin(), v.end());
         SampleSort<std::vector<long>::iterator>::Sort(almost_sorted.begin(), almost_sorted.end());
@@ -83,6 +127,803 @@ TEST_CASE("testing effective sorts") {
     CHECK(v == copy_v);
 }
 
+/**
+\brief quicksort tests on inputs that are bad for naive pivot choice
+
+\note sorted, reversed, organ pipe, few unique and equal elements
+*/
+TEST_CASE("testing quicksort on patterns") {
+    static std::mt19937 rng{ std::random_device()() };
+    const long size = 200'000;
+    std::vector<std::vector<long>> inputs;
+    std::vector<long> sorted(size);
+    for (long i = 0; i < size; i++) {
+        sorted[i] = i;
+    }
+    inputs.push_back(sorted);
+    inputs.emplace_back(sorted.rbegin(), sorted.rend());
+    std::vector<long> organ_pipe(size);
+    for (long i = 0; i < size; i++) {
+        organ_pipe[i] = i < size / 2 ? i : size - i;
+    }
+    inputs.push_back(organ_pipe);
+    std::vector<long> few_unique(size);
+    for (auto& element : few_unique) {
+        element = rng() % 4;
+    }
+    inputs.push_back(few_unique);
+    inputs.push_back(std::vector<long>(size, 1));
+    ThreadPool pool(4);
+    for (const auto& input : inputs) {
+        auto copy_v = input;
+        std::sort(copy_v.begin(), copy_v.end());
+        auto v = input;
+        QuickSort<std::vector<long>::iterator>::Sort(v.begin(), v.end());
+        CHECK(v == copy_v);
+        v = input;
+        QuickSort<std::vector<long>::iterator>::SortParallel(v.begin(), v.end(), pool);
+        CHECK(v == copy_v);
+    }
+}
+
+/**
+\brief quicksort parallel partition tests
+
+\note ranges greater than parallel partition grain, with partition on and off
+*/
+TEST_CASE("testing quicksort parallel partition") {
+    static std::mt19937 rng{ std::random_device()() };
+    const long size = 1'000'000;
+    std::vector<std::vector<long>> inputs(3, std::vector<long>(size));
+    for (long i = 0; i < size; i++) {
+        inputs[0][i] = rng();
+        inputs[1][i] = rng() % 3;
+        inputs[2][i] = size - i;
+    }
+    ThreadPool pool(4);
+    for (bool enabled : {true, false}) {
+        QuickSort<std::vector<long>::iterator>::SetParallelPartition(enabled);
+        for (const auto& input : inputs) {
+            auto copy_v = input;
+            std::sort(copy_v.begin(), copy_v.end());
+            auto v = input;
+            QuickSort<std::vector<long>::iterator>::SortParallel(v.begin(), v.end(), pool);
+            CHECK(v == copy_v);
+        }
+    }
+    QuickSort<std::vector<long>::iterator>::SetParallelPartition(true);
+}
+
+/**
+\brief selection tests
+
+\note nth element, partial sort and top-k of random and few unique elements, sequence and parallel
+*/
+TEST_CASE("testing selection") {
+    static std::mt19937 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    using Iterator = std::vector<long>::iterator;
+    for (long modulo : {10, 1'000'000'000}) {
+        std::vector<long> v(1'000'000);
+        for (auto& element : v) {
+            element = rng() % modulo;
+        }
+        auto sorted = v;
+        std::sort(sorted.begin(), sorted.end());
+        for (size_t nth : {size_t(0), size_t(1000), v.size() / 2, v.size() - 1}) {
+            auto sequence = v, parallel = v;
+            QuickSort<Iterator>::NthElement(sequence.begin(), sequence.begin() + nth, sequence.end());
+            QuickSort<Iterator>::NthElementParallel(parallel.begin(), parallel.begin() + nth, parallel.end(), pool);
+            for (const auto& result : {sequence, parallel}) {
+                long value = sorted[nth];
+                CHECK(result[nth] == value);
+                CHECK(std::all_of(result.begin(), result.begin() + nth, [value](long element) { return element <= value; }));
+                CHECK(std::all_of(result.begin() + nth, result.end(), [value](long element) { return element >= value; }));
+            }
+        }
+        for (size_t k : {size_t(0), size_t(1000), v.size()}) {
+            auto sequence = v, parallel = v;
+            QuickSort<Iterator>::PartialSort(sequence.begin(), sequence.begin() + k, sequence.end());
+            QuickSort<Iterator>::PartialSortParallel(parallel.begin(), parallel.begin() + k, parallel.end(), pool);
+            for (const auto& result : {sequence, parallel}) {
+                CHECK(std::equal(result.begin(), result.begin() + k, sorted.begin()));
+            }
+            std::sort(sequence.begin(), sequence.end());
+            CHECK(sequence == sorted);
+        }
+        for (size_t k : {size_t(0), size_t(1000), size_t(200'000), v.size() + 1}) {
+            std::vector<long> expected(sorted.begin(), sorted.begin() + std::min(k, v.size()));
+            CHECK(TopK<long>::Find(v.begin(), v.end(), k) == expected);
+            CHECK(TopK<long>::FindParallel(v.begin(), v.end(), k, pool) == expected);
+        }
+        std::vector<long> greatest(sorted.rbegin(), sorted.rbegin() + 1000);
+        CHECK(TopK<long, std::greater<>>::FindParallel(v.begin(), v.end(), 1000, pool) == greatest);
+        TopK<long> first(1000), second(1000);
+        for (size_t i = 0; i < v.size(); i++) {
+            (i % 2 ? first : second).Push(v[i]);
+        }
+        first.Merge(second);
+        CHECK(first.GetSize() == 1000);
+        CHECK(first.Extract() == std::vector<long>(sorted.begin(), sorted.begin() + 1000));
+        CHECK(first.GetSize() == 0);
+    }
+}
+
+/**
+\brief argsort and sort by key tests
+
+\note few unique keys, mergesort results must be stable, others must keep payload with its key
+*/
+template<template<typename...> class Algorithm>
+void CheckIndirectSort(const std::vector<long>& keys, const std::vector<size_t>& stable, bool isStable, ThreadPool& pool) {
+    auto checkPermutation = [&keys, &stable, isStable](const std::vector<size_t>& permutation) {
+        if (isStable) {
+            return permutation == stable;
+        }
+        std::vector<bool> used(keys.size());
+        for (size_t i = 0; i < permutation.size(); i++) {
+            if (used[permutation[i]] || keys[permutation[i]] != keys[stable[i]]) {
+                return false;
+            }
+            used[permutation[i]] = true;
+        }
+        return permutation.size() == keys.size();
+    };
+    CHECK(checkPermutation(IndirectSort<Algorithm>::ArgSort(keys.begin(), keys.end())));
+    CHECK(checkPermutation(IndirectSort<Algorithm>::ArgSortParallel(keys.begin(), keys.end(), pool)));
+    for (bool parallel : {false, true}) {
+        auto copy_keys = keys;
+        std::vector<size_t> payload(keys.size());
+        for (size_t i = 0; i < payload.size(); i++) {
+            payload[i] = i;
+        }
+        if (parallel) {
+            IndirectSort<Algorithm>::SortByKeyParallel(copy_keys.begin(), copy_keys.end(), payload.begin(), pool);
+        }
+        else {
+            IndirectSort<Algorithm>::SortByKey(copy_keys.begin(), copy_keys.end(), payload.begin());
+        }
+        CHECK(checkPermutation(payload));
+        bool keysFollowPayload = true;
+        for (size_t i = 0; i < payload.size(); i++) {
+            keysFollowPayload = keysFollowPayload && copy_keys[i] == keys[payload[i]];
+        }
+        CHECK(keysFollowPayload);
+    }
+}
+
+TEST_CASE("testing argsort and sort by key") {
+    static std::mt19937 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    for (long size : {0, 1, 1000, 100'000}) {
+        std::vector<long> keys(size);
+        for (auto& key : keys) {
+            key = rng() % 100;
+        }
+        std::vector<size_t> stable(size);
+        for (long i = 0; i < size; i++) {
+            stable[i] = i;
+        }
+        std::stable_sort(stable.begin(), stable.end(), [&keys](size_t left, size_t right) { return keys[left] < keys[right]; });
+        CheckIndirectSort<QuickSort>(keys, stable, false, pool);
+        CheckIndirectSort<MergeSort>(keys, stable, true, pool);
+        CheckIndirectSort<SampleSort>(keys, stable, false, pool);
+    }
+}
+
+/**
+\brief samplesort tests on few unique elements
+
+\note elements equal to splitters are placed in separate buckets
+*/
+TEST_CASE("testing samplesort on few unique elements") {
+    std::vector<long>v;
+    v.reserve(100'000);
+    static std::mt19937 rng{ std::random_device()() };
+    for (long i = 0; i < 100'000; i++) {
+        v.push_back(rng() % 5);
+    }
+    auto copy_v = v;
+    std::sort(copy_v.begin(), copy_v.end());
+    auto parallel_v = v;
+    ThreadPool pool(4);
+    SampleSort<std::vector<long>::iterator>::Sort(v.begin(), v.end());
+    SampleSort<std::vector<long>::iterator>::SortParallel(parallel_v.begin(), parallel_v.end(), pool);
+    CHECK(v == copy_v);
+    CHECK(parallel_v == copy_v);
+    std::vector<long> equal(100'000, 7);
+    SampleSort<std::vector<long>::iterator>::SortParallel(equal.begin(), equal.end(), pool);
+    CHECK(equal == std::vector<long>(100'000, 7));
+}
+
+/**
+\brief parallel merge tests
+
+\note merges of halves with different sizes and many equal elements
+*/
+TEST_CASE("testing parallel merge") {
+    static std::mt19937 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    for (size_t leftSize : {0, 1, 70'000, 150'000, 300'000}) {
+        std::vector<long> v(300'000);
+        for (auto& element : v) {
+            element = rng() % 1000;
+        }
+        std::sort(v.begin(), v.begin() + leftSize);
+        std::sort(v.begin() + leftSize, v.end());
+        auto copy_v = v;
+        std::sort(copy_v.begin(), copy_v.end());
+        MergeSort<std::vector<long>::iterator>::MergeParallel(v.begin(), v.begin() + leftSize, v.end(), pool);
+        CHECK(v == copy_v);
+    }
+}
+
+/**
+\brief element with key and index for stability tests
+
+\note compared only by key
+*/
+struct KeyIndex {
+    long key;
+    size_t index;
+
+    bool operator<(const KeyIndex& other) const {
+        return key < other.key;
+    }
+
+    bool operator==(const KeyIndex& other) const {
+        return key == other.key && index == other.index;
+    }
+};
+
+/**
+\brief mergesort stability tests
+
+\note equal keys must keep original order
+*/
+TEST_CASE("testing mergesort stability") {
+    static std::mt19937 rng{ std::random_device()() };
+    std::vector<KeyIndex> v;
+    v.reserve(100'000);
+    for (size_t i = 0; i < 100'000; i++) {
+        v.push_back({ static_cast<long>(rng() % 100), i });
+    }
+    auto copy_v = v;
+    std::stable_sort(copy_v.begin(), copy_v.end());
+    ThreadPool pool(4);
+    SUBCASE("mergesort sequence") {
+        MergeSort<std::vector<KeyIndex>::iterator>::Sort(v.begin(), v.end());
+    }
+    SUBCASE("mergesort parallel") {
+        MergeSort<std::vector<KeyIndex>::iterator>::SortParallel(v.begin(), v.end(), pool);
+    }
+    SUBCASE("mergesort in place sequence") {
+        MergeSort<std::vector<KeyIndex>::iterator>::SortInPlace(v.begin(), v.end());
+    }
+    SUBCASE("mergesort in place parallel") {
+        MergeSort<std::vector<KeyIndex>::iterator>::SortParallelInPlace(v.begin(), v.end(), pool);
+    }
+    SUBCASE("natural mergesort sequence") {
+        NaturalMergeSort<std::vector<KeyIndex>::iterator>::Sort(v.begin(), v.end());
+    }
+    SUBCASE("natural mergesort parallel") {
+        NaturalMergeSort<std::vector<KeyIndex>::iterator>::SortParallel(v.begin(), v.end(), pool);
+    }
+    SUBCASE("multiway mergesort parallel") {
+        MultiwayMergeSort<std::vector<KeyIndex>::iterator>::SortParallel(v.begin(), v.end(), pool);
+    }
+    SUBCASE("multiway mergesort parallel with 3 ways") {
+        ThreadPool threeWorkers(3);
+        MultiwayMergeSort<std::vector<KeyIndex>::iterator>::SortParallel(v.begin(), v.end(), threeWorkers);
+    }
+    CHECK(v == copy_v);
+}
+
+/**
+\brief element without default constructor for scratch buffer tests
+
+\note compared only by key, label is lost if moved-from element is left in range
+*/
+struct Labeled {
+    long key;
+    std::string label;
+
+    Labeled(long key, size_t index) : key(key), label(std::to_string(index)) {}
+
+    bool operator<(const Labeled& other) const {
+        return key < other.key;
+    }
+
+    bool operator==(const Labeled& other) const {
+        return key == other.key && label == other.label;
+    }
+};
+
+/**
+\brief sortings with scratch buffers on elements without default constructor
+
+\note results must be equal to std::stable_sort
+*/
+TEST_CASE("testing sortings of elements without default constructor") {
+    using Iterator = std::vector<Labeled>::iterator;
+    static std::mt19937 rng{ std::random_device()() };
+    std::vector<Labeled> v;
+    for (size_t i = 0; i < 100'000; i++) {
+        v.emplace_back(static_cast<long>(rng() % 1000), i);
+    }
+    auto copy_v = v;
+    std::stable_sort(copy_v.begin(), copy_v.end());
+    ThreadPool pool(4);
+    auto key = [](const Labeled& element) { return element.key; };
+    SUBCASE("mergesort sequence") {
+        MergeSort<Iterator>::Sort(v.begin(), v.end());
+    }
+    SUBCASE("mergesort parallel") {
+        MergeSort<Iterator>::SortParallel(v.begin(), v.end(), pool);
+    }
+    SUBCASE("merges") {
+        auto middle = v.begin() + v.size() / 3;
+        std::stable_sort(v.begin(), middle);
+        std::stable_sort(middle, v.end());
+        auto merged = v;
+        MergeSort<Iterator>::Merge(v.begin(), middle, v.end());
+        MergeSort<Iterator>::MergeParallel(merged.begin(), merged.begin() + (middle - v.begin()), merged.end(), pool);
+        CHECK(merged == copy_v);
+    }
+    SUBCASE("natural mergesort sequence") {
+        NaturalMergeSort<Iterator>::Sort(v.begin(), v.end());
+    }
+    SUBCASE("natural mergesort parallel") {
+        NaturalMergeSort<Iterator>::SortParallel(v.begin(), v.end(), pool);
+    }
+    SUBCASE("multiway mergesort parallel") {
+        MultiwayMergeSort<Iterator>::SortParallel(v.begin(), v.end(), pool);
+    }
+    SUBCASE("radix sort") {
+        RadixSort<Iterator>::SortParallel(v.begin(), v.end(), key, pool);
+    }
+    SUBCASE("sort by key") {
+        std::vector<long> keys(v.size());
+        std::transform(v.begin(), v.end(), keys.begin(), key);
+        IndirectSort<MergeSort>::SortByKeyParallel(keys.begin(), keys.end(), v.begin(), pool);
+    }
+    CHECK(v == copy_v);
+}
+
+/**
+\brief natural mergesort tests on inputs with runs
+
+\note results must be equal to std::stable_sort on sorted, reversed, almost sorted, organ pipe, sawtooth
+and few unique inputs of different sizes, reversed runs have equal keys to check their stability
+*/
+TEST_CASE("testing natural mergesort") {
+    static std::mt19937 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    std::vector<std::pair<std::string, std::function<long(size_t, size_t)>>> inputs{
+        { "sorted", [](size_t i, size_t) { return static_cast<long>(i); } },
+        { "reversed", [](size_t i, size_t size) { return static_cast<long>(size - i); } },
+        { "reversed with equal keys", [](size_t i, size_t size) { return static_cast<long>(size - i) / 3; } },
+        { "almost sorted", [](size_t i, size_t) { return static_cast<long>(rng() % 100 ? i : rng() % (i + 1)); } },
+        { "organ pipe", [](size_t i, size_t size) { return static_cast<long>(std::min(i, size - i)); } },
+        { "sawtooth", [](size_t i, size_t) { return static_cast<long>(i % (1 + i / 5000 * 37 % 1000)); } },
+        { "few unique", [](size_t, size_t) { return static_cast<long>(rng() % 4); } }
+    };
+    for (const auto& input : inputs) {
+        INFO(input.first);
+        for (size_t size : { 0, 1, 2, 31, 64, 1000, 100'000 }) {
+            std::vector<KeyIndex> v;
+            v.reserve(size);
+            for (size_t i = 0; i < size; i++) {
+                v.push_back({ input.second(i, size), i });
+            }
+            auto copy_v = v;
+            std::stable_sort(copy_v.begin(), copy_v.end());
+            auto parallel_v = v;
+            NaturalMergeSort<std::vector<KeyIndex>::iterator>::Sort(v.begin(), v.end());
+            NaturalMergeSort<std::vector<KeyIndex>::iterator>::SortParallel(parallel_v.begin(), parallel_v.end(), pool);
+            CHECK(v == copy_v);
+            CHECK(parallel_v == copy_v);
+        }
+    }
+}
+
+/**
+\brief checks all comparison sorts with comparator and projection
+
+\param input elements with unique indexes in order of indexes
+\param pool thread pool parallel sorts run on
+\param compare comparator of projections
+\param projection function that returns projection of element
+\note mergesort results must be equal to std::stable_sort, others must be ordered permutations of input
+*/
+template<typename Compare, typename Projection>
+void CheckOrderedSorts(const std::vector<KeyIndex>& input, ThreadPool& pool, Compare compare, Projection projection) {
+    using Iterator = std::vector<KeyIndex>::iterator;
+    auto less = [&compare, &projection](const KeyIndex& left, const KeyIndex& right) {
+        return std::invoke(compare, std::invoke(projection, left), std::invoke(projection, right));
+    };
+    auto stable = input;
+    std::stable_sort(stable.begin(), stable.end(), less);
+    auto check = [&](bool isStable, auto sort) {
+        auto v = input;
+        sort(v.begin(), v.end());
+        if (isStable) {
+            CHECK(v == stable);
+        }
+        else {
+            CHECK(std::is_sorted(v.begin(), v.end(), less));
+            std::sort(v.begin(), v.end(), [](const KeyIndex& left, const KeyIndex& right) { return left.index < right.index; });
+            CHECK(v == input);
+        }
+    };
+    using Quick = QuickSort<Iterator, Compare, Projection>;
+    using Merge = MergeSort<Iterator, Compare, Projection>;
+    using Sample = SampleSort<Iterator, Compare, Projection>;
+    using Slow = SlowSort<Iterator, Compare, Projection>;
+    using Natural = NaturalMergeSort<Iterator, Compare, Projection>;
+    using Multiway = MultiwayMergeSort<Iterator, Compare, Projection>;
+    check(false, [&](Iterator begin, Iterator end) { Quick::Sort(begin, end, compare, projection); });
+    check(false, [&](Iterator begin, Iterator end) { Quick::SortParallel(begin, end, pool, compare, projection); });
+    check(false, [&](Iterator begin, Iterator end) { Sample::Sort(begin, end, compare, projection); });
+    check(false, [&](Iterator begin, Iterator end) { Sample::SortParallel(begin, end, pool, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Merge::Sort(begin, end, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Merge::SortParallel(begin, end, pool, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Merge::SortInPlace(begin, end, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Merge::SortParallelInPlace(begin, end, pool, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Natural::Sort(begin, end, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Natural::SortParallel(begin, end, pool, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) { Multiway::SortParallel(begin, end, pool, compare, projection); });
+    check(true, [&](Iterator begin, Iterator end) {
+        Iterator middle = begin + (end - begin) / 3;
+        std::stable_sort(begin, middle, less);
+        std::stable_sort(middle, end, less);
+        Merge::MergeParallel(begin, middle, end, pool, compare, projection);
+    });
+    check(true, [&](Iterator begin, Iterator end) {
+        Iterator middle = begin + (end - begin) / 3;
+        std::stable_sort(begin, middle, less);
+        std::stable_sort(middle, end, less);
+        Merge::MergeInPlaceParallel(begin, middle, end, pool, compare, projection);
+    });
+
+    auto v = input;
+    Iterator pivot = Quick::Partition(v.begin(), v.end(), v.begin() + v.size() / 2, compare, projection);
+    CHECK(std::all_of(v.begin(), pivot, [&](const KeyIndex& element) { return less(element, *pivot); }));
+    CHECK(std::none_of(pivot, v.end(), [&](const KeyIndex& element) { return less(element, *pivot); }));
+
+    std::vector<KeyIndex> small(input.begin(), input.begin() + 100);
+    auto smallInput = small;
+    Slow::SortParallel(small.begin(), small.end(), pool, compare, projection);
+    CHECK(std::is_sorted(small.begin(), small.end(), less));
+    std::sort(small.begin(), small.end(), [](const KeyIndex& left, const KeyIndex& right) { return left.index < right.index; });
+    CHECK(small == smallInput);
+}
+
+/**
+\brief comparator and projection tests
+
+\note descending order, order by field of element and stateful comparator
+*/
+TEST_CASE("testing comparators and projections") {
+    static std::mt19937 rng{ std::random_device()() };
+    std::vector<KeyIndex> v;
+    v.reserve(100'000);
+    for (size_t i = 0; i < 100'000; i++) {
+        v.push_back({ static_cast<long>(rng() % 1000) - 500, i });
+    }
+    ThreadPool pool(4);
+    SUBCASE("descending") {
+        CheckOrderedSorts(v, pool, [](const KeyIndex& left, const KeyIndex& right) { return right < left; }, Identity());
+    }
+    SUBCASE("by field") {
+        CheckOrderedSorts(v, pool, std::greater<>(), &KeyIndex::key);
+    }
+    SUBCASE("stateful comparator") {
+        long modulo = 7;
+        CheckOrderedSorts(v, pool, [modulo](long left, long right) { return left % modulo < right % modulo; },
+            [](const KeyIndex& element) { return element.key; });
+    }
+}
+
+/**
+\brief radix sort tests
+
+\note signed integers, floating point numbers, sorting of records by key and all digit sizes
+*/
+TEST_CASE("testing radix sort") {
+    static std::mt19937 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    std::vector<long long> integers(100'000);
+    for (auto& element : integers) {
+        element = static_cast<long long>(rng()) - rng() + (static_cast<long long>(rng()) << 32);
+    }
+    std::vector<double> doubles(100'000);
+    std::uniform_real_distribution<double> distr(-1e9, 1e9);
+    for (auto& element : doubles) {
+        element = distr(rng);
+    }
+    doubles[0] = -0.0;
+    doubles[1] = 0.0;
+    auto sorted_integers = integers;
+    std::sort(sorted_integers.begin(), sorted_integers.end());
+    auto sorted_doubles = doubles;
+    std::sort(sorted_doubles.begin(), sorted_doubles.end());
+    SUBCASE("radix sort sequence") {
+        RadixSort<std::vector<long long>::iterator>::Sort(integers.begin(), integers.end());
+        RadixSort<std::vector<double>::iterator, 11>::Sort(doubles.begin(), doubles.end());
+    }
+    SUBCASE("radix sort parallel") {
+        RadixSort<std::vector<long long>::iterator, 16>::SortParallel(integers.begin(), integers.end(), pool);
+        RadixSort<std::vector<double>::iterator>::SortParallel(doubles.begin(), doubles.end(), pool);
+    }
+    SUBCASE("radix sort by key") {
+        std::vector<KeyIndex> records;
+        records.reserve(integers.size());
+        for (size_t i = 0; i < integers.size(); i++) {
+            records.push_back({ static_cast<long>(rng() % 1000) - 500, i });
+        }
+        auto sorted_records = records;
+        std::stable_sort(sorted_records.begin(), sorted_records.end());
+        auto parallel_records = records;
+        RadixSort<std::vector<KeyIndex>::iterator>::Sort(records.begin(), records.end(), [](const KeyIndex& record) { return record.key; });
+        RadixSort<std::vector<KeyIndex>::iterator>::SortParallel(parallel_records.begin(), parallel_records.end(),
+            [](const KeyIndex& record) { return record.key; }, pool);
+        CHECK(records == sorted_records);
+        CHECK(parallel_records == sorted_records);
+        std::sort(integers.begin(), integers.end());
+        std::sort(doubles.begin(), doubles.end());
+    }
+    CHECK(integers == sorted_integers);
+    CHECK(doubles == sorted_doubles);
+}
+
+/**
+\brief string sortings tests
+
+\note benchmark distributions and strings with empty ones, zero and non-ASCII characters, equal long strings
+and common prefixes ending at every position of 8 characters caches, results must be equal to std::sort
+*/
+TEST_CASE("testing string sortings") {
+    using Iterator = std::vector<std::string>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    std::vector<std::vector<std::string>> inputs;
+    for (StringDistribution distribution : GetStringDistributions()) {
+        inputs.push_back(GenerateStrings(distribution, 100'000, rng));
+    }
+    std::vector<std::string> special{ "", "", std::string(1, '\0'), std::string(2, '\0'), "a", std::string("a\0", 2),
+        std::string("a\0b", 3), "\xff", "\x80" "a", "ab" };
+    for (size_t i = 0; i < 20'000; i++) {
+        std::string prefix(rng() % 20, 'p');
+        std::string suffix(rng() % 3, static_cast<char>(rng() % 3));
+        special.push_back(prefix + suffix);
+        special.push_back(std::string(100, 'q'));
+    }
+    inputs.push_back(special);
+    inputs.push_back({});
+    inputs.push_back({ "single" });
+    inputs.push_back(std::vector<std::string>(special.begin(), special.begin() + 50));
+    for (const auto& input : inputs) {
+        auto sorted = input;
+        std::sort(sorted.begin(), sorted.end());
+        auto check = [&](auto sort) {
+            auto v = input;
+            sort(v.begin(), v.end());
+            CHECK(v == sorted);
+        };
+        check([](Iterator begin, Iterator end) { StringSort<Iterator>::MultikeyQuickSort(begin, end); });
+        check([&pool](Iterator begin, Iterator end) { StringSort<Iterator>::MultikeyQuickSortParallel(begin, end, pool); });
+        check([](Iterator begin, Iterator end) { StringSort<Iterator>::RadixSort(begin, end); });
+        check([&pool](Iterator begin, Iterator end) { StringSort<Iterator>::RadixSortParallel(begin, end, pool); });
+        check([&pool](Iterator begin, Iterator end) { StringSort<Iterator>::MergeSortParallel(begin, end, pool); });
+    }
+}
+
+/**
+\brief parallel primitives tests
+
+\note results must be equal to standard algorithms on ranges of one, two and four chunks,
+reduction must keep order of non-commutative operation
+*/
+TEST_CASE("testing parallel primitives") {
+    static std::mt19937 rng{ std::random_device()() };
+    ThreadPool pool(4);
+    auto generate = [](size_t size) {
+        std::vector<long> v(size);
+        for (auto& element : v) {
+            element = static_cast<long>(rng() % 1000) - 500;
+        }
+        return v;
+    };
+    const std::vector<size_t> sizes{ 0, 1, 15'000, 100'000 };
+    SUBCASE("scans") {
+        for (size_t size : sizes) {
+            std::vector<long> v = generate(size);
+            std::vector<long> expected(size), result(size);
+            std::inclusive_scan(v.begin(), v.end(), expected.begin());
+            CHECK(ParallelPrimitives::InclusiveScan(v.begin(), v.end(), result.begin(), pool) == result.end());
+            CHECK(result == expected);
+            std::exclusive_scan(v.begin(), v.end(), expected.begin(), 5L, [](long left, long right) { return std::max(left, right); });
+            ParallelPrimitives::ExclusiveScan(v.begin(), v.end(), result.begin(), 5L, pool, [](long left, long right) { return std::max(left, right); });
+            CHECK(result == expected);
+            std::exclusive_scan(v.begin(), v.end(), expected.begin(), 7L);
+            ParallelPrimitives::ExclusiveScan(v.begin(), v.end(), v.begin(), 7L, pool);
+            CHECK(v == expected);
+        }
+    }
+    SUBCASE("transform reduce") {
+        for (size_t size : sizes) {
+            std::vector<long> v = generate(size);
+            long long squares = std::transform_reduce(v.begin(), v.end(), 1LL, std::plus<>(), [](long element) { return 1LL * element * element; });
+            CHECK(ParallelPrimitives::TransformReduce(v.begin(), v.end(), 1LL, pool, std::plus<>(),
+                [](long element) { return 1LL * element * element; }) == squares);
+            std::string letters;
+            for (long element : v) {
+                letters += static_cast<char>('a' + (element + 500) % 26);
+            }
+            std::string concatenation = ParallelPrimitives::TransformReduce(v.begin(), v.end(), std::string(">"), pool, std::plus<>(),
+                [](long element) { return std::string(1, static_cast<char>('a' + (element + 500) % 26)); });
+            CHECK(concatenation == ">" + letters);
+        }
+    }
+    SUBCASE("stable partition") {
+        for (size_t size : sizes) {
+            std::vector<long> v = generate(size);
+            std::vector<KeyIndex> records, expected;
+            for (size_t i = 0; i < size; i++) {
+                records.push_back({ v[i], i });
+            }
+            expected = records;
+            auto isEven = [](const KeyIndex& record) { return record.key % 2 == 0; };
+            auto expectedPoint = std::stable_partition(expected.begin(), expected.end(), isEven);
+            auto point = ParallelPrimitives::StablePartition(records.begin(), records.end(), isEven, pool);
+            CHECK(point - records.begin() == expectedPoint - expected.begin());
+            CHECK(records == expected);
+        }
+    }
+    SUBCASE("unique") {
+        for (size_t size : sizes) {
+            std::vector<long> v = generate(size);
+            for (auto& element : v) {
+                element %= 3;
+            }
+            auto expected = v;
+            expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+            v.erase(ParallelPrimitives::Unique(v.begin(), v.end(), pool), v.end());
+            CHECK(v == expected);
+            std::vector<long> same(size, 42);
+            same.erase(ParallelPrimitives::Unique(same.begin(), same.end(), pool), same.end());
+            CHECK(same.size() == std::min<size_t>(size, 1));
+        }
+    }
+    SUBCASE("set operations") {
+        for (size_t size : sizes) {
+            std::vector<long> v = generate(size);
+            std::vector<long> other(size / 3);
+            for (auto& element : other) {
+                element = static_cast<long>(rng() % 1000) - 500;
+            }
+            std::sort(v.begin(), v.end());
+            std::sort(other.begin(), other.end());
+            std::vector<long> expected, result(v.size() + other.size());
+            for (bool isSwapped : { false, true }) {
+                auto& first = isSwapped ? other : v;
+                auto& second = isSwapped ? v : other;
+                expected.clear();
+                std::set_union(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(expected));
+                auto resultEnd = ParallelPrimitives::SetUnion(first.begin(), first.end(), second.begin(), second.end(), result.begin(), pool);
+                CHECK(std::vector<long>(result.begin(), resultEnd) == expected);
+                expected.clear();
+                std::set_intersection(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(expected));
+                resultEnd = ParallelPrimitives::SetIntersection(first.begin(), first.end(), second.begin(), second.end(), result.begin(), pool);
+                CHECK(std::vector<long>(result.begin(), resultEnd) == expected);
+            }
+            std::reverse(v.begin(), v.end());
+            std::reverse(other.begin(), other.end());
+            expected.clear();
+            std::set_union(v.begin(), v.end(), other.begin(), other.end(), std::back_inserter(expected), std::greater<>());
+            auto resultEnd = ParallelPrimitives::SetUnion(v.begin(), v.end(), other.begin(), other.end(), result.begin(), pool, std::greater<>());
+            CHECK(std::vector<long>(result.begin(), resultEnd) == expected);
+        }
+    }
+}
+
+/**
+\brief counts negative zeros, which compare equal to positive zeros
+
+\param v checked numbers
+\return number of -0.0 in v
+*/
+template<typename T>
+size_t CountNegativeZeros(const std::vector<T>& v) {
+    return std::count_if(v.begin(), v.end(), [](T value) { return value == 0 && std::signbit(value); });
+}
+
+/**
+\brief checks scalar and AVX2 sorting network kernels on blocks of every size
+
+\param rng random numbers generator
+*/
+template<typename T>
+void CheckSortingNetwork(std::mt19937& rng) {
+    for (size_t size = 0; size <= SortingNetwork::maxSize; size++) {
+        std::vector<T> v(size);
+        for (auto& element : v) {
+            element = static_cast<T>(static_cast<long long>(rng() % 200) - 100);
+        }
+        auto copy_v = v;
+        std::sort(copy_v.begin(), copy_v.end());
+        auto scalar_v = v;
+        SortingNetwork::SortScalar(scalar_v.data(), size);
+        CHECK(scalar_v == copy_v);
+        SortingNetwork::Sort(v.data(), size);
+        CHECK(v == copy_v);
+    }
+    if constexpr (std::is_floating_point_v<T>) {
+        const T values[] = { T(-0.0), T(0.0), T(-1), T(1) };
+        for (size_t size = 2; size <= SortingNetwork::maxSize; size++) {
+            std::vector<T> v(size);
+            for (auto& element : v) {
+                element = values[rng() % 4];
+            }
+            auto copy_v = v;
+            std::sort(copy_v.begin(), copy_v.end());
+            auto scalar_v = v;
+            SortingNetwork::SortScalar(scalar_v.data(), size);
+            CHECK(scalar_v == copy_v);
+            CHECK(CountNegativeZeros(scalar_v) == CountNegativeZeros(copy_v));
+            SortingNetwork::Sort(v.data(), size);
+            CHECK(v == copy_v);
+            CHECK(CountNegativeZeros(v) == CountNegativeZeros(copy_v));
+        }
+    }
+}
+
+/**
+\brief sorting network tests
+
+\note int32, int64, float and double blocks, AVX2 kernel is checked if processor supports it
+*/
+TEST_CASE("testing sorting network") {
+    static std::mt19937 rng{ std::random_device()() };
+    CheckSortingNetwork<int32_t>(rng);
+    CheckSortingNetwork<int64_t>(rng);
+    CheckSortingNetwork<float>(rng);
+    CheckSortingNetwork<double>(rng);
+
+    SUBCASE("signed zeros in sortings with leaf sort") {
+        const double values[] = { -0.0, 0.0, -1.0, 1.0 };
+        std::vector<double> v(10'000);
+        for (auto& element : v) {
+            element = values[rng() % 4];
+        }
+        auto copy_v = v;
+        std::sort(copy_v.begin(), copy_v.end());
+        auto quick_v = v;
+        QuickSort<std::vector<double>::iterator>::Sort(quick_v.begin(), quick_v.end());
+        CHECK(quick_v == copy_v);
+        CHECK(CountNegativeZeros(quick_v) == CountNegativeZeros(copy_v));
+        using Merge = MergeSort<std::vector<double>::iterator>;
+        auto signs = [](const std::vector<double>& sorted) {
+            std::vector<bool> result;
+            for (double value : sorted) {
+                result.push_back(std::signbit(value));
+            }
+            return result;
+        };
+        auto stable_v = v;
+        std::stable_sort(stable_v.begin(), stable_v.end());
+        ThreadPool pool(4);
+        auto merge_v = v, parallel_merge_v = v, in_place_merge_v = v;
+        Merge::Sort(merge_v.begin(), merge_v.end());
+        Merge::SortParallel(parallel_merge_v.begin(), parallel_merge_v.end(), pool);
+        Merge::SortInPlace(in_place_merge_v.begin(), in_place_merge_v.end());
+        CHECK(signs(merge_v) == signs(stable_v));
+        CHECK(signs(parallel_merge_v) == signs(stable_v));
+        CHECK(signs(in_place_merge_v) == signs(stable_v));
+    }
+}
+
 /**
 \brief non-effective sorts tests
 
@@ -120,115 +961,894 @@ TEST_CASE("testing non-effective sorts") {
 }
 
 /**
-\brief logs durations of sequence and parallel versions of implemented sorts and std::sort
+\brief sortings tuning tests
 
-\note slowsort only for < 250 elements, merge sort in place only for < 100'000 elements
+\note config file round trip, invalid files, sortings with tiny grains and calibration on small inputs
 */
-void LogSortings(const std::vector<long long>& random_v) {
-    std::cerr << std::endl << std::endl << "Elements: " + std::to_string(random_v.size()) << std::endl;
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("std::sort. Sequence");
-        std::sort(copy_r_v.begin(), copy_r_v.end());
+TEST_CASE("testing sortings tuning") {
+    std::string path = (std::filesystem::temp_directory_path() / "sorting_tuning_test.cfg").string();
+    SUBCASE("config file") {
+        SortingTuning::Set(SortingTuning::QuickSortGrain, 1234);
+        SortingTuning::Set(SortingTuning::SampleSortCutoff, 0);
+        CHECK(SortingTuning::Get(SortingTuning::SampleSortCutoff) == 256);
+        SortingTuning::Save(path);
+        SortingTuning::Reset();
+        CHECK(SortingTuning::Get(SortingTuning::QuickSortGrain) == 5000);
+        CHECK(SortingTuning::Load(path));
+        CHECK(SortingTuning::Get(SortingTuning::QuickSortGrain) == 1234);
+        CHECK(SortingTuning::Get(SortingTuning::SampleSortCutoff) == 256);
+        CHECK(SortingTuning::GetGrain<Record<64>>(SortingTuning::QuickSortGrain) == 8 * 1234);
+        std::ofstream(path) << "# comment" << std::endl << std::endl << "quicksort_grain 4321" << std::endl;
+        CHECK(SortingTuning::Load(path));
+        CHECK(SortingTuning::Get(SortingTuning::QuickSortGrain) == 4321);
+        CHECK(SortingTuning::Get(SortingTuning::SampleSortCutoff) == 256);
+        std::ofstream(path) << "unknown_grain 10" << std::endl;
+        CHECK_THROWS_AS(SortingTuning::Load(path), std::runtime_error);
+        std::ofstream(path) << "merge_grain -10" << std::endl;
+        CHECK_THROWS_AS(SortingTuning::Load(path), std::runtime_error);
+        std::filesystem::remove(path);
+        CHECK_FALSE(SortingTuning::Load(path));
     }
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("std::sort. Parallel");
-        std::sort(std::execution::par, copy_r_v.begin(), copy_r_v.end());
+    SUBCASE("tiny grains") {
+        for (size_t parameter = 0; parameter < SortingTuning::ParametersCount; parameter++) {
+            SortingTuning::Set(static_cast<SortingTuning::Parameter>(parameter), 64);
+        }
+        static std::mt19937 rng{ std::random_device()() };
+        std::vector<long> v(100'000);
+        for (auto& element : v) {
+            element = rng() % 10'000;
+        }
+        auto copy_v = v;
+        std::sort(copy_v.begin(), copy_v.end());
+        ThreadPool pool(4);
+        auto quick = v, merge = v, sample = v, radix = v;
+        QuickSort<std::vector<long>::iterator>::SortParallel(quick.begin(), quick.end(), pool);
+        MergeSort<std::vector<long>::iterator>::SortParallel(merge.begin(), merge.end(), pool);
+        SampleSort<std::vector<long>::iterator>::SortParallel(sample.begin(), sample.end(), pool);
+        RadixSort<std::vector<long>::iterator>::SortParallel(radix.begin(), radix.end(), pool);
+        CHECK(quick == copy_v);
+        CHECK(merge == copy_v);
+        CHECK(sample == copy_v);
+        CHECK(radix == copy_v);
     }
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("QuickSort. Sequence");
-        QuickSort<std::vector<long long>::iterator>::Sort(copy_r_v.begin(), copy_r_v.end());
+    SUBCASE("minimal parameters") {
+        for (size_t parameter = 0; parameter < SortingTuning::ParametersCount; parameter++) {
+            SortingTuning::Set(static_cast<SortingTuning::Parameter>(parameter), 1);
+        }
+        CHECK(SortingTuning::Get(SortingTuning::QuickSortGrain) == 1);
+        CHECK(SortingTuning::Get(SortingTuning::SlowSortGrain) == 2);
+        CHECK(SortingTuning::Get(SortingTuning::SampleSortCutoff) == 256);
+        using Iterator = std::vector<long>::iterator;
+        using StringIterator = std::vector<std::string>::iterator;
+        static std::mt19937 rng{ std::random_device()() };
+        ThreadPool pool(4);
+        for (size_t size : {0, 1, 2, 3, 17, 100, 5000}) {
+            std::vector<long> v(size);
+            std::vector<std::string> strings(size);
+            for (size_t i = 0; i < size; i++) {
+                v[i] = rng() % 100;
+                strings[i] = std::to_string(v[i]);
+            }
+            auto copy_v = v;
+            std::sort(copy_v.begin(), copy_v.end());
+            auto check = [&](auto sort) {
+                auto sorted = v;
+                sort(sorted.begin(), sorted.end());
+                CHECK(sorted == copy_v);
+            };
+            check([&pool](Iterator begin, Iterator end) { QuickSort<Iterator>::SortParallel(begin, end, pool); });
+            check([&pool](Iterator begin, Iterator end) { MergeSort<Iterator>::SortParallel(begin, end, pool); });
+            check([&pool](Iterator begin, Iterator end) { SampleSort<Iterator>::SortParallel(begin, end, pool); });
+            check([&pool](Iterator begin, Iterator end) { RadixSort<Iterator>::SortParallel(begin, end, pool); });
+            check([&pool](Iterator begin, Iterator end) {
+                std::vector<long> payload(begin, end);
+                IndirectSort<MergeSort>::SortByKeyParallel(begin, end, payload.begin(), pool);
+            });
+            if (size <= 100) {
+                check([&pool](Iterator begin, Iterator end) { SlowSort<Iterator>::SortParallel(begin, end, pool); });
+            }
+            auto sorted_strings = strings;
+            std::sort(sorted_strings.begin(), sorted_strings.end());
+            for (auto sort : { &StringSort<StringIterator>::MultikeyQuickSortParallel, &StringSort<StringIterator>::RadixSortParallel,
+                &StringSort<StringIterator>::MergeSortParallel }) {
+                auto copy_strings = strings;
+                sort(copy_strings.begin(), copy_strings.end(), pool);
+                CHECK(copy_strings == sorted_strings);
+            }
+        }
     }
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("QuickSort. Parallel");
-        QuickSort<std::vector<long long>::iterator>::SortParallel(copy_r_v.begin(), copy_r_v.end());
+    SUBCASE("calibration") {
+        CalibrationOptions options;
+        options.maxSize = 2'000;
+        options.repetitions = 1;
+        std::ostringstream log;
+        ThreadPool pool(4);
+        Calibrate(options, pool, log);
+        SortingTuning::Save(path);
+        CHECK(SortingTuning::Load(path));
+        CHECK(log.str().find("quicksort_grain: ") != std::string::npos);
+        std::filesystem::remove(path);
     }
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("MergeSort. Sequence");
-        MergeSort<std::vector<long long>::iterator>::Sort(copy_r_v.begin(), copy_r_v.end());
+    SortingTuning::Reset();
+}
+
+/**
+\brief thread pool tests
+
+\note fork/join of nested tasks on pools with different workers count
+*/
+TEST_CASE("testing thread pool") {
+    for (size_t workers : {1, 2, 4}) {
+        ThreadPool pool(workers);
+        CHECK(pool.GetWorkersCount() == workers);
+        std::atomic<long> sum{ 0 };
+        pool.Execute([&pool, &sum]() {
+            TaskGroup group(pool);
+            for (long i = 1; i <= 100; i++) {
+                group.Run([&pool, &sum, i]() {
+                    TaskGroup nested(pool);
+                    nested.Run([&sum, i]() { sum += i; });
+                    sum += i;
+                    nested.Wait();
+                });
+            }
+            group.Wait();
+        });
+        CHECK(sum == 10'100);
+        CHECK_THROWS(pool.Execute([&pool]() {
+            TaskGroup group(pool);
+            group.Run([]() { throw std::runtime_error("task error"); });
+            group.Wait();
+        }));
     }
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("MergeSort. Parallel");
-        MergeSort<std::vector<long long>::iterator>::SortParallel(copy_r_v.begin(), copy_r_v.end());
+}
+
+/**
+\brief hardware counters tests
+
+\note unavailable counters are allowed, available ones must grow with work done on pool workers
+*/
+TEST_CASE("testing performance counters") {
+    ThreadPool pool(2);
+    PerfCounters counters;
+    std::vector<long> v(1'000'000);
+    for (size_t i = 0; i < v.size(); i++) {
+        v[i] = static_cast<long>(v.size() - i);
     }
-    {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("SampleSort. Sequence");
-        SampleSort<std::vector<long long>::iterator>::Sort(copy_r_v.begin(), copy_r_v.end());
+    QuickSort<std::vector<long>::iterator>::SortParallel(v.begin(), v.end(), pool);
+    PerfCounters::Values first = counters.Read();
+    PerfCounters::Values second = counters.Read();
+    for (size_t event = 0; event < PerfCounters::EventsCount; event++) {
+        CHECK(first[event].has_value() == second[event].has_value());
+        if (first[event] && second[event]) {
+            CHECK(*first[event] <= *second[event]);
+        }
+    }
+    if (first[PerfCounters::Instructions]) {
+        CHECK(*first[PerfCounters::Instructions] > 0);
     }
+    CHECK(PerfCounters::ToString(first).find("IPC: ") != std::string::npos);
+}
+
+/**
+\brief external sort tests
+
+\note small memory budget makes many runs and several merge passes, direct io falls back to buffered
+where O_DIRECT is not supported
+*/
+TEST_CASE("testing external sort") {
+    static std::mt19937 rng{ std::random_device()() };
+    const size_t recordSize = 24, keyOffset = 5, keySize = 6, count = 20'000;
+    std::vector<std::string> records(count);
+    for (size_t i = 0; i < count; i++) {
+        records[i].resize(recordSize);
+        for (auto& byte : records[i]) {
+            byte = static_cast<char>(rng() % 4);
+        }
+        std::memcpy(&records[i][recordSize - sizeof(i)], &i, sizeof(i));
+    }
+    auto directory = std::filesystem::temp_directory_path();
+    ExternalSortOptions options;
+    options.inputPath = (directory / "external_sort_test_input").string();
+    options.outputPath = (directory / "external_sort_test_output").string();
+    options.temporaryDirectory = directory.string();
+    options.recordSize = recordSize;
+    options.keyOffset = keyOffset;
+    options.keySize = keySize;
     {
-        std::vector<long long> copy_r_v = random_v;
-        LOG_DURATION("SampleSort. Parallel");
-        SampleSort<std::vector<long long>::iterator>::SortParallel(copy_r_v.begin(), copy_r_v.end());
+        std::ofstream input(options.inputPath, std::ios::binary);
+        for (const auto& record : records) {
+            input.write(record.data(), recordSize);
+        }
+    }
+    std::stable_sort(records.begin(), records.end(), [](const std::string& left, const std::string& right) {
+        return left.compare(keyOffset, keySize, right, keyOffset, keySize) < 0;
+    });
+    ThreadPool pool(4);
+    for (bool direct : {false, true}) {
+        options.direct = direct;
+        options.memoryBytes = direct ? 256 << 10 : 64 << 10;
+        ExternalSortStatistics statistics = ExternalSort(options, pool).Sort();
+        CHECK(statistics.bytes == count * recordSize);
+        CHECK(statistics.mergePasses > 1);
+        std::ifstream output(options.outputPath, std::ios::binary);
+        std::vector<std::string> sorted;
+        std::string record(recordSize, '\0');
+        while (output.read(&record[0], recordSize)) {
+            sorted.push_back(record);
+        }
+        CHECK(sorted == records);
     }
-    if (random_v.size() < 100'000) {
-        {
-            std::vector<long long> copy_r_v = random_v;
-            LOG_DURATION("MergeSort in place. Sequence");
-            MergeSort<std::vector<long long>::iterator>::SortInPlace(copy_r_v.begin(), copy_r_v.end());
+    std::filesystem::remove(options.inputPath);
+    std::filesystem::remove(options.outputPath);
+    options.keyOffset = recordSize;
+    CHECK_THROWS_AS(ExternalSort(options, pool), std::invalid_argument);
+}
+
+/**
+\brief radix sort key of benchmark element: element itself for arithmetic types, key for records
+*/
+struct RadixKey {
+    template<typename T>
+    auto operator()(const T& element) const {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return element;
         }
-        {
-            std::vector<long long> copy_r_v = random_v;
-            LOG_DURATION("MergeSort in place. Parallel");
-            MergeSort<std::vector<long long>::iterator>::SortParallelInPlace(copy_r_v.begin(), copy_r_v.end());
+        else {
+            return element.key;
         }
     }
-    if (random_v.size() < 250) {
-        {
-            std::vector<long long> copy_r_v = random_v;
-            LOG_DURATION("SlowSort. Sequence");
-            SlowSort<std::vector<long long>::iterator>::Sort(copy_r_v.begin(), copy_r_v.end());
+};
+
+/**
+\brief measures sequence and parallel versions of implemented sorts and std::sort on all distributions
+
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel sorts are measured on each of them
+\param sizes sizes of inputs
+\note slowsort only for < 250 elements, mergesort in place only for <= 1'000'000 elements,
+radix sort for arithmetic types and records
+*/
+template<typename T>
+void BenchmarkSortings(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, const std::vector<size_t>& sizes) {
+    using Iterator = typename std::vector<T>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    constexpr bool radixSortable = !std::is_same_v<T, std::string>;
+    for (Distribution kind : GetDistributions()) {
+        std::string distribution = ToString(kind);
+        for (size_t size : sizes) {
+            std::vector<T> input = GenerateInput<T>(kind, size, rng);
+            std::vector<T> buffer(size);
+            benchmark.Measure("std::sort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                std::sort(begin, end);
+            });
+            benchmark.Measure("std::sort. Parallel", distribution, std::thread::hardware_concurrency(), input, [](Iterator begin, Iterator end) {
+                std::sort(std::execution::par, begin, end);
+            });
+            if constexpr (radixSortable) {
+                benchmark.Measure("RadixSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                    RadixSort<Iterator>::Sort(begin, end, RadixKey());
+                });
+            }
+            benchmark.Measure("QuickSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                QuickSort<Iterator>::Sort(begin, end);
+            });
+            benchmark.Measure("MergeSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                MergeSort<Iterator>::Sort(begin, end);
+            });
+            benchmark.Measure("MergeSort with scratch buffer. Sequence", distribution, 1, input, [&buffer](Iterator begin, Iterator end) {
+                MergeSort<Iterator>::Sort(begin, end, buffer.begin());
+            });
+            benchmark.Measure("NaturalMergeSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                NaturalMergeSort<Iterator>::Sort(begin, end);
+            });
+            benchmark.Measure("SampleSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                SampleSort<Iterator>::Sort(begin, end);
+            });
+            if (size <= 1'000'000) {
+                benchmark.Measure("MergeSort in place. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                    MergeSort<Iterator>::SortInPlace(begin, end);
+                });
+            }
+            if (size < 250) {
+                benchmark.Measure("SlowSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                    SlowSort<Iterator>::Sort(begin, end);
+                });
+            }
+            for (const auto& pool : pools) {
+                ThreadPool& workers = *pool;
+                size_t workersCount = workers.GetWorkersCount();
+                if constexpr (radixSortable) {
+                    benchmark.Measure("RadixSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                        RadixSort<Iterator>::SortParallel(begin, end, RadixKey(), workers);
+                    });
+                }
+                benchmark.Measure("QuickSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    QuickSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                benchmark.Measure("MergeSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    MergeSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                benchmark.Measure("MergeSort with scratch buffer. Parallel", distribution, workersCount, input, [&workers, &buffer](Iterator begin, Iterator end) {
+                    MergeSort<Iterator>::SortParallel(begin, end, buffer.begin(), workers);
+                });
+                benchmark.Measure("NaturalMergeSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    NaturalMergeSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                benchmark.Measure("MultiwayMergeSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    MultiwayMergeSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                benchmark.Measure("SampleSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    SampleSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                if (size <= 1'000'000) {
+                    benchmark.Measure("MergeSort in place. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                        MergeSort<Iterator>::SortParallelInPlace(begin, end, workers);
+                    });
+                }
+                if (size < 250) {
+                    benchmark.Measure("SlowSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                        SlowSort<Iterator>::SortParallel(begin, end, workers);
+                    });
+                }
+            }
         }
-        {
-            std::vector<long long> copy_r_v = random_v;
-            LOG_DURATION("SlowSort. Parallel");
-            SlowSort<std::vector<long long>::iterator>::SortParallel(copy_r_v.begin(), copy_r_v.end());
+    }
+}
+
+/**
+\brief measures string sortings against std::sort and generic sortings on urls, words and long prefixes
+
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel sorts are measured on each of them
+\param sizes sizes of inputs
+\note only sizes up to 1'000'000 strings
+*/
+void BenchmarkStringSortings(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, const std::vector<size_t>& sizes) {
+    using Iterator = std::vector<std::string>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    for (StringDistribution kind : GetStringDistributions()) {
+        std::string distribution = ToString(kind);
+        for (size_t size : sizes) {
+            if (size > 1'000'000) {
+                continue;
+            }
+            std::vector<std::string> input = GenerateStrings(kind, size, rng);
+            benchmark.Measure("Strings. std::sort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                std::sort(begin, end);
+            });
+            benchmark.Measure("Strings. std::sort. Parallel", distribution, std::thread::hardware_concurrency(), input, [](Iterator begin, Iterator end) {
+                std::sort(std::execution::par, begin, end);
+            });
+            benchmark.Measure("Strings. QuickSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                QuickSort<Iterator>::Sort(begin, end);
+            });
+            benchmark.Measure("Strings. MultikeyQuickSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                StringSort<Iterator>::MultikeyQuickSort(begin, end);
+            });
+            benchmark.Measure("Strings. RadixSort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+                StringSort<Iterator>::RadixSort(begin, end);
+            });
+            for (const auto& pool : pools) {
+                ThreadPool& workers = *pool;
+                size_t workersCount = workers.GetWorkersCount();
+                benchmark.Measure("Strings. QuickSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    QuickSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                benchmark.Measure("Strings. MergeSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    MergeSort<Iterator>::SortParallel(begin, end, workers);
+                });
+                benchmark.Measure("Strings. MultikeyQuickSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    StringSort<Iterator>::MultikeyQuickSortParallel(begin, end, workers);
+                });
+                benchmark.Measure("Strings. RadixSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    StringSort<Iterator>::RadixSortParallel(begin, end, workers);
+                });
+                benchmark.Measure("Strings. MergeSort with LCP merge. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                    StringSort<Iterator>::MergeSortParallel(begin, end, workers);
+                });
+            }
         }
     }
 }
 
-int main()
-{
-    doctest::Context context;
-    int res = context.run();
-    static std::random_device rd;
-    static std::mt19937 mersenne(rd());
+/**
+\brief measures sorting of wide records directly, by key column with records as payload and by argsort
 
-    std::streambuf* cerrbuf = std::cerr.rdbuf();
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel sorts are measured on each of them
+\param name name of algorithm
+\param input records to sort
+\note key column is copied inside measured function, as it is sorted in place
+*/
+template<template<typename...> class Algorithm, size_t Size>
+void BenchmarkIndirectSort(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools,
+    const std::string& name, const std::vector<Record<Size>>& input) {
+    using Iterator = typename std::vector<Record<Size>>::iterator;
+    std::string distribution = ToString(Distribution::Random);
+    std::vector<uint64_t> keys(input.size());
+    for (size_t i = 0; i < input.size(); i++) {
+        keys[i] = input[i].key;
+    }
+    benchmark.Measure(name + ". Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+        Algorithm<Iterator>::Sort(begin, end);
+    });
+    benchmark.Measure(name + " by key column. Sequence", distribution, 1, input, [&keys](Iterator begin, Iterator) {
+        std::vector<uint64_t> column = keys;
+        IndirectSort<Algorithm>::SortByKey(column.begin(), column.end(), begin);
+    });
+    benchmark.Measure(name + " argsort. Sequence", distribution, 1, input, [&keys](Iterator begin, Iterator) {
+        IndirectSort<Algorithm>::Permute(begin, IndirectSort<Algorithm>::ArgSort(keys.begin(), keys.end()));
+    });
+    for (const auto& pool : pools) {
+        ThreadPool& workers = *pool;
+        size_t workersCount = workers.GetWorkersCount();
+        benchmark.Measure(name + ". Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+            Algorithm<Iterator>::SortParallel(begin, end, workers);
+        });
+        benchmark.Measure(name + " by key column. Parallel", distribution, workersCount, input, [&keys, &workers](Iterator begin, Iterator) {
+            std::vector<uint64_t> column = keys;
+            IndirectSort<Algorithm>::SortByKeyParallel(column.begin(), column.end(), begin, workers);
+        });
+        benchmark.Measure(name + " argsort. Parallel", distribution, workersCount, input, [&keys, &workers](Iterator begin, Iterator) {
+            IndirectSort<Algorithm>::PermuteParallel(begin, IndirectSort<Algorithm>::ArgSortParallel(keys.begin(), keys.end(), workers), workers);
+        });
+    }
+}
 
-    std::ofstream out("benchmark.txt");
+/**
+\brief measures sorting of 64 and 256 bytes records directly, by key column and by argsort
 
-    std::cerr.rdbuf(out.rdbuf());
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel sorts are measured on each of them
+\param maxSize maximal number of elements
+\note sizes 100'000 and 1'000'000 elements
+*/
+void BenchmarkIndirectSorts(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, size_t maxSize) {
+    static std::mt19937_64 rng{ std::random_device()() };
+    for (size_t size = 100'000; size <= std::min<size_t>(maxSize, 1'000'000); size *= 10) {
+        auto records64 = GenerateInput<Record<64>>(Distribution::Random, size, rng);
+        BenchmarkIndirectSort<QuickSort>(benchmark, pools, "QuickSort", records64);
+        BenchmarkIndirectSort<MergeSort>(benchmark, pools, "MergeSort", records64);
+        BenchmarkIndirectSort<SampleSort>(benchmark, pools, "SampleSort", records64);
+        auto records256 = GenerateInput<Record<256>>(Distribution::Random, size, rng);
+        BenchmarkIndirectSort<QuickSort>(benchmark, pools, "QuickSort", records256);
+        BenchmarkIndirectSort<MergeSort>(benchmark, pools, "MergeSort", records256);
+        BenchmarkIndirectSort<SampleSort>(benchmark, pools, "SampleSort", records256);
+    }
+}
+
+/**
+\brief measures sequence and parallel merge of two sorted halves
 
-    std::cout << "Run sortings on random vector..." << std::endl;
-    std::cerr << std::endl << std::endl << "RANDOM VECTOR" << std::endl;
-    for (long long size = 100; size < 10'000'000; size *= 1.1) {
-        std::vector<long long>random_v;
-        random_v.reserve(size);
-        for (long long i = 0; i < size; i++) {
-            random_v.push_back(mersenne() % size);
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel merge is measured on each of them
+\param maxSize maximal number of elements
+\note sizes from 1'000'000 to maxSize elements
+*/
+void BenchmarkMerges(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, size_t maxSize) {
+    using Iterator = std::vector<int64_t>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    for (size_t size = 1'000'000; size <= maxSize; size *= 10) {
+        std::vector<int64_t> input = GenerateInput<int64_t>(Distribution::Random, size, rng);
+        std::sort(input.begin(), input.begin() + size / 2);
+        std::sort(input.begin() + size / 2, input.end());
+        benchmark.Measure("Merge. Sequence", "sorted halves", 1, input, [](Iterator begin, Iterator end) {
+            MergeSort<Iterator>::Merge(begin, begin + (end - begin) / 2, end);
+        });
+        for (const auto& pool : pools) {
+            ThreadPool& workers = *pool;
+            benchmark.Measure("Merge. Parallel", "sorted halves", workers.GetWorkersCount(), input, [&workers](Iterator begin, Iterator end) {
+                MergeSort<Iterator>::MergeParallel(begin, begin + (end - begin) / 2, end, workers);
+            });
         }
-        LogSortings(random_v);
     }
-    std::cout << "Run sortings on almost sorted vector..." << std::endl;
-    std::cerr << std::endl << std::endl << "ALMOST SORTED VECTOR" << std::endl;
-    for (long long size = 100; size < 1'000'000; size *= 1.1) {
-        std::vector<long long>random_v;
-        random_v.reserve(size);
-        for (long long i = 0; i < size; i++) {
-            random_v.push_back(mersenne() % size);
+}
+
+/**
+\brief measures parallel multiway mergesort against parallel mergesort and sample sort
+
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, sorts are measured on each of them
+\param maxSize maximal number of elements
+\note sizes from 1'000'000 to maxSize elements, multiway merge pays off on ranges much larger than caches
+*/
+void BenchmarkMultiwayMergeSort(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, size_t maxSize) {
+    using Iterator = std::vector<int64_t>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    std::string distribution = ToString(Distribution::Random);
+    for (size_t size = 1'000'000; size <= maxSize; size *= 10) {
+        std::vector<int64_t> input = GenerateInput<int64_t>(Distribution::Random, size, rng);
+        std::vector<int64_t> buffer(size);
+        for (const auto& pool : pools) {
+            ThreadPool& workers = *pool;
+            size_t workersCount = workers.GetWorkersCount();
+            benchmark.Measure("Large. MergeSort with scratch buffer. Parallel", distribution, workersCount, input,
+                [&workers, &buffer](Iterator begin, Iterator end) {
+                    MergeSort<Iterator>::SortParallel(begin, end, buffer.begin(), workers);
+                });
+            benchmark.Measure("Large. SampleSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                SampleSort<Iterator>::SortParallel(begin, end, workers);
+            });
+            benchmark.Measure("Large. MultiwayMergeSort with scratch buffer. Parallel", distribution, workersCount, input,
+                [&workers, &buffer](Iterator begin, Iterator end) {
+                    MultiwayMergeSort<Iterator>::SortParallel(begin, end, buffer.begin(), workers);
+                });
         }
-        std::sort(random_v.begin(), random_v.end());
-        for (long long i = 0; i < size / 100; i++) {
-            std::swap(random_v[mersenne() % random_v.size()], random_v[mersenne() % random_v.size()]);
+    }
+}
+
+/**
+\brief measures selection of median and of 1000 smallest elements against std::nth_element, std::partial_sort and full sort
+
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel selection is measured on each of them
+\param maxSize maximal number of elements
+\note sizes from 1'000'000 to maxSize elements
+*/
+void BenchmarkSelection(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, size_t maxSize) {
+    using Iterator = std::vector<int64_t>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    const size_t k = 1000;
+    std::string distribution = ToString(Distribution::Random);
+    for (size_t size = 1'000'000; size <= maxSize; size *= 10) {
+        std::vector<int64_t> input = GenerateInput<int64_t>(Distribution::Random, size, rng);
+        std::vector<int64_t> sorted = input;
+        std::sort(sorted.begin(), sorted.end());
+        size_t median = size / 2;
+        std::vector<int64_t> found;
+        auto isMedian = [&sorted, median](const std::vector<int64_t>& result) { return result[median] == sorted[median]; };
+        auto isPartiallySorted = [&sorted, k](const std::vector<int64_t>& result) {
+            return std::equal(result.begin(), result.begin() + k, sorted.begin());
+        };
+        auto isFound = [&sorted, &found, k](const std::vector<int64_t>&) {
+            return found.size() == k && std::equal(found.begin(), found.end(), sorted.begin());
+        };
+        benchmark.Measure("Full sort. std::sort. Sequence", distribution, 1, input, [](Iterator begin, Iterator end) {
+            std::sort(begin, end);
+        });
+        benchmark.Measure("Median. std::nth_element. Sequence", distribution, 1, input, [median](Iterator begin, Iterator end) {
+            std::nth_element(begin, begin + median, end);
+        }, isMedian);
+        benchmark.Measure("Median. std::nth_element. Parallel", distribution, std::thread::hardware_concurrency(), input,
+            [median](Iterator begin, Iterator end) {
+                std::nth_element(std::execution::par, begin, begin + median, end);
+            }, isMedian);
+        benchmark.Measure("Median. QuickSort::NthElement. Sequence", distribution, 1, input, [median](Iterator begin, Iterator end) {
+            QuickSort<Iterator>::NthElement(begin, begin + median, end);
+        }, isMedian);
+        benchmark.Measure("Top 1000. std::partial_sort. Sequence", distribution, 1, input, [k](Iterator begin, Iterator end) {
+            std::partial_sort(begin, begin + k, end);
+        }, isPartiallySorted);
+        benchmark.Measure("Top 1000. QuickSort::PartialSort. Sequence", distribution, 1, input, [k](Iterator begin, Iterator end) {
+            QuickSort<Iterator>::PartialSort(begin, begin + k, end);
+        }, isPartiallySorted);
+        benchmark.Measure("Top 1000. TopK::Find. Sequence", distribution, 1, input, [&found, k](Iterator begin, Iterator end) {
+            found = TopK<int64_t>::Find(begin, end, k);
+        }, isFound);
+        for (const auto& pool : pools) {
+            ThreadPool& workers = *pool;
+            size_t workersCount = workers.GetWorkersCount();
+            benchmark.Measure("Full sort. QuickSort. Parallel", distribution, workersCount, input, [&workers](Iterator begin, Iterator end) {
+                QuickSort<Iterator>::SortParallel(begin, end, workers);
+            });
+            benchmark.Measure("Median. QuickSort::NthElement. Parallel", distribution, workersCount, input,
+                [&workers, median](Iterator begin, Iterator end) {
+                    QuickSort<Iterator>::NthElementParallel(begin, begin + median, end, workers);
+                }, isMedian);
+            benchmark.Measure("Top 1000. QuickSort::PartialSort. Parallel", distribution, workersCount, input,
+                [&workers, k](Iterator begin, Iterator end) {
+                    QuickSort<Iterator>::PartialSortParallel(begin, begin + k, end, workers);
+                }, isPartiallySorted);
+            benchmark.Measure("Top 1000. TopK::FindParallel. Parallel", distribution, workersCount, input,
+                [&workers, &found, k](Iterator begin, Iterator end) {
+                    found = TopK<int64_t>::FindParallel(begin, end, k, workers);
+                }, isFound);
+        }
+    }
+}
+
+/**
+\brief measures parallel primitives against sequence and std::execution::par algorithms of standard library
+
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, parallel primitives are measured on each of them
+\param maxSize maximal number of elements
+\note sizes from 1'000'000 to maxSize elements, results of scans and set operations are written to buffers out of input
+*/
+void BenchmarkPrimitives(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, size_t maxSize) {
+    using Iterator = std::vector<int64_t>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    std::string distribution = ToString(Distribution::Random);
+    auto isOdd = [](int64_t element) { return element % 2 != 0; };
+    auto square = [](int64_t element) { return element * element % 1000; };
+    for (size_t size = 1'000'000; size <= maxSize; size *= 10) {
+        std::vector<int64_t> input = GenerateInput<int64_t>(Distribution::Random, size, rng);
+        std::vector<int64_t> fewUnique = input;
+        for (auto& element : fewUnique) {
+            element %= 16;
+        }
+        std::vector<int64_t> other = GenerateInput<int64_t>(Distribution::Random, size / 2, rng);
+        std::vector<int64_t> sorted = input;
+        std::sort(sorted.begin(), sorted.end());
+        std::sort(other.begin(), other.end());
+
+        std::vector<int64_t> output(size + other.size());
+        std::vector<int64_t> scan(size), exclusiveScan(size), partition = input, unique = fewUnique, setUnion, setIntersection;
+        std::inclusive_scan(input.begin(), input.end(), scan.begin());
+        std::exclusive_scan(input.begin(), input.end(), exclusiveScan.begin(), int64_t(0));
+        int64_t reduced = std::transform_reduce(input.begin(), input.end(), int64_t(0), std::plus<>(), square);
+        auto partitionPoint = std::stable_partition(partition.begin(), partition.end(), isOdd) - partition.begin();
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+        std::set_union(sorted.begin(), sorted.end(), other.begin(), other.end(), std::back_inserter(setUnion));
+        std::set_intersection(sorted.begin(), sorted.end(), other.begin(), other.end(), std::back_inserter(setIntersection));
+
+        int64_t result = 0;
+        ptrdiff_t count = 0;
+        auto isScan = [&output, &scan](const std::vector<int64_t>&) { return std::equal(scan.begin(), scan.end(), output.begin()); };
+        auto isExclusiveScan = [&output, &exclusiveScan](const std::vector<int64_t>&) {
+            return std::equal(exclusiveScan.begin(), exclusiveScan.end(), output.begin());
+        };
+        auto isReduced = [&result, reduced](const std::vector<int64_t>&) { return result == reduced; };
+        auto isPartitioned = [&count, &partition, partitionPoint](const std::vector<int64_t>& copy) {
+            return count == partitionPoint && copy == partition;
+        };
+        auto isUnique = [&count, &unique](const std::vector<int64_t>& copy) {
+            return count == static_cast<ptrdiff_t>(unique.size()) && std::equal(unique.begin(), unique.end(), copy.begin());
+        };
+        auto isUnion = [&count, &output, &setUnion](const std::vector<int64_t>&) {
+            return count == static_cast<ptrdiff_t>(setUnion.size()) && std::equal(setUnion.begin(), setUnion.end(), output.begin());
+        };
+        auto isIntersection = [&count, &output, &setIntersection](const std::vector<int64_t>&) {
+            return count == static_cast<ptrdiff_t>(setIntersection.size())
+                && std::equal(setIntersection.begin(), setIntersection.end(), output.begin());
+        };
+
+        auto measureStandard = [&](const std::string& policyName, size_t workersCount, auto policy) {
+            benchmark.Measure("Inclusive scan. std::inclusive_scan. " + policyName, distribution, workersCount, input,
+                [&output, policy](Iterator begin, Iterator end) {
+                    std::inclusive_scan(policy, begin, end, output.begin());
+                }, isScan);
+            benchmark.Measure("Exclusive scan. std::exclusive_scan. " + policyName, distribution, workersCount, input,
+                [&output, policy](Iterator begin, Iterator end) {
+                    std::exclusive_scan(policy, begin, end, output.begin(), int64_t(0));
+                }, isExclusiveScan);
+            benchmark.Measure("Transform reduce. std::transform_reduce. " + policyName, distribution, workersCount, input,
+                [&result, square, policy](Iterator begin, Iterator end) {
+                    result = std::transform_reduce(policy, begin, end, int64_t(0), std::plus<>(), square);
+                }, isReduced);
+            benchmark.Measure("Stable partition. std::stable_partition. " + policyName, distribution, workersCount, input,
+                [&count, isOdd, policy](Iterator begin, Iterator end) {
+                    count = std::stable_partition(policy, begin, end, isOdd) - begin;
+                }, isPartitioned);
+            benchmark.Measure("Unique. std::unique. " + policyName, distribution, workersCount, fewUnique,
+                [&count, policy](Iterator begin, Iterator end) {
+                    count = std::unique(policy, begin, end) - begin;
+                }, isUnique);
+            benchmark.Measure("Set union. std::set_union. " + policyName, distribution, workersCount, sorted,
+                [&count, &output, &other, policy](Iterator begin, Iterator end) {
+                    count = std::set_union(policy, begin, end, other.begin(), other.end(), output.begin()) - output.begin();
+                }, isUnion);
+            benchmark.Measure("Set intersection. std::set_intersection. " + policyName, distribution, workersCount, sorted,
+                [&count, &output, &other, policy](Iterator begin, Iterator end) {
+                    count = std::set_intersection(policy, begin, end, other.begin(), other.end(), output.begin()) - output.begin();
+                }, isIntersection);
+        };
+        measureStandard("Sequence", 1, std::execution::seq);
+        measureStandard("Parallel", std::thread::hardware_concurrency(), std::execution::par);
+
+        for (const auto& pool : pools) {
+            ThreadPool& workers = *pool;
+            size_t workersCount = workers.GetWorkersCount();
+            benchmark.Measure("Inclusive scan. ParallelPrimitives. Parallel", distribution, workersCount, input,
+                [&workers, &output](Iterator begin, Iterator end) {
+                    ParallelPrimitives::InclusiveScan(begin, end, output.begin(), workers);
+                }, isScan);
+            benchmark.Measure("Exclusive scan. ParallelPrimitives. Parallel", distribution, workersCount, input,
+                [&workers, &output](Iterator begin, Iterator end) {
+                    ParallelPrimitives::ExclusiveScan(begin, end, output.begin(), int64_t(0), workers);
+                }, isExclusiveScan);
+            benchmark.Measure("Transform reduce. ParallelPrimitives. Parallel", distribution, workersCount, input,
+                [&workers, &result, square](Iterator begin, Iterator end) {
+                    result = ParallelPrimitives::TransformReduce(begin, end, int64_t(0), workers, std::plus<>(), square);
+                }, isReduced);
+            benchmark.Measure("Stable partition. ParallelPrimitives. Parallel", distribution, workersCount, input,
+                [&workers, &count, isOdd](Iterator begin, Iterator end) {
+                    count = ParallelPrimitives::StablePartition(begin, end, isOdd, workers) - begin;
+                }, isPartitioned);
+            benchmark.Measure("Unique. ParallelPrimitives. Parallel", distribution, workersCount, fewUnique,
+                [&workers, &count](Iterator begin, Iterator end) {
+                    count = ParallelPrimitives::Unique(begin, end, workers) - begin;
+                }, isUnique);
+            benchmark.Measure("Set union. ParallelPrimitives. Parallel", distribution, workersCount, sorted,
+                [&workers, &count, &output, &other](Iterator begin, Iterator end) {
+                    count = ParallelPrimitives::SetUnion(begin, end, other.begin(), other.end(), output.begin(), workers) - output.begin();
+                }, isUnion);
+            benchmark.Measure("Set intersection. ParallelPrimitives. Parallel", distribution, workersCount, sorted,
+                [&workers, &count, &output, &other](Iterator begin, Iterator end) {
+                    count = ParallelPrimitives::SetIntersection(begin, end, other.begin(), other.end(), output.begin(), workers)
+                        - output.begin();
+                }, isIntersection);
         }
-        LogSortings(random_v);
     }
+}
+
+/**
+\brief measures parallel quicksort with parallel partition on and off
+
+\param benchmark benchmark results are added to
+\param pools thread pools with different workers count, quicksort is measured on each of them
+\param maxSize maximal number of elements
+\note sizes from 1'000'000 to maxSize elements
+*/
+void BenchmarkParallelPartition(Benchmark& benchmark, const std::vector<std::unique_ptr<ThreadPool>>& pools, size_t maxSize) {
+    using Iterator = std::vector<int64_t>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    for (size_t size = 1'000'000; size <= maxSize; size *= 10) {
+        std::vector<int64_t> input = GenerateInput<int64_t>(Distribution::Random, size, rng);
+        for (const auto& pool : pools) {
+            ThreadPool& workers = *pool;
+            for (bool enabled : {false, true}) {
+                QuickSort<Iterator>::SetParallelPartition(enabled);
+                benchmark.Measure(std::string("QuickSort. Parallel. ") + (enabled ? "Parallel" : "Sequence") + " partition",
+                    ToString(Distribution::Random), workers.GetWorkersCount(), input, [&workers](Iterator begin, Iterator end) {
+                        QuickSort<Iterator>::SortParallel(begin, end, workers);
+                    });
+            }
+        }
+    }
+    QuickSort<Iterator>::SetParallelPartition(true);
+}
+
+/**
+\brief measures sequence sorts with different leaf sizes
+
+\param benchmark benchmark results are added to
+\param size number of elements
+\note leaf size 1 means that sorting network is not used
+*/
+void BenchmarkLeafSizes(Benchmark& benchmark, size_t size) {
+    using Iterator = std::vector<int64_t>::iterator;
+    static std::mt19937_64 rng{ std::random_device()() };
+    std::vector<int64_t> input = GenerateInput<int64_t>(Distribution::Random, size, rng);
+    std::string distribution = ToString(Distribution::Random);
+    size_t defaultLeafSize = LeafSort::GetMaxSize();
+    std::cout << "AVX2: " << (SortingNetwork::HasAvx2() ? "yes" : "no") << std::endl;
+    for (size_t leafSize : {1, 8, 16, 32, 64}) {
+        LeafSort::SetMaxSize(leafSize);
+        std::string leaf = ". Leaf size: " + std::to_string(leafSize);
+        benchmark.Measure("QuickSort. Sequence" + leaf, distribution, 1, input, [](Iterator begin, Iterator end) {
+            QuickSort<Iterator>::Sort(begin, end);
+        });
+        benchmark.Measure("MergeSort. Sequence" + leaf, distribution, 1, input, [](Iterator begin, Iterator end) {
+            MergeSort<Iterator>::Sort(begin, end);
+        });
+        benchmark.Measure("SampleSort. Sequence" + leaf, distribution, 1, input, [](Iterator begin, Iterator end) {
+            SampleSort<Iterator>::Sort(begin, end);
+        });
+    }
+    LeafSort::SetMaxSize(defaultLeafSize);
+}
+
+/**
+\brief runs external sort of file from command line
+
+\param argc number of arguments
+\param argv arguments, see ParseExternalSortOptions
+\return exit code
+*/
+int RunExternalSort(int argc, char** argv) {
+    try {
+        ExternalSortOptions options = ParseExternalSortOptions(argc, argv);
+        ExternalSortStatistics statistics = ExternalSort(options).Sort();
+        std::cout << "Sorted " << statistics.bytes / (1 << 20) << " MB: " << statistics.runs << " runs generated in "
+            << statistics.runGenerationSeconds << " s, " << statistics.mergePasses << " merge passes in "
+            << statistics.mergeSeconds << " s, " << statistics.GetThroughput() << " MB/s" << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl
+            << "usage: external-sort --input PATH --output PATH --record-size N --key-offset N [--key-size N] "
+            << "[--memory MB] [--temp DIR] [--direct]" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+\brief calibrates sortings thresholds on current machine and saves them to config file
+
+\param argc number of arguments
+\param argv arguments, see ParseCalibrationOptions
+\return exit code
+*/
+int RunCalibration(int argc, char** argv) {
+    try {
+        CalibrationOptions options = ParseCalibrationOptions(argc, argv);
+        Calibrate(options, ThreadPool::GetDefault(), std::cout);
+        SortingTuning::Save(options.outputPath);
+        std::cout << "Saved to " << options.outputPath << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl
+            << "usage: calibrate [--output PATH] [--max-size N] [--repetitions N]" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+\brief creates thread pools for thread-scaling benchmark
+
+\return pools with 1, 2, 4, ... workers up to hardware concurrency
+*/
+std::vector<std::unique_ptr<ThreadPool>> CreatePools() {
+    size_t maxWorkers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    for (size_t workers = 1; workers < maxWorkers; workers *= 2) {
+        pools.push_back(std::make_unique<ThreadPool>(workers));
+    }
+    pools.push_back(std::make_unique<ThreadPool>(maxWorkers));
+    return pools;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "external-sort") {
+        return RunExternalSort(argc - 1, argv + 1);
+    }
+    if (argc > 1 && std::string(argv[1]) == "calibrate") {
+        return RunCalibration(argc - 1, argv + 1);
+    }
+    doctest::Context context;
+    int res = context.run();
+
+    BenchmarkOptions options;
+    try {
+        options = ParseBenchmarkOptions(argc, argv);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl
+            << "usage: " << argv[0] << " [--warmups N] [--repetitions N] [--max-size N] [--csv PATH] [--json PATH] [--counters]" << std::endl;
+        return 1;
+    }
+    std::vector<size_t> sizes;
+    for (size_t size : {100, 10'000, 1'000'000, 10'000'000}) {
+        if (size <= options.maxSize) {
+            sizes.push_back(size);
+        }
+    }
+
+    auto pools = CreatePools();
+    Benchmark benchmark(options.warmups, options.repetitions, std::cout, options.counters);
+
+    std::cout << "Run sortings..." << std::endl;
+    BenchmarkSortings<int32_t>(benchmark, pools, sizes);
+    BenchmarkSortings<int64_t>(benchmark, pools, sizes);
+    BenchmarkSortings<double>(benchmark, pools, sizes);
+    BenchmarkSortings<Record<16>>(benchmark, pools, sizes);
+    BenchmarkSortings<Record<64>>(benchmark, pools, sizes);
+    BenchmarkSortings<std::string>(benchmark, pools, sizes);
+    std::cout << "Run string sortings..." << std::endl;
+    BenchmarkStringSortings(benchmark, pools, sizes);
+    std::cout << "Run sortings of wide records by key column and argsort..." << std::endl;
+    BenchmarkIndirectSorts(benchmark, pools, options.maxSize);
+    std::cout << "Run merges of sorted halves..." << std::endl;
+    BenchmarkMerges(benchmark, pools, options.maxSize);
+    std::cout << "Run multiway mergesort on large inputs..." << std::endl;
+    BenchmarkMultiwayMergeSort(benchmark, pools, options.maxSize);
+    std::cout << "Run selection..." << std::endl;
+    BenchmarkSelection(benchmark, pools, options.maxSize);
+    std::cout << "Run parallel primitives..." << std::endl;
+    BenchmarkPrimitives(benchmark, pools, options.maxSize);
+    std::cout << "Run quicksort with parallel partition on and off..." << std::endl;
+    BenchmarkParallelPartition(benchmark, pools, options.maxSize);
+    std::cout << "Run sortings with different leaf sizes..." << std::endl;
+    BenchmarkLeafSizes(benchmark, std::min<size_t>(options.maxSize, 10'000'000));
+
+    std::ofstream csv(options.csvPath);
+    benchmark.WriteCsv(csv);
+    std::ofstream json(options.jsonPath);
+    benchmark.WriteJson(json);
     std::cout << "Finished!" << std::endl;
     return 0;
 }
@@ -40,6 +40,20 @@ namespace Sortings{
             return (float)time.nsecsElapsed()/1000000;
         }
 
+        /// <summary>
+        /// The method sorts without visualization and measures the running time. Sorting is called without virtual calls and std::function.
+        /// </summary>
+        /// <returns>
+        ///  Returns the running time of sorting
+        /// </returns>
+        template<typename Compare>
+        float SortHeadless(SortingName name, typename Container::iterator begin, typename Container::iterator end, Compare cmp){
+            NoVisualization policy;
+            time.start();
+            Factory<Container>::Sort(name, begin, end, cmp, policy);
+            return (float)time.nsecsElapsed()/1000000;
+        }
+
         /// <summary>
         /// The method is used to find out the theoretical complexity of a given sort.
         /// </summary>
@@ -112,7 +112,7 @@ public:
             return SortingFactory<Container,Sortings::RadixSort<Container>>::CreateSorting(visualizer);
         }
         case Sortings::SortingName::FLASHSORT:{
-            return SortingFactory<Container,Sortings::RadixSort<Container>>::CreateSorting(visualizer);
+            return SortingFactory<Container,Sortings::FlashSort<Container>>::CreateSorting(visualizer);
         }
         case Sortings::SortingName::PANCAKESORT:{
             return SortingFactory<Container,Sortings::PancakeSort<Container>>::CreateSorting(visualizer);
@@ -131,4 +131,132 @@ public:
         }
         }
     }
+
+    /**
+    \brief sorts range without virtual calls, comparator and visualization policy are known at compile time
+
+    \param name determines type of sorting
+    \param begin first iterator in sorted range
+    \param end next after last iterator of sorted range
+    \param cmp comparator of elements
+    \param policy visualization policy, Sortings::NoVisualization for sorting without visualization
+    */
+    template<typename Compare, typename Policy>
+    static void Sort(Sortings::SortingName name, typename Container::iterator begin, typename Container::iterator end,
+                     Compare cmp, Policy& policy){
+        switch(name){
+        case Sortings::SortingName::BUBBLESORT:{
+            Sortings::BubbleSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::INSERTIONSORT:{
+            Sortings::InsertionSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::SELECTIONSORT:{
+            Sortings::SelectionSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::CYCLESORT:{
+            Sortings::CycleSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::SHAKERSORT:{
+            Sortings::ShakerSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::COMBSORT:{
+            Sortings::CombSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::GNOMESORT:{
+            Sortings::GnomeSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::ODDEVENSORT:{
+            Sortings::OddEvenSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::QUICKSORTPIVOTFIRST:{
+            Sortings::QuickSortPivotFirst<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::QUICKSORTPIVOTLAST:{
+            Sortings::QuickSortPivotLast<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::QUICKSORTPIVOTMIDDLE:{
+            Sortings::QuickSortPivotMiddle<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::QUICKSORTPIVOTRANDOM:{
+            Sortings::QuickSortPivotRandom<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::MERGESORT:{
+            Sortings::MergeSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::MERGESORTINPLACE:{
+            Sortings::MergeSortInPlace<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::HEAPSORT:{
+            Sortings::HeapSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::TIMSORT:{
+            Sortings::TimSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::INTROSORT:{
+            Sortings::IntroSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::SHELLSORT:{
+            Sortings::ShellSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::PIGEONHOLESORT:{
+            Sortings::PigeonholeSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::BUCKETSORT:{
+            Sortings::BucketSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::COUNTINGSORT:{
+            Sortings::CountingSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::RADIXSORT:{
+            Sortings::RadixSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::FLASHSORT:{
+            Sortings::FlashSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::PANCAKESORT:{
+            Sortings::PancakeSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::BOGOSORT:{
+            Sortings::BogoSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::STOOGESORT:{
+            Sortings::StoogeSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::SLOWSORT:{
+            Sortings::SlowSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        case Sortings::SortingName::TREESORT:{
+            Sortings::TreeSort<Container>::Sort(begin, end, cmp, policy);
+            break;
+        }
+        }
+    }
 };
@@ -6,6 +6,7 @@
 #pragma once
 
 #include <type_traits>
+#include <cstdint>
 #include <iterator>
 #include <algorithm>
 #include <functional>
@@ -95,10 +96,175 @@ namespace Sortings{
         }
     };
 
+    /**
+    \brief visualization policy that does nothing
+
+    \note sortings with this policy compile to plain algorithms, without any calls or branches per operation
+    */
+    class NoVisualization{
+    public:
+        template<typename Iterator>
+        constexpr bool Visualize(Operation, Iterator) const{
+            return true;
+        }
+
+        template<typename Iterator>
+        constexpr bool Visualize(Operation, Iterator, Iterator) const{
+            return true;
+        }
+    };
+
+    /**
+    \brief visualization policy that counts operations
+
+    \note comparison is counted once, access and change are counted for every given iterator, as Visualizer shows them
+    */
+    class CountingVisualization{
+    public:
+        template<typename Iterator>
+        bool Visualize(Operation operation, Iterator){
+            Count(operation, 1);
+            return true;
+        }
+
+        template<typename Iterator>
+        bool Visualize(Operation operation, Iterator, Iterator){
+            Count(operation, 2);
+            return true;
+        }
+
+        /**
+        \brief comparisons counter getter
+
+        \return number of comparisons
+        */
+        size_t GetComparisons() const{
+            return m_Comparisons;
+        }
+
+        /**
+        \brief accesses counter getter
+
+        \return number of accessed elements
+        */
+        size_t GetAccesses() const{
+            return m_Accesses;
+        }
+
+        /**
+        \brief changes counter getter
+
+        \return number of changed elements
+        */
+        size_t GetChanges() const{
+            return m_Changes;
+        }
+
+    private:
+        void Count(Operation operation, size_t elements){
+            if(operation == Operation::COMPARISON){
+                m_Comparisons++;
+            }
+            else if(operation == Operation::ACCESS){
+                m_Accesses += elements;
+            }
+            else if(operation == Operation::CHANGE){
+                m_Changes += elements;
+            }
+        }
+
+        size_t m_Comparisons = 0;
+        size_t m_Accesses = 0;
+        size_t m_Changes = 0;
+    };
+
+    /**
+    \brief visualization policy that records operations as positions in sorted range
+    */
+    template<typename Iterator>
+    class RecordingVisualization{
+    public:
+        /**
+        \brief recorded operation
+        */
+        struct Event{
+            Operation operation;
+            size_t first;
+            size_t second;      ///<NoPosition if operation has one iterator
+
+            bool operator==(const Event& other) const{
+                return operation == other.operation && first == other.first && second == other.second;
+            }
+        };
+
+        static constexpr size_t NoPosition = SIZE_MAX;
+
+        /**
+        \brief constructs
+
+        \param origin iterator positions are counted from
+        */
+        RecordingVisualization(Iterator origin):
+            m_Origin(origin) {}
+
+        bool Visualize(Operation operation, Iterator first){
+            m_Events.push_back({operation, size_t(first - m_Origin), NoPosition});
+            return true;
+        }
+
+        bool Visualize(Operation operation, Iterator first, Iterator second){
+            m_Events.push_back({operation, size_t(first - m_Origin), size_t(second - m_Origin)});
+            return true;
+        }
+
+        /**
+        \brief recorded events getter
+
+        \return events in order of operations
+        */
+        const std::vector<Event>& GetEvents() const{
+            return m_Events;
+        }
+
+    private:
+        Iterator m_Origin;
+        std::vector<Event> m_Events;
+    };
+
+    /**
+    \brief visualization policy that passes operations to DefaultVisualizer
+
+    \note used by virtual Sort methods, so algorithms are written once for both dynamic and static visualization
+    */
+    template<typename Container>
+    class DynamicVisualization{
+    public:
+        /**
+        \brief constructs
+
+        \param visualizer pointer on visualizer, operations are skipped if it's nullptr
+        */
+        DynamicVisualization(DefaultVisualizer<Container>* visualizer):
+            m_Visualizer(visualizer) {}
+
+        bool Visualize(Operation operation, typename Container::iterator first){
+            return m_Visualizer ? m_Visualizer->Visualize(operation, first) : true;
+        }
+
+        bool Visualize(Operation operation, typename Container::iterator first, typename Container::iterator second){
+            return m_Visualizer ? m_Visualizer->Visualize(operation, first, second) : true;
+        }
+
+    private:
+        DefaultVisualizer<Container>* m_Visualizer;
+    };
+
     /**
     \brief basic class of sorting
 
     pure virtual class
+    \note every sorting also has static template Sort(begin, end, cmp, policy) with comparator
+    and visualization policy known at compile time, virtual Sort is a thin adapter over it
     */
     template<
         typename Container,
@@ -112,6 +278,8 @@ namespace Sortings{
         Sorting(DefaultVisualizer<Container>* visualizer = nullptr):
             visualizer(visualizer) {}
 
+        virtual ~Sorting() = default;
+
         /**
         \brief sets visualizer
 
@@ -168,13 +336,18 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             for (Iterator i = begin; i < end-1; i++){
                 for (Iterator j = begin; j < end-i+begin-1; j++){
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, j, j+1);
+                    policy.Visualize(Operation::COMPARISON, j, j+1);
                     if (cmp(*(j + 1), *j)){
                         std::swap(*j, *(j + 1));
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, j, j+1);
+                        policy.Visualize(Operation::CHANGE, j, j+1);
                     }
                 }
             }
@@ -200,24 +373,25 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
             for ( Iterator i = begin+1; i < end; i++) {
                 Iterator j= i;
-                this->visualizer->Visualize(Operation::ACCESS, i);
+                policy.Visualize(Operation::ACCESS, i);
                 ValueType key = *i;
-                while (j > begin && (this->visualizer != nullptr ?
-                       this->visualizer->Visualize(Operation::COMPARISON, j-1) :true) &&
-                       cmp(key,*(j-1))) {
+                while (j > begin && policy.Visualize(Operation::COMPARISON, j-1) && cmp(key,*(j-1))) {
                     *j = *(j-1);
-                    if(this->visualizer) {
-                        this->visualizer->Visualize(Operation::CHANGE, j);
-                        this->visualizer->Visualize(Operation::ACCESS, j-1);
-                    }
+                    policy.Visualize(Operation::CHANGE, j);
+                    policy.Visualize(Operation::ACCESS, j-1);
                     j--;
                 }
                 *j = key;
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, j);
+                policy.Visualize(Operation::CHANGE, j);
             }
         }
     };
@@ -238,11 +412,15 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
-            auto vis = this->visualizer;
-            auto comp = [cmp, vis] (Iterator l, Iterator r){
-                if(vis) vis->Visualize(Operation::COMPARISON, l, r);
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
+            auto comp = [&cmp, &policy] (Iterator l, Iterator r){
+                policy.Visualize(Operation::COMPARISON, l, r);
                 return cmp(*l, *r);
             };
             std::multiset<Iterator, decltype(comp)> tree(comp);
@@ -252,12 +430,12 @@ namespace Sortings{
             std::vector<ValueType> v;
             v.reserve(tree.size());
             for(auto i=tree.begin(); i != tree.end(); i++){
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, *i);
+                policy.Visualize(Operation::ACCESS, *i);
                 v.push_back(**i);
             }
             for(auto i = begin; i < end; i++){
                 *i = v[i-begin];
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i);
+                policy.Visualize(Operation::CHANGE, i);
             }
         }
     };
@@ -281,26 +459,29 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             for (Iterator i = begin; i < end-1; i++) {
                 Iterator min = i;
                 for (Iterator j = i + 1; j < end; j++)
                 {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, j, min);
+                    policy.Visualize(Operation::COMPARISON, j, min);
                     if (cmp(*j, *min))
                     {
                         min = j;
-                        if(this->visualizer){
-                            this->visualizer->Visualize(Operation::ACCESS, j);
-                            this->visualizer->Visualize(Operation::CHANGE, min);
-                        }
+                        policy.Visualize(Operation::ACCESS, j);
+                        policy.Visualize(Operation::CHANGE, min);
                     }
                 }
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, min);
+                policy.Visualize(Operation::COMPARISON, i, min);
                 if (min != i)
                 {
                     std::swap(*i, *min);
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i, min);
+                    policy.Visualize(Operation::CHANGE, i, min);
                 }
             }
         }
@@ -325,15 +506,20 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
             for( Iterator i = begin; i < end - 1; i++ )
             {
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+                policy.Visualize(Operation::ACCESS, i);
                 ValueType cur = *i;
                 size_t pos = i-begin;
                 for( Iterator j = i + 1; j < end; j++ ){
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, j);
+                    policy.Visualize(Operation::COMPARISON, j);
                     if( cmp(*j,cur)){
                         pos++;
                     }
@@ -341,24 +527,24 @@ namespace Sortings{
                 if( i-begin == pos ){
                     continue;
                 }
-                while((this->visualizer ? this->visualizer->Visualize(Operation::COMPARISON, begin+pos) : true) && *(begin+pos) == cur){
+                while(policy.Visualize(Operation::COMPARISON, begin+pos) && *(begin+pos) == cur){
                     pos++;
                 }
                 std::swap( cur, *(begin+pos));
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin+pos);
+                policy.Visualize(Operation::CHANGE, begin+pos);
                 while( i-begin != pos ){
                     pos = i-begin;
                     for( Iterator j = i + 1; j < end; j++ ){
-                        if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, j);
+                        policy.Visualize(Operation::COMPARISON, j);
                         if( cmp(*j, cur)) {
                             pos++;
                         }
                     }
-                    while((this->visualizer ? this->visualizer->Visualize(Operation::COMPARISON, begin+pos) : true) && *(begin+pos) == cur){
+                    while(policy.Visualize(Operation::COMPARISON, begin+pos) && *(begin+pos) == cur){
                         pos++;
                     }
                     std::swap( cur, *(begin+pos) );
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin+pos);
+                    policy.Visualize(Operation::CHANGE, begin+pos);
                 }
             }
         }
@@ -383,25 +569,30 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             size_t border=end-begin;
             Iterator left = begin;
             Iterator right = end - 1;
             do {
                 for (Iterator i = left; i < right; i++) {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i+1, i);
+                    policy.Visualize(Operation::COMPARISON, i+1, i);
                     if (cmp(*(i+1), *i)) {
                         std::swap(*i, *(i+1));
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i+1, i);
+                        policy.Visualize(Operation::CHANGE, i+1, i);
                         border=i-begin;
                     }
                 }
                 right=begin+border;
                 for (Iterator i = right; i > left; i--) {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i-1, i);
+                    policy.Visualize(Operation::COMPARISON, i-1, i);
                     if (cmp(*i, *(i-1))) {
                         std::swap(*i, *(i-1));
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i-1, i);
+                        policy.Visualize(Operation::CHANGE, i-1, i);
                         border=i-begin;
                     }
                 }
@@ -429,7 +620,12 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             const double factor = 1.2473309;
             size_t step = end-begin;
             bool swapped = true;
@@ -439,10 +635,10 @@ namespace Sortings{
                 }
                 swapped = false;
                 for (Iterator i = begin; i + step < end; i++) {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i+step, i);
+                    policy.Visualize(Operation::COMPARISON, i+step, i);
                     if (cmp(*(i+step),*i)) {
                         std::swap(*i, *(i + step));
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i, i+step);
+                        policy.Visualize(Operation::CHANGE, i, i+step);
                         swapped = true;
                     }
                 }
@@ -469,18 +665,23 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             Iterator i = begin+1;
             Iterator j = begin+2;
             while(i < end){
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i-1, i);
+                policy.Visualize(Operation::COMPARISON, i-1, i);
                 if(cmp(*(i-1), *i)){
                     i = j;
                     j = j < end ? j+1 : j;
                 }
                 else{
                     std::swap(*(i-1), *i);
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i-1, i);
+                    policy.Visualize(Operation::CHANGE, i-1, i);
                     i--;
                     if(i==begin){
                         i = j;
@@ -510,12 +711,18 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             for (size_t i = 0; i < end-begin; i++) {
                 for (size_t j = (i % 2) ? 0 : 1; j + 1 < end-begin; j += 2) {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, begin+j+1, begin+j);
+                    policy.Visualize(Operation::COMPARISON, begin+j+1, begin+j);
                     if (cmp(*(begin+j+1), *(begin+j))) {
                         std::swap(*(begin+j+1), *(begin+j));
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin+j+1, begin+j);
+                        policy.Visualize(Operation::CHANGE, begin+j+1, begin+j);
                     }
                 }
             }
@@ -543,11 +750,28 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy, [this](typename Container::iterator first, typename Container::iterator last){
+                return ChoosePivot(first, last);
+            });
+        }
+
+        /**
+        \brief sorts given range with static comparator and visualization policy
+
+        \param begin first iterator in sorted range
+        \param end next after last iterator of sorted range
+        \param cmp comparator of elements
+        \param policy visualization policy
+        \param choosePivot function that takes range and returns iterator on pivot element
+        */
+        template<typename Iterator, typename Compare, typename Policy, typename ChoosePivotFunction>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy, const ChoosePivotFunction& choosePivot){
             if (end - begin > 1){
-                auto pivot = ChoosePivot(begin, end);
-                auto p = Partition(begin, end, pivot, cmp);
-                Sort(begin, p, cmp);
-                Sort(p+1, end, cmp);
+                auto pivot = choosePivot(begin, end);
+                auto p = Partition(begin, end, pivot, cmp, policy);
+                Sort(begin, p, cmp, policy, choosePivot);
+                Sort(p+1, end, cmp, policy, choosePivot);
             }
         }
 
@@ -575,25 +799,30 @@ namespace Sortings{
                           std::function<bool (
                           typename std::iterator_traits<typename Container::iterator>::value_type,
                           typename std::iterator_traits<typename Container::iterator>::value_type)> cmp){
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            return Partition(begin, end, pivot, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static Iterator Partition(Iterator begin, Iterator end, Iterator pivot, Compare cmp, Policy& policy){
             Iterator left = begin, right = end;
             std::swap(*pivot, *begin);
-            if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin, pivot);
+            policy.Visualize(Operation::CHANGE, begin, pivot);
             while(true){
                 while(cmp(*(++left), *begin)){
                   if ( left == end-1) break;
-                  if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, left, begin);
+                  policy.Visualize(Operation::COMPARISON, left, begin);
                 }
                 while (cmp(*begin, *(--right))){
                   if ( right == begin ) break;
-                  if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, right, begin);
+                  policy.Visualize(Operation::COMPARISON, right, begin);
                 }
                 if (left >= right) break;
                 std::swap(*left,*right);
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, left, right);
+                policy.Visualize(Operation::CHANGE, left, right);
             }
             std::swap(*begin,*right);
-            if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, pivot, right);
+            policy.Visualize(Operation::CHANGE, pivot, right);
             return right;
         }
     };
@@ -613,6 +842,15 @@ namespace Sortings{
         QuickSortPivotFirst(Visualizer* visualizer = nullptr):
             AbstractQuickSort<Container, Visualizer>(visualizer) {}
 
+        using AbstractQuickSort<Container, Visualizer>::Sort;
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            AbstractQuickSort<Container, Visualizer>::Sort(begin, end, cmp, policy, [&policy](Iterator first, Iterator last){
+                return ChoosePivot(first, last, policy);
+            });
+        }
+
         /**
         \brief overrided method that chooses pivot
 
@@ -621,7 +859,13 @@ namespace Sortings{
         \return begin
         */
         virtual typename Container::iterator ChoosePivot(typename Container::iterator begin, typename Container::iterator end) override {
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin);
+            DynamicVisualization<Container> policy(this->visualizer);
+            return ChoosePivot(begin, end, policy);
+        }
+
+        template<typename Iterator, typename Policy>
+        static Iterator ChoosePivot(Iterator begin, Iterator end, Policy& policy){
+            policy.Visualize(Operation::ACCESS, begin);
             return begin;
         }
     };
@@ -642,6 +886,17 @@ namespace Sortings{
             AbstractQuickSort<Container, Visualizer>(visualizer),
             mersenne(rd()) {}
 
+        using AbstractQuickSort<Container, Visualizer>::Sort;
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            std::random_device rd;
+            std::mt19937 mersenne(rd());
+            AbstractQuickSort<Container, Visualizer>::Sort(begin, end, cmp, policy, [&policy, &mersenne](Iterator first, Iterator last){
+                return ChoosePivot(first, last, policy, mersenne);
+            });
+        }
+
         /**
         \brief overrided method that chooses pivot
 
@@ -650,8 +905,14 @@ namespace Sortings{
         \return random iterator from the rabge [begin, end)
         */
         virtual typename Container::iterator ChoosePivot(typename Container::iterator begin, typename Container::iterator end) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            return ChoosePivot(begin, end, policy, mersenne);
+        }
+
+        template<typename Iterator, typename Policy>
+        static Iterator ChoosePivot(Iterator begin, Iterator end, Policy& policy, std::mt19937& mersenne){
             size_t pivot = mersenne()%(end-begin);
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin+pivot);
+            policy.Visualize(Operation::ACCESS, begin+pivot);
             return begin + pivot;
         }
 
@@ -675,6 +936,15 @@ namespace Sortings{
         QuickSortPivotLast(Visualizer* visualizer = nullptr):
             AbstractQuickSort<Container, Visualizer>(visualizer) {}
 
+        using AbstractQuickSort<Container, Visualizer>::Sort;
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            AbstractQuickSort<Container, Visualizer>::Sort(begin, end, cmp, policy, [&policy](Iterator first, Iterator last){
+                return ChoosePivot(first, last, policy);
+            });
+        }
+
         /**
         \brief overrided method that chooses pivot
 
@@ -683,7 +953,13 @@ namespace Sortings{
         \return end-1
         */
         virtual typename Container::iterator ChoosePivot(typename Container::iterator begin, typename Container::iterator end) override {
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, end-1);
+            DynamicVisualization<Container> policy(this->visualizer);
+            return ChoosePivot(begin, end, policy);
+        }
+
+        template<typename Iterator, typename Policy>
+        static Iterator ChoosePivot(Iterator begin, Iterator end, Policy& policy){
+            policy.Visualize(Operation::ACCESS, end-1);
             return end-1;
         }
     };
@@ -703,6 +979,15 @@ namespace Sortings{
         QuickSortPivotMiddle(Visualizer* visualizer = nullptr):
             AbstractQuickSort<Container, Visualizer>(visualizer) {}
 
+        using AbstractQuickSort<Container, Visualizer>::Sort;
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            AbstractQuickSort<Container, Visualizer>::Sort(begin, end, cmp, policy, [&policy](Iterator first, Iterator last){
+                return ChoosePivot(first, last, policy);
+            });
+        }
+
         /**
         \brief overrided method that chooses pivot
 
@@ -711,7 +996,13 @@ namespace Sortings{
         \return middle iterator in range [begin, end)
         */
         virtual typename Container::iterator ChoosePivot(typename Container::iterator begin, typename Container::iterator end) override {
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin + (end-begin)/2);
+            DynamicVisualization<Container> policy(this->visualizer);
+            return ChoosePivot(begin, end, policy);
+        }
+
+        template<typename Iterator, typename Policy>
+        static Iterator ChoosePivot(Iterator begin, Iterator end, Policy& policy){
+            policy.Visualize(Operation::ACCESS, begin + (end-begin)/2);
             return begin + (end-begin)/2;
         }
     };
@@ -737,12 +1028,26 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            SortByMerges(begin, end, [this, &cmp](typename Container::iterator first, typename Container::iterator middle,
+                         typename Container::iterator last){
+                Merge(first, middle, last, cmp);
+            });
+        }
+
+        /**
+        \brief sorts given range by merges of sorted halves
+
+        \param begin first iterator in sorted range
+        \param end next after last iterator of sorted range
+        \param merge function that takes begin, middle and end iterators and merges two sorted parts
+        */
+        template<typename Iterator, typename MergeFunction>
+        static void SortByMerges(Iterator begin, Iterator end, const MergeFunction& merge){
             if (begin < end-1) {
                 Iterator middle = begin + (end - begin) / 2;
-                Sort(begin , middle, cmp);
-                Sort(middle, end, cmp);
-                Merge(begin, middle, end, cmp);
+                SortByMerges(begin , middle, merge);
+                SortByMerges(middle, end, merge);
+                merge(begin, middle, end);
             }
         }
 
@@ -777,6 +1082,15 @@ namespace Sortings{
         MergeSort(Visualizer* visualizer = nullptr):
             AbstractMergeSort<Container, Visualizer>(visualizer) {}
 
+        using AbstractMergeSort<Container, Visualizer>::Sort;
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            AbstractMergeSort<Container, Visualizer>::SortByMerges(begin, end, [&cmp, &policy](Iterator first, Iterator middle, Iterator last){
+                Merge(first, middle, last, cmp, policy);
+            });
+        }
+
         /**
         \brief overrided merge method
         */
@@ -785,19 +1099,27 @@ namespace Sortings{
                   std::function<bool (
                   typename std::iterator_traits<typename Container::iterator>::value_type,
                   typename std::iterator_traits<typename Container::iterator>::value_type)> cmp) override {
-            using Iterator = typename Container::iterator;
-            Container left(middle - begin);
-            Container right(end - middle);
-            for(Iterator i = begin, k=left.begin(); i<middle; i++, k++){
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+            DynamicVisualization<Container> policy(this->visualizer);
+            Merge(begin, middle, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Merge(Iterator begin, Iterator middle, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
+            std::vector<ValueType> left(middle - begin);
+            std::vector<ValueType> right(end - middle);
+            auto k = left.begin();
+            for(Iterator i = begin; i<middle; i++, k++){
+                policy.Visualize(Operation::ACCESS, i);
                 *k = *i;
             }
-            for(Iterator i = middle, k=right.begin(); i<end; i++, k++){
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+            k = right.begin();
+            for(Iterator i = middle; i<end; i++, k++){
+                policy.Visualize(Operation::ACCESS, i);
                 *k = *i;
             }
-            Iterator i = left.begin();
-            Iterator j = right.begin();
+            auto i = left.begin();
+            auto j = right.begin();
             Iterator current = begin;
             while (i < left.end() && j < right.end()) {
                 if (cmp(*i, *j)) {
@@ -807,16 +1129,16 @@ namespace Sortings{
                     *current = *j;
                     j++;
                 }
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, current);
+                policy.Visualize(Operation::CHANGE, current);
                 current++;
             }
             for(; i<left.end(); i++, current++){
                 *current = *i;
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, current);
+                policy.Visualize(Operation::CHANGE, current);
             }
             for(; j<right.end(); j++, current++){
                 *current = *j;
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, current);
+                policy.Visualize(Operation::CHANGE, current);
             }
         }
     };
@@ -836,6 +1158,15 @@ namespace Sortings{
         MergeSortInPlace(Visualizer* visualizer = nullptr):
             AbstractMergeSort<Container, Visualizer>(visualizer) {}
 
+        using AbstractMergeSort<Container, Visualizer>::Sort;
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            AbstractMergeSort<Container, Visualizer>::SortByMerges(begin, end, [&cmp, &policy](Iterator first, Iterator middle, Iterator last){
+                Merge(first, middle, last, cmp, policy);
+            });
+        }
+
         /**
         \brief overrided merge method
         */
@@ -844,23 +1175,28 @@ namespace Sortings{
                   std::function<bool (
                   typename std::iterator_traits<typename Container::iterator>::value_type,
                   typename std::iterator_traits<typename Container::iterator>::value_type)> cmp) override {
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Merge(begin, middle, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Merge(Iterator begin, Iterator middle, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
             Iterator begin2 = middle;
             while (begin < middle && begin2 < end) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, begin2, begin);
+                policy.Visualize(Operation::COMPARISON, begin2, begin);
                 if (cmp(*begin2, *begin)) {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin2);
+                    policy.Visualize(Operation::ACCESS, begin2);
                     ValueType value = *begin2;
                     Iterator cur = begin2;
                     while (cur != begin) {
-                        if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, cur-1);
+                        policy.Visualize(Operation::ACCESS, cur-1);
                         *cur = *(cur - 1);
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, cur);
+                        policy.Visualize(Operation::CHANGE, cur);
                         cur--;
                     }
                     *begin = value;
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin);
+                    policy.Visualize(Operation::CHANGE, begin);
                     middle++;
                     begin2++;
                 }
@@ -888,46 +1224,41 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             for (Iterator i = begin + (end-begin) / 2 - 1; i >= begin; i--){
-                Heapify(begin, end, i, cmp);
+                Heapify(begin, end, i, cmp, policy);
             }
             for (Iterator i=end-1; i>=begin; i--)
             {
                 std::swap(*begin, *i);
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i, begin);
-                Heapify(begin, i, begin, cmp);
+                policy.Visualize(Operation::CHANGE, i, begin);
+                Heapify(begin, i, begin, cmp, policy);
             }
         }
 
     private:
-        void Heapify(typename Container::iterator begin, typename Container::iterator end,
-                     typename Container::iterator cur,
-                     std::function<bool (
-                     typename std::iterator_traits<typename Container::iterator>::value_type,
-                     typename std::iterator_traits<typename Container::iterator>::value_type)> cmp)
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Heapify(Iterator begin, Iterator end, Iterator cur, Compare& cmp, Policy& policy)
         {
-            using Iterator = typename Container::iterator;
             Iterator largest = cur;
             Iterator left = begin+2*(cur-begin) + 1;
             Iterator right = begin+2*(cur-begin) + 2;
-            if (left < end &&
-                (this->visualizer ?
-                 this->visualizer->Visualize(Operation::COMPARISON, left, largest) : true)
-                    && !cmp(*left, *largest)){
+            if (left < end && policy.Visualize(Operation::COMPARISON, left, largest) && !cmp(*left, *largest)){
                 largest = left;
             }
-            if (right < end &&
-               (this->visualizer ?
-                this->visualizer->Visualize(Operation::COMPARISON, right, largest) : true)
-                && !cmp(*right, *largest)){
+            if (right < end && policy.Visualize(Operation::COMPARISON, right, largest) && !cmp(*right, *largest)){
                 largest = right;
             }
             if (largest != cur)
             {
                 std::swap(*cur, *largest);
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, cur, largest);
-                Heapify(begin, end, largest, cmp);
+                policy.Visualize(Operation::CHANGE, cur, largest);
+                Heapify(begin, end, largest, cmp, policy);
             }
         }
     };
@@ -953,19 +1284,22 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             const int RUN = 32;
-            InsertionSort<Container> insertionSort(this->visualizer);
-            MergeSort<Container> mergeSort(this->visualizer);
             for (Iterator i = begin; i < end; i+=RUN){
-                insertionSort.Sort(i, std::min(i+RUN, end), cmp);
+                InsertionSort<Container>::Sort(i, std::min(i+RUN, end), cmp, policy);
             }
             for (int size = RUN; size < end-begin; size *= 2) {
                 for (Iterator left = begin; left < end; left += 2*size) {
                     Iterator middle = left + size;
                     Iterator right = std::min(left + 2*size, end);
                     if(middle < right){
-                        mergeSort.Merge(left, middle, right, cmp);
+                        MergeSort<Container>::Merge(left, middle, right, cmp, policy);
                     }
                 }
             }
@@ -984,8 +1318,7 @@ namespace Sortings{
     class IntroSort : public Sorting<Container>{
     public:
         IntroSort(Visualizer* visualizer = nullptr):
-            Sorting<Container>(visualizer),
-            m_HeapSort(visualizer) {}
+            Sorting<Container>(visualizer) {}
 
         void Sort(typename Container::iterator begin, typename Container::iterator end,
                   std::function<bool (
@@ -994,38 +1327,36 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             if(end - begin > 32){
                 Iterator left  = begin;
                 Iterator right = end;
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, left);
+                policy.Visualize(Operation::ACCESS, left);
                 Iterator pivot = left++;
                 while( left != right ) {
-                  if( (this->visualizer ? this->visualizer->Visualize(Operation::COMPARISON, left) : true) && cmp( *left, *pivot ) ) {
+                  if( policy.Visualize(Operation::COMPARISON, left) && cmp( *left, *pivot ) ) {
                      ++left;
                   } else {
-                     while( left != --right &&
-                            (this->visualizer ?
-                             this->visualizer->Visualize(Operation::COMPARISON, right)
-                             : true) && cmp( *pivot, *right ) );
+                     while( left != --right && policy.Visualize(Operation::COMPARISON, right) && cmp( *pivot, *right ) );
                      std::swap( *left, *right );
-                     if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, left, right);
+                     policy.Visualize(Operation::CHANGE, left, right);
                   }
                 }
                 --left;
                 std::swap( *begin, *left );
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, left, begin);
-                Sort( begin, left, cmp );
-                Sort( right, end, cmp );
+                policy.Visualize(Operation::CHANGE, left, begin);
+                Sort( begin, left, cmp, policy );
+                Sort( right, end, cmp, policy );
             }
             else{
-                m_HeapSort.SetVisualizer(this->visualizer);
-                m_HeapSort.Sort(begin, end, cmp);
+                HeapSort<Container>::Sort(begin, end, cmp, policy);
             }
         }
-
-    private:
-        HeapSort<Container> m_HeapSort;
     };
 
     /**
@@ -1047,24 +1378,28 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
             for (size_t gap = (end-begin)/2; gap > 0; gap /= 2){
                 {
                     for (size_t i = gap; i < end-begin; i++)
                     {
-                        if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin+i);
+                        policy.Visualize(Operation::ACCESS, begin+i);
                         ValueType temp = *(begin+i);
                         size_t j;
-                        for (j = i; j >= gap &&
-                             (this->visualizer != nullptr ?
-                                                    this->visualizer->Visualize(Operation::COMPARISON, begin + j - gap) :true)
+                        for (j = i; j >= gap && policy.Visualize(Operation::COMPARISON, begin + j - gap)
                              && !cmp(*(begin + j - gap), temp); j -= gap){
-                            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin + j - gap);
+                            policy.Visualize(Operation::ACCESS, begin + j - gap);
                             *(begin + j) = *(begin + j - gap);
-                            if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin+j);
+                            policy.Visualize(Operation::CHANGE, begin+j);
                         }
                         *(begin + j) = temp;
-                        if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin+j);
+                        policy.Visualize(Operation::CHANGE, begin+j);
                     }
                 }
             }
@@ -1092,21 +1427,26 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin);
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
+            policy.Visualize(Operation::ACCESS, begin);
             Iterator min = begin;
             Iterator max = begin;
             for (Iterator i = begin+1; i < end; i++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, min);
+                policy.Visualize(Operation::COMPARISON, i, min);
                 if (*i < *min) min = i;
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, max);
+                policy.Visualize(Operation::COMPARISON, i, max);
                 if (*max < *i) max = i;
             }
             size_t range = (*max > *min ? *max - *min : *min - *max) + 1;
             std::vector<ValueType>holes[range];
             for (Iterator i = begin; i < end; i++){
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i, min);
+                policy.Visualize(Operation::ACCESS, i, min);
                 if(*max > *min){
                     holes[*i - *min].push_back(*i);
                 }
@@ -1118,7 +1458,7 @@ namespace Sortings{
             for (auto& hole:holes) {
                 for (auto& item:hole){
                     *cur = item;
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, cur);
+                    policy.Visualize(Operation::CHANGE, cur);
                     cur++;
                 }
             }
@@ -1138,8 +1478,7 @@ namespace Sortings{
     class BucketSort : public Sorting<Container>{
     public:
         BucketSort(Visualizer* visualizer = nullptr):
-            Sorting<Container>(visualizer),
-            m_InsertionSort(visualizer) {}
+            Sorting<Container>(visualizer) {}
 
         void Sort(typename Container::iterator begin, typename Container::iterator end,
                   std::function<bool (
@@ -1148,28 +1487,32 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
 
             if(end - begin < 11){
-                m_InsertionSort.SetVisualizer(this->visualizer);
-                m_InsertionSort.Sort(begin, end, cmp);
+                InsertionSort<Container>::Sort(begin, end, cmp, policy);
                 return;
             }
 
             Iterator min = begin;
             Iterator max = begin;
             for (Iterator i = begin+1; i < end; i++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, min);
+                policy.Visualize(Operation::COMPARISON, i, min);
                 if (*i < *min) min = i;
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, max);
+                policy.Visualize(Operation::COMPARISON, i, max);
                 if (*max < *i) max = i;
             }
 
             std::vector<ValueType>buckets[end - begin + 1];
 
             for (Iterator i = begin; i < end; i++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i, max);
+                policy.Visualize(Operation::ACCESS, i, max);
                 size_t bi = double(*i) / *max * (end-begin);
                 buckets[bi].push_back(*i);
             }
@@ -1178,7 +1521,7 @@ namespace Sortings{
             for (std::vector<ValueType>& bucket: buckets){
                 for (ValueType& item: bucket){
                     *cur = item;
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, cur);
+                    policy.Visualize(Operation::CHANGE, cur);
                     cur++;
                 }
             }
@@ -1186,13 +1529,10 @@ namespace Sortings{
             cur = begin;
 
             for (const auto& bucket:buckets){
-                Sort(cur, cur+bucket.size());
+                Sort(cur, cur+bucket.size(), cmp, policy);
                 cur+=bucket.size();
             }
         }
-
-    private:
-        InsertionSort<Container>m_InsertionSort;
     };
 
     /**
@@ -1216,18 +1556,24 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
 
             Iterator max = begin;
             for (Iterator i = begin+1; i < end; i++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, max);
+                policy.Visualize(Operation::COMPARISON, i, max);
                 if (*max < *i) max = i;
             }
 
             std::vector<int>count(*max + 1, 0);
 
             for (Iterator i = begin; i < end; i++){
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+                policy.Visualize(Operation::ACCESS, i);
                 count[*i]++;
             }
 
@@ -1235,17 +1581,18 @@ namespace Sortings{
                 count[i] += count[i - 1];
             }
 
-            Container answer(end-begin);
+            std::vector<ValueType> answer(end-begin);
 
             for (Iterator i = begin; i < end; i++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+                policy.Visualize(Operation::ACCESS, i);
                 answer[count[*i] - 1] = *i;
                 count[*i]--;
             }
 
-            for(Iterator cur = begin, a = answer.begin(); cur < end; cur++, a++){
+            auto a = answer.begin();
+            for(Iterator cur = begin; cur < end; cur++, a++){
                 *cur = *a;
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, cur);
+                policy.Visualize(Operation::CHANGE, cur);
             }
         }
     };
@@ -1271,17 +1618,22 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare, Policy& policy){
             if(begin > end-2){
                 return;
             }
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
             int m, p = 1;
             ValueType max = *begin;
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin);
+            policy.Visualize(Operation::ACCESS, begin);
             for(Iterator i = begin+1; i < end; i++){
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i);
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+                policy.Visualize(Operation::COMPARISON, i);
+                policy.Visualize(Operation::ACCESS, i);
                 if(max < *i){
                     max = *i;
                 }
@@ -1298,7 +1650,7 @@ namespace Sortings{
                m = std::pow(10, i+1);
                p = pow(10, i);
                for(Iterator j = begin; j<end; j++) {
-                   if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, j);
+                   policy.Visualize(Operation::ACCESS, j);
                    ValueType temp = *j%m;
                    size_t index = temp/p;
                    pocket[index].push_back(*j);
@@ -1307,7 +1659,7 @@ namespace Sortings{
                for(size_t j = 0; j<10; j++) {
                   while(!pocket[j].empty()) {
                       *current = *(pocket[j].begin());
-                      if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, current);
+                      policy.Visualize(Operation::CHANGE, current);
                       pocket[j].erase(pocket[j].begin());
                       current++;
                   }
@@ -1329,8 +1681,7 @@ namespace Sortings{
     class FlashSort : public Sorting<Container>{
     public:
         FlashSort(Visualizer* visualizer = nullptr):
-            Sorting<Container>(visualizer),
-            m_InsertionSort(visualizer) {}
+            Sorting<Container>(visualizer) {}
 
         void Sort(typename Container::iterator begin, typename Container::iterator end,
                   std::function<bool (
@@ -1339,28 +1690,32 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
 
-            using Iterator = typename Container::iterator;
-            using ValueType = typename std::iterator_traits<typename Container::iterator>::value_type;
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            using ValueType = typename std::iterator_traits<Iterator>::value_type;
 
             if(begin > end-2){
                 return;
             }
 
-            if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin);
+            policy.Visualize(Operation::ACCESS, begin);
             ValueType min = *begin;
             ValueType max = *begin;
             Iterator maxIt = begin;
 
             for(Iterator i = begin+1; i < end; i++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i);
+                policy.Visualize(Operation::COMPARISON, i);
                 if(*i > max) {
-                    if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+                    policy.Visualize(Operation::ACCESS, i);
                     max = *i;
                     maxIt = i;
                 }
                 if(*i < min){
-                    if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, i);
+                    policy.Visualize(Operation::ACCESS, i);
                     min = *i;
                 }
             }
@@ -1374,7 +1729,7 @@ namespace Sortings{
             double c = (m-1.0)/(max-min);
             size_t K;
             for(Iterator h=begin; h < end; h++) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, h);
+                policy.Visualize(Operation::ACCESS, h);
                 K = ((int)(((*h)-min)*c))+1;
                 L[K]++;
             }
@@ -1384,7 +1739,7 @@ namespace Sortings{
             }
 
             std::swap(*maxIt, *begin);
-            if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, maxIt, begin);
+            policy.Visualize(Operation::CHANGE, maxIt, begin);
 
             int j = 0;
             K = m;
@@ -1393,20 +1748,20 @@ namespace Sortings{
             while(movesCounter < end-begin) {
                 while(j >= L[K]) {
                     j++;
-                    if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, begin+j);
+                    policy.Visualize(Operation::ACCESS, begin+j);
                     K = ((int)((*(begin+j) - min) * c)) + 1;
                 }
 
                 Iterator evicted = begin+j;
 
                 while(j < L[K])	{
-                    if(this->visualizer) this->visualizer->Visualize(Operation::ACCESS, evicted);
+                    policy.Visualize(Operation::ACCESS, evicted);
                     K = size_t((*evicted-min)*c)+1;
 
                     int location = L[K] - 1;
 
                     std::swap(*(begin+location), *evicted);
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, evicted, begin+location);
+                    policy.Visualize(Operation::CHANGE, evicted, begin+location);
 
                     L[K]--;
 
@@ -1420,16 +1775,12 @@ namespace Sortings{
                 int classSize = L[K+1] - L[K];
 
                 if(classSize > threshold && classSize > 32) {
-                    Sort(begin+L[K],begin+L[K]+classSize);
+                    Sort(begin+L[K],begin+L[K]+classSize, cmp, policy);
                 } else if(classSize > 1){
-                    m_InsertionSort.SetVisualizer(this->visualizer);
-                    m_InsertionSort.Sort(begin+L[K],begin+L[K]+classSize);
+                    InsertionSort<Container>::Sort(begin+L[K],begin+L[K]+classSize, cmp, policy);
                 }
             }
         }
-
-    private:
-        InsertionSort<Container> m_InsertionSort;
     }; 
 
     /**
@@ -1453,31 +1804,37 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            using Iterator = typename Container::iterator;
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             for (size_t curSize = end-begin; curSize > 1; curSize--) {
                 size_t maxId = 0;
 
                 for(Iterator it = begin; it < begin + curSize;it++){
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, begin + maxId, it);
+                    policy.Visualize(Operation::COMPARISON, begin + maxId, it);
                     if(cmp(*(begin + maxId), *it)){
                         maxId = it-begin;
                     }
                 }
 
                 if (maxId != curSize-1){
-                    Flip(begin, begin+maxId+1);
-                    Flip(begin, begin+curSize);
+                    Flip(begin, begin+maxId+1, policy);
+                    Flip(begin, begin+curSize, policy);
                 }
             }
         }
 
     private:
-        void Flip(typename Container::iterator begin, typename Container::iterator end) {
+        template<typename Iterator, typename Policy>
+        static void Flip(Iterator begin, Iterator end, Policy& policy) {
             size_t start = 0;
             size_t i = end-begin-1;
             while (start < i) {
                 std::swap(*(begin+start),*(begin+i));
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin + start, begin+i);
+                policy.Visualize(Operation::CHANGE, begin + start, begin+i);
                 start++;
                 i--;
             }
@@ -1505,19 +1862,25 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
-            if(IsSorted(begin, end, cmp)){
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
+            if(IsSorted(begin, end, cmp, policy)){
                 return;
             }
-            while (NextPermutation(begin, end)) {
-                if(IsSorted(begin, end, cmp)){
+            while (NextPermutation(begin, end, policy)) {
+                if(IsSorted(begin, end, cmp, policy)){
                     return;
                 }
             }
         }
 
     private:
-        bool NextPermutation(typename Container::iterator begin, typename Container::iterator end) {
-            using Iterator = typename Container::iterator;
+        template<typename Iterator, typename Policy>
+        static bool NextPermutation(Iterator begin, Iterator end, Policy& policy) {
             if (begin == end) return false;
             Iterator i = end;
             if (begin == --i) return false;
@@ -1526,45 +1889,41 @@ namespace Sortings{
                 Iterator i1, i2;
 
                 i1 = i;
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, i1);
+                policy.Visualize(Operation::COMPARISON, i, i1);
                 if (*--i < *i1) {
                     i2 = end;
                     while (!(*i < *--i2)){
-                        if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, i2);
+                        policy.Visualize(Operation::COMPARISON, i, i2);
                     }
-                    if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, i, i2);
+                    policy.Visualize(Operation::COMPARISON, i, i2);
                     std::swap(*i, *i2);
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, i, i2);
-                    Reverse(i1, end);
+                    policy.Visualize(Operation::CHANGE, i, i2);
+                    Reverse(i1, end, policy);
                     return true;
                 }
                 if (i == begin) {
-                    Reverse(begin, end);
+                    Reverse(begin, end, policy);
                     return false;
                 }
             }
         }
 
-        void Reverse(typename Container::iterator begin, typename Container::iterator end)
+        template<typename Iterator, typename Policy>
+        static void Reverse(Iterator begin, Iterator end, Policy& policy)
         {
             while ((begin != end) && (begin != --end)) {
                 std::swap(*begin, *end);
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, begin, end);
+                policy.Visualize(Operation::CHANGE, begin, end);
                 begin++;
             }
         }
 
-        bool IsSorted(typename Container::iterator begin, typename Container::iterator end,
-                      std::function<bool (
-                      typename std::iterator_traits<typename Container::iterator>::value_type,
-                      typename std::iterator_traits<typename Container::iterator>::value_type)> cmp){
-            using Iterator = typename Container::iterator;
+        template<typename Iterator, typename Compare, typename Policy>
+        static bool IsSorted(Iterator begin, Iterator end, Compare& cmp, Policy& policy){
             if (begin < end) {
                 Iterator next = begin;
                 while (++next != end) {
-                    if ((this->visualizer != nullptr ?
-                         this->visualizer->Visualize(Operation::COMPARISON, next, begin) : true)
-                            && cmp(*next, *begin)){
+                    if (policy.Visualize(Operation::COMPARISON, next, begin) && cmp(*next, *begin)){
                         return false;
                     }
                     begin = next;
@@ -1595,19 +1954,25 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             size_t temp;
             if(end-begin > 2) {
                 temp = (end-begin)/3;
-                Sort(begin, end-temp, cmp);
-                Sort(begin+temp, end, cmp);
-                Sort(begin, end-temp, cmp);
+                Sort(begin, end-temp, cmp, policy);
+                Sort(begin+temp, end, cmp, policy);
+                Sort(begin, end-temp, cmp, policy);
             }
             if(cmp(*(--end), *begin)) {
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, end, begin);
+                policy.Visualize(Operation::COMPARISON, end, begin);
                 std::swap(*end, *begin);
-                if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, end, begin);
+                policy.Visualize(Operation::CHANGE, end, begin);
             }
-            if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, end, begin);
+            policy.Visualize(Operation::COMPARISON, end, begin);
         }
     };
 
@@ -1632,20 +1997,26 @@ namespace Sortings{
                 [](typename std::iterator_traits<typename Container::iterator>::value_type x,
                    typename std::iterator_traits<typename Container::iterator>::value_type y) ->
                 bool { return x < y; }) override {
+            DynamicVisualization<Container> policy(this->visualizer);
+            Sort(begin, end, std::ref(cmp), policy);
+        }
+
+        template<typename Iterator, typename Compare, typename Policy>
+        static void Sort(Iterator begin, Iterator end, Compare cmp, Policy& policy){
             if (end - begin < 2){
                 return;
             }
             else{
                 size_t middle = (end-begin)/2;
-                Sort(begin, begin + middle, cmp);
-                Sort(begin + middle, end, cmp);
+                Sort(begin, begin + middle, cmp, policy);
+                Sort(begin + middle, end, cmp, policy);
                 end--;
-                if(this->visualizer) this->visualizer->Visualize(Operation::COMPARISON, end, begin+middle-1);
+                policy.Visualize(Operation::COMPARISON, end, begin+middle-1);
                 if(cmp(*end, *(begin+middle-1))){
                     std::swap(*end, *(begin+middle-1));
-                    if(this->visualizer) this->visualizer->Visualize(Operation::CHANGE, end, begin+middle-1);
+                    policy.Visualize(Operation::CHANGE, end, begin+middle-1);
                 }
-                Sort(begin, end, cmp);
+                Sort(begin, end, cmp, policy);
             }
         }
     };
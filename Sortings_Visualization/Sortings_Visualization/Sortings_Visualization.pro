@@ -16,10 +16,13 @@ DEFINES += QT_DEPRECATED_WARNINGS
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
 SOURCES += \
+    eventlog.cpp \
     main.cpp \
     mainwindow.cpp \
     parser.cpp \
     parsingwindow.cpp \
+    playback.cpp \
+    rasterrenderer.cpp \
     visualizer.cpp
 
 HEADERS += \
@@ -29,9 +32,13 @@ HEADERS += \
     Sorting.h \
     SortingProxy.h \
     doctest.h \
+    eventlog.h \
     mainwindow.h \
     parser.h \
     parsingwindow.h \
+    playback.h \
+    rasterrenderer.h \
+    ringbuffer.h \
     visualizer.h
 
 FORMS += \
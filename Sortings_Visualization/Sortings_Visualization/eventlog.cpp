@@ -0,0 +1,217 @@
+/**
+\file
+\brief .cpp file with implementation of EventLog class
+*/
+
+#include "eventlog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    const uint8_t OperationMask = 0x3;
+    const uint8_t SecondFlag = 0x4;
+    const uint8_t DeltaShift = 3;
+    const uint8_t LongDelta = 31;   ///<delta of first position doesn't fit in header and follows it
+
+    uint64_t EncodeZigZag(int64_t value){
+        return (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+    }
+
+    int64_t DecodeZigZag(uint64_t value){
+        return int64_t(value >> 1) ^ -int64_t(value & 1);
+    }
+
+    void WriteVarint(uint8_t*& out, uint64_t value){
+        while(value >= 0x80){
+            *out++ = uint8_t(value) | 0x80;
+            value >>= 7;
+        }
+        *out++ = uint8_t(value);
+    }
+
+    uint64_t ReadVarint(const uint8_t*& in){
+        uint64_t value = 0;
+        for(int shift = 0; ; shift += 7){
+            uint8_t byte = *in++;
+            value |= uint64_t(byte & 0x7f) << shift;
+            if(byte < 0x80){
+                return value;
+            }
+        }
+    }
+}
+
+EventLog::Cursor::Cursor(const EventLog& log):
+    m_Log(&log),
+    m_Index(0),
+    m_Offset(0),
+    m_PreviousFirst(0){}
+
+bool EventLog::Cursor::Next(Event& event){
+    if(m_Index >= m_Log->m_Size){
+        return false;
+    }
+    const uint8_t* begin = m_Log->GetData() + m_Offset;
+    const uint8_t* in = begin;
+    uint8_t header = *in++;
+    uint64_t delta = header >> DeltaShift;
+    if(delta == LongDelta){
+        delta = ReadVarint(in);
+    }
+    event.operation = static_cast<Sortings::Operation>(header & OperationMask);
+    event.first = m_PreviousFirst + DecodeZigZag(delta);
+    event.second = header & SecondFlag ? event.first + DecodeZigZag(ReadVarint(in)) : NoPosition;
+    event.firstValue = event.secondValue = 0;
+    if(event.operation == Sortings::Operation::CHANGE){
+        event.firstValue = uint32_t(ReadVarint(in));
+        if(event.second != NoPosition){
+            event.secondValue = uint32_t(ReadVarint(in));
+        }
+    }
+    m_PreviousFirst = event.first;
+    m_Offset += in - begin;
+    m_Index++;
+    return true;
+}
+
+void EventLog::Cursor::Seek(size_t index){
+    index = std::min(index, m_Log->m_Size);
+    if(index < m_Index || index - m_Index >= CheckpointStep){
+        const Checkpoint& checkpoint = m_Log->m_Checkpoints[index / CheckpointStep];
+        m_Index = index / CheckpointStep * CheckpointStep;
+        m_Offset = checkpoint.offset;
+        m_PreviousFirst = checkpoint.previousFirst;
+    }
+    Event event;
+    while(m_Index < index){
+        Next(event);
+    }
+}
+
+size_t EventLog::Cursor::GetIndex() const{
+    return m_Index;
+}
+
+EventLog::EventLog(size_t memoryBudget):
+    m_MemoryBudget(memoryBudget),
+    m_Size(0),
+    m_Bytes(0),
+    m_PreviousFirst(0),
+    m_IsComplete(false),
+    m_Mapped(nullptr),
+    m_MappedCapacity(0){
+    m_Checkpoints.push_back({0, 0});
+}
+
+EventLog::~EventLog(){
+    Clear();
+}
+
+void EventLog::Append(const Event& event){
+    uint8_t* begin = Reserve(MaxEventBytes);
+    uint8_t* out = begin;
+    uint64_t delta = EncodeZigZag(int64_t(event.first - m_PreviousFirst));
+    uint8_t header = uint8_t(event.operation) | (event.second != NoPosition ? SecondFlag : 0);
+    if(delta < LongDelta){
+        *out++ = header | uint8_t(delta << DeltaShift);
+    }
+    else{
+        *out++ = header | uint8_t(LongDelta << DeltaShift);
+        WriteVarint(out, delta);
+    }
+    if(event.second != NoPosition){
+        WriteVarint(out, EncodeZigZag(int64_t(event.second - event.first)));
+    }
+    if(event.operation == Sortings::Operation::CHANGE){
+        WriteVarint(out, event.firstValue);
+        if(event.second != NoPosition){
+            WriteVarint(out, event.secondValue);
+        }
+    }
+    m_PreviousFirst = event.first;
+    m_IsComplete = event.operation == Sortings::Operation::END;
+    m_Bytes += out - begin;
+    if(++m_Size % CheckpointStep == 0){
+        m_Checkpoints.push_back({m_Bytes, m_PreviousFirst});
+    }
+}
+
+void EventLog::Clear(){
+    if(m_Mapped){
+        m_File->unmap(m_Mapped);
+    }
+    m_File.reset();
+    m_Mapped = nullptr;
+    m_MappedCapacity = 0;
+    std::vector<uint8_t>().swap(m_Memory);
+    m_Checkpoints.assign(1, {0, 0});
+    m_Size = m_Bytes = m_PreviousFirst = 0;
+    m_IsComplete = false;
+}
+
+size_t EventLog::Drain(RingBuffer<Event>& events, size_t size){
+    size_t drained = 0;
+    Event event;
+    while(m_Size < size && drained < events.Capacity() && events.TryPop(event)){
+        Append(event);
+        drained++;
+    }
+    return drained;
+}
+
+bool EventLog::IsComplete() const{
+    return m_IsComplete;
+}
+
+size_t EventLog::Size() const{
+    return m_Size;
+}
+
+size_t EventLog::GetBytes() const{
+    return m_Bytes;
+}
+
+bool EventLog::IsMapped() const{
+    return m_Mapped != nullptr;
+}
+
+const uint8_t* EventLog::GetData() const{
+    return m_Mapped ? m_Mapped : m_Memory.data();
+}
+
+uint8_t* EventLog::Reserve(size_t bytes){
+    if(!m_Mapped && m_Bytes + bytes > m_MemoryBudget){
+        MapFile(std::max(2 * m_MemoryBudget, m_Bytes + bytes));
+        std::memcpy(m_Mapped, m_Memory.data(), m_Bytes);
+        std::vector<uint8_t>().swap(m_Memory);
+    }
+    if(m_Mapped){
+        if(m_Bytes + bytes > m_MappedCapacity){
+            MapFile(2 * m_MappedCapacity);
+        }
+        return m_Mapped + m_Bytes;
+    }
+    if(m_Memory.size() < m_Bytes + bytes){
+        m_Memory.resize(std::min(std::max(2 * m_Memory.size(), m_Bytes + bytes), m_MemoryBudget));
+    }
+    return m_Memory.data() + m_Bytes;
+}
+
+void EventLog::MapFile(size_t capacity){
+    if(!m_File){
+        m_File = std::make_unique<QTemporaryFile>();
+        if(!m_File->open()){
+            throw std::runtime_error("can't create temporary file for visualization events");
+        }
+    }
+    if(m_Mapped){
+        m_File->unmap(m_Mapped);
+        m_Mapped = nullptr;
+    }
+    if(!m_File->resize(qint64(capacity)) || !(m_Mapped = m_File->map(0, qint64(capacity)))){
+        throw std::runtime_error("can't map temporary file for visualization events");
+    }
+    m_MappedCapacity = capacity;
+}
@@ -0,0 +1,174 @@
+/**
+\file
+\brief .h file with definition of EventLog class
+*/
+
+#pragma once
+
+#include <QTemporaryFile>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Sorting.h"
+#include "ringbuffer.h"
+
+/**
+\brief packed log of visualization events
+
+Every event is one header byte with operation, flag of second position and small delta of first position,
+then varint coded deltas of positions and, for changes only, varint coded new values of elements.
+Usual events of sortings take 2-4 bytes instead of 40 bytes of plain struct.
+
+Log is kept in memory while it's smaller than memory budget, after that it's moved to temporary file
+that is mapped to memory. Decoder state is saved every CheckpointStep events, so cursor seeks to any event
+by decoding at most CheckpointStep - 1 events.
+*/
+class EventLog
+{
+public:
+    /**
+    \brief decoded event
+    */
+    struct Event{
+        Sortings::Operation operation;
+        size_t first;
+        size_t second;          ///<NoPosition if operation has one position
+        uint32_t firstValue;    ///<value of first element after change, 0 for other operations
+        uint32_t secondValue;   ///<value of second element after change, 0 for other operations
+    };
+
+    static constexpr size_t NoPosition = SIZE_MAX;
+    static constexpr size_t CheckpointStep = 4096;
+
+    /**
+    \brief reads events of log one by one
+
+    \note cursor stays valid while events are appended to log
+    */
+    class Cursor
+    {
+    public:
+        /**
+        \brief Cursor ctor
+
+        \param log log to read, cursor is placed on its first event
+        */
+        Cursor(const EventLog& log);
+
+        /**
+        \brief decodes next event
+
+        \param event decoded event
+        \return false if all events of log are read
+        */
+        bool Next(Event& event);
+
+        /**
+        \brief places cursor on event
+
+        \param index index of event, log size to place cursor after last event
+        */
+        void Seek(size_t index);
+
+        /**
+        \brief index getter
+
+        \return index of event that will be decoded next
+        */
+        size_t GetIndex() const;
+
+    private:
+        const EventLog* m_Log;
+        size_t m_Index;
+        size_t m_Offset;
+        size_t m_PreviousFirst;
+    };
+
+    /**
+    \brief EventLog ctor
+
+    \param memoryBudget number of bytes log keeps in memory before moving to mapped file
+    */
+    EventLog(size_t memoryBudget = 256 * 1024 * 1024);
+    ~EventLog();
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    /**
+    \brief appends event to log
+
+    \param event event, values are stored for changes only
+    \throw std::runtime_error if temporary file can't be created or mapped
+    */
+    void Append(const Event& event);
+
+    /**
+    \brief moves events from queue filled by sorting thread to log
+
+    \param events queue of events
+    \param size number of events log stops growing at
+    \return number of appended events, at most capacity of queue, so call returns even if producer keeps queue full
+    */
+    size_t Drain(RingBuffer<Event>& events, size_t size);
+
+    /**
+    \brief checks if END event is appended
+
+    \return true if log holds all events of sorting
+    */
+    bool IsComplete() const;
+
+    /**
+    \brief removes all events and mapped file
+    */
+    void Clear();
+
+    /**
+    \brief number of events getter
+
+    \return number of events in log
+    */
+    size_t Size() const;
+
+    /**
+    \brief size of encoded events getter
+
+    \return number of bytes used by events
+    */
+    size_t GetBytes() const;
+
+    /**
+    \brief checks if log is moved to mapped file
+
+    \return true if log outgrew memory budget
+    */
+    bool IsMapped() const;
+
+private:
+    struct Checkpoint{
+        size_t offset;
+        size_t previousFirst;
+    };
+
+    static constexpr size_t MaxEventBytes = 32;
+
+    const uint8_t* GetData() const;
+    uint8_t* Reserve(size_t bytes);
+    void MapFile(size_t capacity);
+
+    size_t m_MemoryBudget;
+    size_t m_Size;
+    size_t m_Bytes;
+    size_t m_PreviousFirst;
+    bool m_IsComplete;
+
+    std::vector<uint8_t> m_Memory;
+    std::unique_ptr<QTemporaryFile> m_File;
+    uchar* m_Mapped;
+    size_t m_MappedCapacity;
+
+    std::vector<Checkpoint> m_Checkpoints;
+};
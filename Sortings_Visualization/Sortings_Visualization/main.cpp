@@ -5,8 +5,16 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <memory>
+#include <thread>
+#include <map>
 
 #include "Sorting.h"
+#include "Factory.h"
+#include "eventlog.h"
+#include "ringbuffer.h"
+#include "rasterrenderer.h"
+#include "playback.h"
 
 #define DOCTEST_CONFIG_IMPLEMENT
 #include "doctest.h"
@@ -200,6 +208,456 @@ TEST_CASE("testing sortings"){
     TestSorting<long>(tree, 100, [](long x, long y){return x > y;});
 }
 
+template <typename Container>
+class RecordingVisualizer : public Sortings::DefaultVisualizer<Container>{
+public:
+    RecordingVisualizer(typename Container::iterator origin):
+        m_Recording(origin) {}
+
+    bool Visualize(Sortings::Operation operation, typename Container::iterator first,
+                   std::optional<typename Container::iterator> second = std::nullopt) override{
+        return second ? m_Recording.Visualize(operation, first, *second) : m_Recording.Visualize(operation, first);
+    }
+
+    const Sortings::RecordingVisualization<typename Container::iterator>& GetRecording() const{
+        return m_Recording;
+    }
+
+private:
+    Sortings::RecordingVisualization<typename Container::iterator> m_Recording;
+};
+
+TEST_CASE("testing static sorting policies"){
+    using Iterator = std::vector<long>::iterator;
+    using Event = Sortings::RecordingVisualization<Iterator>::Event;
+    std::random_device rd;
+    std::mt19937 mersenne(rd());
+    for(int i = 0; i <= static_cast<int>(Sortings::SortingName::TREESORT); i++){
+        auto name = static_cast<Sortings::SortingName>(i);
+        CAPTURE(i);
+        long number = name == Sortings::SortingName::BOGOSORT ? 7 : 100;
+        std::vector<long> v;
+        for(long j = 0; j < number; j++){
+            v.push_back(mersenne() % number);
+        }
+        auto sorted_v = v;
+        std::sort(sorted_v.begin(), sorted_v.end());
+
+        auto headless_v = v;
+        Sortings::NoVisualization noVisualization;
+        Factory<std::vector<long>>::Sort(name, headless_v.begin(), headless_v.end(), std::less<long>(), noVisualization);
+        CHECK(headless_v == sorted_v);
+
+        auto recorded_v = v;
+        Sortings::RecordingVisualization<Iterator> recording(recorded_v.begin());
+        Factory<std::vector<long>>::Sort(name, recorded_v.begin(), recorded_v.end(), std::less<long>(), recording);
+        CHECK(recorded_v == sorted_v);
+
+        auto virtual_v = v;
+        RecordingVisualizer<std::vector<long>> visualizer(virtual_v.begin());
+        std::unique_ptr<Sortings::Sorting<std::vector<long>>> sorting(Factory<std::vector<long>>::CreateSorting(name, &visualizer));
+        sorting->Sort(virtual_v.begin(), virtual_v.end());
+        CHECK(virtual_v == sorted_v);
+
+        if(name == Sortings::SortingName::QUICKSORTPIVOTRANDOM){
+            continue;
+        }
+        CHECK(visualizer.GetRecording().GetEvents() == recording.GetEvents());
+
+        auto counted_v = v;
+        Sortings::CountingVisualization counting;
+        Factory<std::vector<long>>::Sort(name, counted_v.begin(), counted_v.end(), std::less<long>(), counting);
+        size_t comparisons = 0, accesses = 0, changes = 0;
+        for(const Event& event : recording.GetEvents()){
+            size_t elements = event.second == Sortings::RecordingVisualization<Iterator>::NoPosition ? 1 : 2;
+            comparisons += event.operation == Sortings::Operation::COMPARISON;
+            accesses += event.operation == Sortings::Operation::ACCESS ? elements : 0;
+            changes += event.operation == Sortings::Operation::CHANGE ? elements : 0;
+        }
+        CHECK(counting.GetComparisons() == comparisons);
+        CHECK(counting.GetAccesses() == accesses);
+        CHECK(counting.GetChanges() == changes);
+    }
+}
+
+template <typename Container>
+class LoggingVisualizer : public Sortings::DefaultVisualizer<Container>{
+public:
+    LoggingVisualizer(Container& data, EventLog& log):
+        m_Data(data), m_Log(log) {}
+
+    bool Visualize(Sortings::Operation operation, typename Container::iterator first,
+                   std::optional<typename Container::iterator> second = std::nullopt) override{
+        bool isChange = operation == Sortings::Operation::CHANGE;
+        m_Log.Append({operation, size_t(first - m_Data.begin()),
+                      second ? size_t(*second - m_Data.begin()) : EventLog::NoPosition,
+                      isChange ? uint32_t(*first) : 0, isChange && second ? uint32_t(**second) : 0});
+        return true;
+    }
+
+private:
+    Container& m_Data;
+    EventLog& m_Log;
+};
+
+bool IsSameEvent(const EventLog::Event& x, const EventLog::Event& y){
+    return x.operation == y.operation && x.first == y.first && x.second == y.second &&
+            x.firstValue == y.firstValue && x.secondValue == y.secondValue;
+}
+
+TEST_CASE("testing event log"){
+    std::random_device rd;
+    std::mt19937 mersenne(rd());
+    std::vector<EventLog::Event> events;
+    for(size_t i = 0; i < 50'000; i++){
+        auto operation = static_cast<Sortings::Operation>(mersenne() % 3);
+        size_t first = i % 1000 == 0 ? mersenne() : mersenne() % 20'000;
+        size_t second = mersenne() % 2 ? EventLog::NoPosition : mersenne() % 20'000;
+        bool isChange = operation == Sortings::Operation::CHANGE;
+        events.push_back({operation, first, second, isChange ? uint32_t(mersenne()) : 0,
+                          isChange && second != EventLog::NoPosition ? uint32_t(mersenne()) : 0});
+    }
+    for(size_t memoryBudget : {size_t(1) << 30, size_t(1000)}){
+        CAPTURE(memoryBudget);
+        EventLog log(memoryBudget);
+        EventLog::Cursor cursor(log);
+        EventLog::Event event;
+        for(size_t i = 0; i < events.size(); i++){
+            log.Append(events[i]);
+            if(i % 10'000 == 0){
+                REQUIRE(cursor.Next(event));
+                CHECK(IsSameEvent(event, events[cursor.GetIndex() - 1]));
+            }
+        }
+        CHECK(log.Size() == events.size());
+        CHECK(log.IsMapped() == (memoryBudget < log.GetBytes()));
+
+        cursor.Seek(0);
+        bool isSame = true;
+        while(cursor.Next(event)){
+            isSame = isSame && IsSameEvent(event, events[cursor.GetIndex() - 1]);
+        }
+        CHECK(isSame);
+        CHECK(cursor.GetIndex() == events.size());
+
+        for(size_t index : {size_t(0), size_t(4095), size_t(4096), size_t(40'000), size_t(5), events.size() - 1}){
+            cursor.Seek(index);
+            REQUIRE(cursor.Next(event));
+            CHECK(IsSameEvent(event, events[index]));
+        }
+        cursor.Seek(events.size());
+        CHECK_FALSE(cursor.Next(event));
+
+        log.Clear();
+        cursor.Seek(0);
+        CHECK(log.Size() == 0);
+        CHECK_FALSE(log.IsMapped());
+        CHECK_FALSE(cursor.Next(event));
+    }
+
+    std::vector<uint32_t> v;
+    for(uint32_t i = 0; i < 2000; i++){
+        v.push_back(mersenne() % 2000);
+    }
+    EventLog log;
+    LoggingVisualizer<std::vector<uint32_t>> visualizer(v, log);
+    Sortings::BubbleSort<std::vector<uint32_t>> bubble(&visualizer);
+    bubble.Sort(v.begin(), v.end());
+    CHECK(std::is_sorted(v.begin(), v.end()));
+    CHECK(log.GetBytes() < 8 * log.Size());
+}
+
+template <typename Container>
+class StreamingVisualizer : public Sortings::DefaultVisualizer<Container>{
+public:
+    StreamingVisualizer(Container& data, RingBuffer<EventLog::Event>& events):
+        m_Data(data), m_Events(events) {}
+
+    bool Visualize(Sortings::Operation operation, typename Container::iterator first,
+                   std::optional<typename Container::iterator> second = std::nullopt) override{
+        bool isChange = operation == Sortings::Operation::CHANGE;
+        Publish({operation, size_t(first - m_Data.begin()),
+                 second ? size_t(*second - m_Data.begin()) : EventLog::NoPosition,
+                 isChange ? uint32_t(*first) : 0, isChange && second ? uint32_t(**second) : 0});
+        return true;
+    }
+
+    void Publish(const EventLog::Event& event){
+        while(!m_Events.TryPush(event)){
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    Container& m_Data;
+    RingBuffer<EventLog::Event>& m_Events;
+};
+
+TEST_CASE("testing ring buffer"){
+    SUBCASE("single thread"){
+        RingBuffer<int> ring(1000);
+        CHECK(ring.Capacity() == 1024);
+        int item;
+        CHECK_FALSE(ring.TryPop(item));
+        for(int round = 0; round < 3; round++){
+            int base = round * 1024;
+            bool isPushed = true;
+            for(int j = 0; j < 1024; j++){
+                isPushed = isPushed && ring.TryPush(base + j);
+            }
+            REQUIRE(isPushed);
+            CHECK_FALSE(ring.TryPush(-1));
+            REQUIRE(ring.TryPop(item));
+            CHECK(item == base);
+            CHECK(ring.TryPush(-1));
+            bool isSame = true;
+            for(int j = 1; j < 1024; j++){
+                isSame = isSame && ring.TryPop(item) && item == base + j;
+            }
+            CHECK(isSame);
+            REQUIRE(ring.TryPop(item));
+            CHECK(item == -1);
+            CHECK_FALSE(ring.TryPop(item));
+        }
+        ring.TryPush(1);
+        ring.Clear();
+        CHECK_FALSE(ring.TryPop(item));
+    }
+    SUBCASE("sorting on producer thread"){
+        std::random_device rd;
+        std::mt19937 mersenne(rd());
+        std::vector<uint32_t> v;
+        for(uint32_t i = 0; i < 3000; i++){
+            v.push_back(mersenne() % 3000);
+        }
+        std::vector<uint32_t> copy = v;
+
+        EventLog expected;
+        LoggingVisualizer<std::vector<uint32_t>> loggingVisualizer(copy, expected);
+        Sortings::MergeSort<std::vector<uint32_t>>(&loggingVisualizer).Sort(copy.begin(), copy.end());
+
+        RingBuffer<EventLog::Event> events(64);
+        StreamingVisualizer<std::vector<uint32_t>> streamingVisualizer(v, events);
+        std::thread producer([&]{
+            Sortings::MergeSort<std::vector<uint32_t>>(&streamingVisualizer).Sort(v.begin(), v.end());
+            streamingVisualizer.Publish({Sortings::Operation::END, 0, EventLog::NoPosition, 0, 0});
+        });
+        EventLog streamed;
+        EventLog::Event event;
+        while(true){
+            if(events.TryPop(event)){
+                if(event.operation == Sortings::Operation::END){
+                    break;
+                }
+                streamed.Append(event);
+            }
+        }
+        producer.join();
+
+        CHECK(v == copy);
+        REQUIRE(streamed.Size() == expected.Size());
+        EventLog::Cursor expectedCursor(expected);
+        EventLog::Cursor streamedCursor(streamed);
+        EventLog::Event expectedEvent;
+        bool isSame = true;
+        while(expectedCursor.Next(expectedEvent) && streamedCursor.Next(event)){
+            isSame = isSame && IsSameEvent(event, expectedEvent);
+        }
+        CHECK(isSame);
+    }
+}
+
+int CountPixels(const QImage& image, int column, QRgb color){
+    int count = 0;
+    for(int row = 0; row < image.height(); row++){
+        count += image.pixel(column, row) == color;
+    }
+    return count;
+}
+
+TEST_CASE("testing raster renderer"){
+    const QRgb white = qRgb(255, 255, 255);
+    const QRgb red = qRgb(255, 0, 0);
+    const QRgb lightRed = qRgb(255, 127, 127);
+    const QRgb blue = qRgb(0, 0, 255);
+    RasterRenderer renderer;
+
+    SUBCASE("more elements than columns"){
+        std::vector<uint32_t> v;
+        for(uint32_t i = 0; i < 2000; i++){
+            v.push_back(i);
+        }
+        renderer.Reset(v, 2000, QSize(100, 210));
+        CHECK(renderer.Render());
+        CHECK_FALSE(renderer.Render());
+        const QImage& image = renderer.GetImage();
+        REQUIRE(image.width() == 100);
+        bool isAggregated = true;
+        for(int column = 0; column < 100; column++){
+            int minHeight = int(20 * column * 0.09);
+            int maxHeight = int((20 * column + 19) * 0.09);
+            isAggregated = isAggregated && CountPixels(image, column, red) == minHeight &&
+                    CountPixels(image, column, lightRed) == maxHeight - minHeight &&
+                    CountPixels(image, column, white) == 210 - maxHeight;
+        }
+        CHECK(isAggregated);
+
+        renderer.SetColor(45, blue);
+        renderer.SetValue(1999, 0);
+        CHECK(renderer.Render());
+        CHECK(CountPixels(image, 2, blue) + CountPixels(image, 2, qRgb(127, 127, 255)) == int(59 * 0.09));
+        CHECK(CountPixels(image, 1, blue) == 0);
+        CHECK(CountPixels(image, 99, red) == 0);
+        CHECK(CountPixels(image, 99, lightRed) == int(1998 * 0.09));
+        CHECK_FALSE(renderer.Render());
+    }
+    SUBCASE("fewer elements than columns"){
+        std::vector<uint32_t> v(10, 5);
+        renderer.Reset(v, 10, QSize(100, 110));
+        renderer.Render();
+        renderer.SetColor(3, blue);
+        renderer.SetValue(3, 10);
+        CHECK(renderer.Render());
+        const QImage& image = renderer.GetImage();
+        bool isSame = true;
+        for(int column = 0; column < 100; column++){
+            bool isChanged = column >= 30 && column < 40;
+            isSame = isSame && CountPixels(image, column, isChanged ? blue : red) == (isChanged ? 90 : 45) &&
+                    CountPixels(image, column, white) == (isChanged ? 20 : 65);
+        }
+        CHECK(isSame);
+
+        renderer.Resize(QSize(7, 110));
+        renderer.Render();
+        CHECK(renderer.GetImage().width() == 7);
+        CHECK(CountPixels(renderer.GetImage(), 2, red) == 45);
+        CHECK(CountPixels(renderer.GetImage(), 2, lightRed) == 45);
+    }
+}
+
+bool IsSameCounters(const Playback::Counters& x, const Playback::Counters& y){
+    return x.comparisons == y.comparisons && x.accesses == y.accesses && x.changes == y.changes;
+}
+
+TEST_CASE("testing playback"){
+    std::random_device rd;
+    std::mt19937 mersenne(rd());
+    std::vector<uint32_t> v;
+    for(uint32_t i = 0; i < 6000; i++){
+        v.push_back(mersenne() % 6000);
+    }
+    auto sorted_v = v;
+    std::sort(sorted_v.begin(), sorted_v.end());
+
+    EventLog log;
+    auto recorded_v = v;
+    LoggingVisualizer<std::vector<uint32_t>> visualizer(recorded_v, log);
+    Sortings::MergeSort<std::vector<uint32_t>>(&visualizer).Sort(recorded_v.begin(), recorded_v.end());
+    auto counted_v = v;
+    Sortings::CountingVisualization counting;
+    Factory<std::vector<uint32_t>>::Sort(Sortings::SortingName::MERGESORT, counted_v.begin(), counted_v.end(),
+                                         std::less<uint32_t>(), counting);
+
+    Playback playback(log);
+    playback.Reset(v);
+    CHECK(playback.GetKeyframeStep() == 2 * EventLog::CheckpointStep);
+
+    std::vector<size_t> indexes = {0, 1, 8191, 8192, 8193, 50'000, log.Size() / 2, log.Size() - 1, log.Size()};
+    std::map<size_t, std::pair<std::vector<uint32_t>, Playback::Counters>> states;
+    states[0] = {playback.GetValues(), playback.GetCounters()};
+    EventLog::Event event;
+    while(playback.Next(event)){
+        if(std::find(indexes.begin(), indexes.end(), playback.GetIndex()) != indexes.end()){
+            states[playback.GetIndex()] = {playback.GetValues(), playback.GetCounters()};
+        }
+    }
+    REQUIRE(states.size() == indexes.size());
+    CHECK(playback.GetValues() == sorted_v);
+    CHECK(playback.GetCounters().comparisons == counting.GetComparisons());
+    CHECK(playback.GetCounters().accesses == counting.GetAccesses());
+    CHECK(playback.GetCounters().changes == counting.GetChanges());
+
+    for(int round = 0; round < 2; round++){
+        std::shuffle(indexes.begin(), indexes.end(), mersenne);
+        for(size_t index : indexes){
+            CAPTURE(index);
+            playback.Seek(index);
+            CHECK(playback.GetIndex() == index);
+            CHECK(playback.GetValues() == states[index].first);
+            CHECK(IsSameCounters(playback.GetCounters(), states[index].second));
+        }
+    }
+    playback.Seek(log.Size() + 100);
+    CHECK(playback.GetIndex() == log.Size());
+
+    Playback unplayed(log);
+    unplayed.Reset(v);
+    unplayed.Seek(log.Size() - 1);
+    CHECK(unplayed.GetValues() == states[log.Size() - 1].first);
+    unplayed.Seek(1);
+    CHECK(unplayed.GetValues() == states[1].first);
+    CHECK(IsSameCounters(unplayed.GetCounters(), states[1].second));
+
+    SUBCASE("seek beyond drained events"){
+        auto streamed_v = v;
+        RingBuffer<EventLog::Event> events(64);
+        StreamingVisualizer<std::vector<uint32_t>> streamingVisualizer(streamed_v, events);
+        std::thread producer([&]{
+            Sortings::MergeSort<std::vector<uint32_t>>(&streamingVisualizer).Sort(streamed_v.begin(), streamed_v.end());
+            streamingVisualizer.Publish({Sortings::Operation::END, 0, EventLog::NoPosition, 0, 0});
+        });
+        EventLog streamed;
+        Playback streamedPlayback(streamed);
+        streamedPlayback.Reset(v);
+        size_t target = log.Size() / 2;
+        REQUIRE(target > 100 * events.Capacity());
+        size_t maxDrained = 0;
+        while(streamed.Size() < target && !streamed.IsComplete()){
+            maxDrained = std::max(maxDrained, streamed.Drain(events, target));
+        }
+        CHECK(maxDrained <= events.Capacity());
+        CHECK(streamed.Size() == target);
+        streamedPlayback.Seek(target);
+        CHECK(streamedPlayback.GetIndex() == target);
+        CHECK(streamedPlayback.GetValues() == states[target].first);
+        CHECK(IsSameCounters(streamedPlayback.GetCounters(), states[target].second));
+
+        while(!streamed.IsComplete()){
+            streamed.Drain(events, SIZE_MAX);
+        }
+        producer.join();
+        CHECK(streamed.Size() == log.Size() + 1);
+        streamedPlayback.Seek(streamed.Size());
+        CHECK(streamedPlayback.GetValues() == sorted_v);
+    }
+    SUBCASE("log that ends with END"){
+        log.Append({Sortings::Operation::END, 0, EventLog::NoPosition, 0, 0});
+        for(size_t index : {log.Size(), log.Size() - 1, log.Size() + 5, size_t(0), log.Size()}){
+            CAPTURE(index);
+            playback.Seek(index);
+            CHECK(playback.GetIndex() == std::min(index, log.Size() - 1));
+            REQUIRE(playback.Next(event));
+            CHECK((event.operation == Sortings::Operation::END) == (index != 0));
+        }
+        CHECK(playback.GetValues() == sorted_v);
+
+        EventLog shortLog;
+        for(size_t i = 0; i + 1 < EventLog::CheckpointStep; i++){
+            shortLog.Append({Sortings::Operation::COMPARISON, i % 10, EventLog::NoPosition, 0, 0});
+        }
+        shortLog.Append({Sortings::Operation::END, 0, EventLog::NoPosition, 0, 0});
+        Playback shortPlayback(shortLog);
+        shortPlayback.Reset(std::vector<uint32_t>(10));
+        REQUIRE(shortPlayback.GetKeyframeStep() == shortLog.Size());
+        while(shortPlayback.Next(event)){}
+        shortPlayback.Seek(shortLog.Size());
+        CHECK(shortPlayback.GetIndex() == shortLog.Size() - 1);
+        CHECK(shortPlayback.GetCounters().comparisons == shortLog.Size() - 1);
+        REQUIRE(shortPlayback.Next(event));
+        CHECK(event.operation == Sortings::Operation::END);
+    }
+}
+
 /// <summary>
 /// Sort Visualization
 /// </summary>
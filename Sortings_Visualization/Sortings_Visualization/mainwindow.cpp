@@ -31,10 +31,22 @@ MainWindow::MainWindow(QWidget *parent)
     m_Visualizer.SetComparisonsItem(ui->comparisons);
 
     ui->VisualizationControl->setVisible(false);
+
+    connect(&m_Visualizer, &Visualizer::Sorted, this, [this] { this->ui->groupBox->setEnabled(true);
+                                                               this->ui->VisualizationControl->setVisible(false);});
+    connect(&m_Visualizer, &Visualizer::SortingFinished, this, [this](float time) {
+        ui->SortingTime->setText("Time of sorting: " +  QString::number(time) + " milliseconds");
+    });
+    connect(&m_Visualizer, &Visualizer::PositionChanged, this, [this](size_t index, size_t size) {
+        if(!ui->position->isSliderDown()){
+            ui->position->setValue(size ? int(double(index) / size * ui->position->maximum()) : 0);
+        }
+    });
 }
 
 MainWindow::~MainWindow()
 {
+    m_Visualizer.Stop();
     delete ui;
 }
 
@@ -47,38 +59,42 @@ void MainWindow::resizeEvent(QResizeEvent *event)
 }
 
 void MainWindow::on_SortButton_clicked() {
+    //Ctrl+D comes here even if button is disabled: before initiation or while sorting runs on worker thread
+    if(!ui->SortButton->isEnabled()){
+        return;
+    }
     ui->comparisons->setText("0");
     ui->writes->setText("0");
     ui->reads->setText("0");
 
-    if(m_Numbers.size() <= 500){
+    bool isVisualized = m_Numbers.size() <= Visualizer::MaxVisualizedSize;
+    bool isIncreasing = ui->SortingOrder->currentText() == "Increasing";
+    auto name = static_cast<Sortings::SortingName>(ui->SortingNameComboBox->currentIndex());
+
+    if (isVisualized) {
         m_Sorting.SetVisualizer(&m_Visualizer);
+        ui->SortingTime->setText("Sorting...");
+        ui->groupBox->setEnabled(false);
+        m_Visualizer.Play([this, name, isIncreasing] {
+            if(isIncreasing){
+                return m_SortingAndTiming.Sort(name, m_Numbers.begin(), m_Numbers.end(), [](uint32_t x, uint32_t y) { return x < y; });
+            }
+            return m_SortingAndTiming.Sort(name, m_Numbers.begin(), m_Numbers.end(), [](uint32_t x, uint32_t y) { return x > y; });
+        }, ui->delay->value());
+        ui->VisualizationControl->setVisible(true);
     }
     else{
-        m_Sorting.SetVisualizer(&m_DefaultVisualizer);
-    }
-
-    m_Visualizer.ClearQueue();
-
-    if(ui->SortingOrder->currentText() == "Increasing"){
-        ui->SortingTime->setText("Time of sorting: " +  QString::number(m_SortingAndTiming.Sort(static_cast<Sortings::SortingName>(ui->SortingNameComboBox->currentIndex()), m_Numbers.begin(), m_Numbers.end(), [](uint32_t x, uint32_t y) { return x < y; })) + " milliseconds");
+        m_Visualizer.ClearQueue();
+        float time = isIncreasing ?
+                    m_SortingAndTiming.SortHeadless(name, m_Numbers.begin(), m_Numbers.end(), std::less<uint32_t>()) :
+                    m_SortingAndTiming.SortHeadless(name, m_Numbers.begin(), m_Numbers.end(), std::greater<uint32_t>());
+        ui->SortingTime->setText("Time of sorting: " +  QString::number(time) + " milliseconds");
     }
-    else if(ui->SortingOrder->currentText() == "Decreasing"){
-        ui->SortingTime->setText("Time of sorting: " +  QString::number(m_SortingAndTiming.Sort(static_cast<Sortings::SortingName>(ui->SortingNameComboBox->currentIndex()), m_Numbers.begin(), m_Numbers.end(), [](uint32_t x, uint32_t y) { return x > y; })) + " milliseconds");
-    }
-    std::vector<std::string> performance = m_SortingAndTiming.ComplexityCheck(static_cast<Sortings::SortingName>(ui->SortingNameComboBox->currentIndex()));
+    std::vector<std::string> performance = m_SortingAndTiming.ComplexityCheck(name);
 
     ui->BestCase->setText(QString::fromStdString(performance[0]));
     ui->Average->setText(QString::fromStdString(performance[1]));
     ui->WorstCase->setText(QString::fromStdString(performance[2]));
-
-    if (m_Numbers.size() <= 500) {
-        ui->groupBox->setEnabled(false);
-        m_Visualizer.Play(ui->delay->value());
-        ui->VisualizationControl->setVisible(true);
-    }
-    connect(&m_Visualizer, &Visualizer::Sorted, this, [this] { this->ui->groupBox->setEnabled(true);
-                                                               this->ui->VisualizationControl->setVisible(false);});
 }
 
 void MainWindow::FormNumbers(){
@@ -104,7 +120,7 @@ void MainWindow::on_InitiateButton_clicked()
 {
     FormNumbers();
 
-    if(m_Numbers.size() <= 500){
+    if(m_Numbers.size() <= Visualizer::MaxVisualizedSize){
         m_Visualizer.SetMaxValue(ui->numberOfItems->value());
         auto size = ui->graphicsView->size();
         m_Visualizer.FormScene(size);
@@ -128,9 +144,12 @@ void MainWindow::on_ComplexityButton_clicked()
 
 void MainWindow::on_delay_sliderMoved(int position)
 {
-    if(m_Visualizer.GetTimer()){
-        m_Visualizer.GetTimer()->setInterval(position);
-    }
+    m_Visualizer.SetDelay(position);
+}
+
+void MainWindow::on_position_sliderMoved(int position)
+{
+    m_Visualizer.Seek(size_t(double(position) / ui->position->maximum() * m_Visualizer.GetLog().Size()));
 }
 
 void MainWindow::on_StopButton_clicked()
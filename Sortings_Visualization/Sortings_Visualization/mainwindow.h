@@ -52,6 +52,10 @@ private slots:
     /// </summary>
     void on_delay_sliderMoved(int position);
     /// <summary>
+    /// Moves visualization to the position chosen on the slider
+    /// </summary>
+    void on_position_sliderMoved(int position);
+    /// <summary>
     /// The method is called when the "Stop" button is clicked in the ui
     /// </summary>
     void on_StopButton_clicked();
@@ -70,7 +74,6 @@ private:
     std::vector<uint32_t>m_Numbers;
 
     Visualizer m_Visualizer;
-    Sortings::DefaultVisualizer<std::vector<uint32_t>>m_DefaultVisualizer;
 
     Sortings::SortingProxy<std::vector<uint32_t>> m_Sorting;
     Sortings::SortingAndTiming<std::vector<uint32_t>> m_SortingAndTiming;
@@ -0,0 +1,91 @@
+/**
+\file
+\brief .cpp file with implementation of Playback class
+*/
+
+#include "playback.h"
+
+#include <algorithm>
+
+Playback::Playback(const EventLog& log):
+    m_Cursor(log),
+    m_Counters{0, 0, 0},
+    m_IsAfterEnd(false),
+    m_KeyframeStep(EventLog::CheckpointStep){}
+
+void Playback::Reset(const std::vector<uint32_t>& values){
+    m_Cursor.Seek(0);
+    m_Values = values;
+    m_Counters = {0, 0, 0};
+    m_IsAfterEnd = false;
+    size_t checkpoints = std::max<size_t>(1, (values.size() + EventLog::CheckpointStep - 1) / EventLog::CheckpointStep);
+    m_KeyframeStep = checkpoints * EventLog::CheckpointStep;
+    m_Keyframes.clear();
+    m_Keyframes.push_back({m_Values, m_Counters});
+}
+
+bool Playback::Next(EventLog::Event& event){
+    if(!m_Cursor.Next(event)){
+        return false;
+    }
+    bool hasSecond = event.second != EventLog::NoPosition;
+    m_IsAfterEnd = event.operation == Sortings::Operation::END;
+    if(event.operation == Sortings::Operation::COMPARISON){
+        m_Counters.comparisons++;
+    }
+    else if(event.operation == Sortings::Operation::ACCESS){
+        m_Counters.accesses += hasSecond ? 2 : 1;
+    }
+    else if(event.operation == Sortings::Operation::CHANGE){
+        m_Counters.changes += hasSecond ? 2 : 1;
+        m_Values[event.first] = event.firstValue;
+        if(hasSecond){
+            m_Values[event.second] = event.secondValue;
+        }
+    }
+    size_t index = m_Cursor.GetIndex();
+    if(!m_IsAfterEnd && index % m_KeyframeStep == 0 && index / m_KeyframeStep == m_Keyframes.size()){
+        m_Keyframes.push_back({m_Values, m_Counters});
+    }
+    return true;
+}
+
+void Playback::Seek(size_t index){
+    StepBeforeEnd();
+    size_t keyframe = std::min(index / m_KeyframeStep, m_Keyframes.size() - 1);
+    if(index < GetIndex() || keyframe * m_KeyframeStep > GetIndex()){
+        m_Values = m_Keyframes[keyframe].values;
+        m_Counters = m_Keyframes[keyframe].counters;
+        m_Cursor.Seek(keyframe * m_KeyframeStep);
+    }
+    EventLog::Event event;
+    while(GetIndex() < index && Next(event)){
+        if(m_IsAfterEnd){
+            StepBeforeEnd();
+            break;
+        }
+    }
+}
+
+void Playback::StepBeforeEnd(){
+    if(m_IsAfterEnd){
+        m_Cursor.Seek(GetIndex() - 1);
+        m_IsAfterEnd = false;
+    }
+}
+
+size_t Playback::GetIndex() const{
+    return m_Cursor.GetIndex();
+}
+
+const std::vector<uint32_t>& Playback::GetValues() const{
+    return m_Values;
+}
+
+const Playback::Counters& Playback::GetCounters() const{
+    return m_Counters;
+}
+
+size_t Playback::GetKeyframeStep() const{
+    return m_KeyframeStep;
+}
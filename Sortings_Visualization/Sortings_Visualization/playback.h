@@ -0,0 +1,106 @@
+/**
+\file
+\brief .h file with definition of Playback class
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "eventlog.h"
+
+/**
+\brief replays events of log on copy of sorted array
+
+Playback keeps values of array and counters of operations at its position in log.
+Every KeyframeStep events it stores keyframe with copy of values and counters,
+so seek restores nearest keyframe before target and replays less than KeyframeStep events.
+KeyframeStep is not smaller than size of array, so keyframes take about as much memory as encoded events.
+*/
+class Playback
+{
+public:
+    /**
+    \brief numbers of operations played so far
+    */
+    struct Counters{
+        uint64_t comparisons;
+        uint64_t accesses;
+        uint64_t changes;
+    };
+
+    /**
+    \brief Playback ctor
+
+    \param log log to replay, may grow while it's replayed
+    */
+    Playback(const EventLog& log);
+
+    /**
+    \brief places playback on first event of log
+
+    \param values values of array before sorting
+    */
+    void Reset(const std::vector<uint32_t>& values);
+
+    /**
+    \brief decodes next event and applies it to values and counters
+
+    \param event decoded event
+    \return false if all events of log are played
+    */
+    bool Next(EventLog::Event& event);
+
+    /**
+    \brief places playback on event, values and counters are restored to state before it
+
+    \param index index of event, clamped to size of log
+    \note playback stops before END event, so END is always returned by Next
+    */
+    void Seek(size_t index);
+
+    /**
+    \brief index getter
+
+    \return index of event that will be played next
+    */
+    size_t GetIndex() const;
+
+    /**
+    \brief values getter
+
+    \return values of array at current position
+    */
+    const std::vector<uint32_t>& GetValues() const;
+
+    /**
+    \brief counters getter
+
+    \return counters of operations at current position
+    */
+    const Counters& GetCounters() const;
+
+    /**
+    \brief keyframe step getter
+
+    \return number of events between keyframes
+    */
+    size_t GetKeyframeStep() const;
+
+private:
+    struct Keyframe{
+        std::vector<uint32_t> values;
+        Counters counters;
+    };
+
+    void StepBeforeEnd();
+
+    EventLog::Cursor m_Cursor;
+    std::vector<uint32_t> m_Values;
+    Counters m_Counters;
+    bool m_IsAfterEnd;      ///<last played event is END, values and counters are same as before it
+
+    size_t m_KeyframeStep;
+    std::vector<Keyframe> m_Keyframes;     ///<keyframe i is state before event i * m_KeyframeStep
+};
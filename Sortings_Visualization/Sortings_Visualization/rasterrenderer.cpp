@@ -0,0 +1,114 @@
+/**
+\file
+\brief .cpp file with implementation of RasterRenderer class
+*/
+
+#include "rasterrenderer.h"
+
+#include <algorithm>
+
+namespace {
+    const QRgb Background = qRgb(255, 255, 255);
+    const QRgb DefaultColor = qRgb(255, 0, 0);
+
+    QRgb Lighter(QRgb color){
+        return qRgb((qRed(color) + 255) / 2, (qGreen(color) + 255) / 2, (qBlue(color) + 255) / 2);
+    }
+}
+
+RasterRenderer::RasterRenderer():
+    m_MaxValue(1){}
+
+void RasterRenderer::Reset(const std::vector<uint32_t>& data, uint32_t maxValue, const QSize& size){
+    m_Values = data;
+    m_MaxValue = std::max<uint32_t>(maxValue, 1);
+    Resize(size);
+}
+
+void RasterRenderer::Resize(const QSize& size){
+    m_Image = QImage(std::max(size.width(), 1), std::max(size.height(), 1), QImage::Format_RGB32);
+    m_Image.fill(Background);
+    size_t width = size_t(m_Image.width());
+    m_Colors.assign(width, DefaultColor);
+    m_IsDirty.assign(width, true);
+    m_DirtyColumns.resize(width);
+    for(size_t i = 0; i < width; i++){
+        m_DirtyColumns[i] = i;
+    }
+}
+
+void RasterRenderer::SetValue(size_t index, uint32_t value){
+    m_Values[index] = value;
+    auto columns = GetColumns(index);
+    for(size_t column = columns.first; column < columns.second; column++){
+        MarkDirty(column);
+    }
+}
+
+void RasterRenderer::SetColor(size_t index, QRgb color){
+    auto columns = GetColumns(index);
+    for(size_t column = columns.first; column < columns.second; column++){
+        if(m_Colors[column] != color){
+            m_Colors[column] = color;
+            MarkDirty(column);
+        }
+    }
+}
+
+bool RasterRenderer::Render(){
+    if(m_DirtyColumns.empty()){
+        return false;
+    }
+    std::sort(m_DirtyColumns.begin(), m_DirtyColumns.end());
+    m_Bars.clear();
+    for(size_t column : m_DirtyColumns){
+        m_Bars.push_back(GetBar(column));
+        m_IsDirty[column] = false;
+    }
+    m_DirtyColumns.clear();
+
+    uchar* bits = m_Image.bits();
+    int bytesPerLine = m_Image.bytesPerLine();
+    for(int row = 0; row < m_Image.height(); row++){
+        QRgb* line = reinterpret_cast<QRgb*>(bits + row * bytesPerLine);
+        for(const Bar& bar : m_Bars){
+            line[bar.column] = row < BottomMargin || row >= bar.maxHeight ? Background :
+                                                                           row < bar.minHeight ? bar.color : bar.lighter;
+        }
+    }
+    return true;
+}
+
+const QImage& RasterRenderer::GetImage() const{
+    return m_Image;
+}
+
+std::pair<size_t, size_t> RasterRenderer::GetColumns(size_t index) const{
+    size_t width = m_Colors.size();
+    size_t size = m_Values.size();
+    size_t end = ((index + 1) * width + size - 1) / size;
+    size_t begin = std::min((index * width + size - 1) / size, end - 1);
+    return {begin, end};
+}
+
+void RasterRenderer::MarkDirty(size_t column){
+    if(!m_IsDirty[column]){
+        m_IsDirty[column] = true;
+        m_DirtyColumns.push_back(column);
+    }
+}
+
+RasterRenderer::Bar RasterRenderer::GetBar(size_t column) const{
+    size_t width = m_Colors.size();
+    size_t size = m_Values.size();
+    Bar bar{column, 0, 0, m_Colors[column], Lighter(m_Colors[column])};
+    if(size){
+        size_t begin = column * size / width;
+        size_t end = std::max(begin + 1, (column + 1) * size / width);
+        auto minmax = std::minmax_element(m_Values.begin() + begin, m_Values.begin() + end);
+        double scale = (m_Image.height() - BottomMargin) * 0.9 / m_MaxValue;
+        bar.minHeight = BottomMargin + int(*minmax.first * scale);
+        bar.maxHeight = BottomMargin + int(*minmax.second * scale);
+    }
+    return bar;
+}
@@ -0,0 +1,102 @@
+/**
+\file
+\brief .h file with definition of RasterRenderer class
+*/
+
+#pragma once
+
+#include <QImage>
+#include <QSize>
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+
+/**
+\brief draws bars of sorted data into image
+
+Every pixel column of image shows range of elements: one element if there are fewer elements than columns,
+otherwise all elements that fall into column. Column is filled up to its minimal value with its color
+and from minimal to maximal value with lighter color, so one frame shows whole array of any size.
+
+Changes of values and colors only mark their columns as dirty, Render redraws dirty columns only,
+row by row to write image memory sequentially.
+*/
+class RasterRenderer
+{
+public:
+    /**
+    \brief RasterRenderer ctor
+    */
+    RasterRenderer();
+
+    /**
+    \brief sets new data and size of image, all columns become red
+
+    \param data values of elements
+    \param maxValue value of element which bar has full height
+    \param size size of image
+    */
+    void Reset(const std::vector<uint32_t>& data, uint32_t maxValue, const QSize& size);
+
+    /**
+    \brief changes size of image and redraws all columns
+
+    \param size new size of image
+    */
+    void Resize(const QSize& size);
+
+    /**
+    \brief changes value of element
+
+    \param index index of element
+    \param value new value
+    */
+    void SetValue(size_t index, uint32_t value);
+
+    /**
+    \brief changes color of column that shows element
+
+    \param index index of element
+    \param color new color
+    */
+    void SetColor(size_t index, QRgb color);
+
+    /**
+    \brief redraws dirty columns
+
+    \return false if there were no dirty columns and image wasn't changed
+    */
+    bool Render();
+
+    /**
+    \brief image getter
+
+    \return image with bars
+    */
+    const QImage& GetImage() const;
+
+private:
+    struct Bar{
+        size_t column;
+        int minHeight;
+        int maxHeight;
+        QRgb color;
+        QRgb lighter;
+    };
+
+    static constexpr int BottomMargin = 10;
+
+    std::pair<size_t, size_t> GetColumns(size_t index) const;
+    void MarkDirty(size_t column);
+    Bar GetBar(size_t column) const;
+
+    std::vector<uint32_t> m_Values;
+    uint32_t m_MaxValue;
+    QImage m_Image;
+
+    std::vector<QRgb> m_Colors;         ///<color of every pixel column
+    std::vector<bool> m_IsDirty;
+    std::vector<size_t> m_DirtyColumns;
+    std::vector<Bar> m_Bars;            ///<bars of dirty columns, kept to reuse memory
+};
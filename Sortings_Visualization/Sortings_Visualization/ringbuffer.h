@@ -0,0 +1,115 @@
+/**
+\file
+\brief .h file with definition and implementation of RingBuffer template class
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+\brief bounded lock-free queue for one producer thread and one consumer thread
+
+Producer owns tail, consumer owns head, each of them is changed by one thread only,
+so push and pop are a load and a store of atomic without locks or compare-and-swap.
+Every side keeps cached copy of index of other side and reloads it only when queue looks full or empty.
+
+\tparam T type of items, must be copy assignable
+*/
+template<typename T>
+class RingBuffer
+{
+public:
+    /**
+    \brief RingBuffer ctor
+
+    \param capacity max number of items in queue, rounded up to power of 2
+    */
+    RingBuffer(size_t capacity):
+        m_Head(0),
+        m_CachedTail(0),
+        m_Tail(0),
+        m_CachedHead(0){
+        size_t size = 1;
+        while(size < capacity){
+            size *= 2;
+        }
+        m_Items.resize(size);
+        m_Mask = size - 1;
+    }
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    /**
+    \brief adds item to queue, must be called by producer thread only
+
+    \param item item to add
+    \return false if queue is full
+    */
+    bool TryPush(const T& item){
+        size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if(tail - m_CachedHead == m_Items.size()){
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if(tail - m_CachedHead == m_Items.size()){
+                return false;
+            }
+        }
+        m_Items[tail & m_Mask] = item;
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    \brief removes oldest item from queue, must be called by consumer thread only
+
+    \param item removed item
+    \return false if queue is empty
+    */
+    bool TryPop(T& item){
+        size_t head = m_Head.load(std::memory_order_relaxed);
+        if(head == m_CachedTail){
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if(head == m_CachedTail){
+                return false;
+            }
+        }
+        item = m_Items[head & m_Mask];
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+    \brief removes all items
+
+    \note must not be called while producer or consumer works with queue
+    */
+    void Clear(){
+        m_Head.store(0, std::memory_order_relaxed);
+        m_Tail.store(0, std::memory_order_relaxed);
+        m_CachedHead = m_CachedTail = 0;
+    }
+
+    /**
+    \brief capacity getter
+
+    \return max number of items in queue
+    */
+    size_t Capacity() const{
+        return m_Items.size();
+    }
+
+private:
+    static constexpr size_t CacheLine = 64;
+
+    alignas(CacheLine) std::atomic<size_t> m_Head;
+    size_t m_CachedTail;        ///<consumer's copy of tail
+
+    alignas(CacheLine) std::atomic<size_t> m_Tail;
+    size_t m_CachedHead;        ///<producer's copy of head
+
+    alignas(CacheLine) std::vector<T> m_Items;
+    size_t m_Mask;
+};
@@ -5,89 +5,194 @@
 
 #include "visualizer.h"
 
-#include <iostream>
 #include <optional>
+#include <chrono>
+#include <algorithm>
 
 Visualizer::Visualizer(std::vector<uint32_t>& data):
     m_Scene(new QGraphicsScene),
+    m_Pixmap(nullptr),
     m_Data(data),
-    m_CurPos(0),
-    m_Timer(new QTimer(this)){
+    m_Playback(m_Log),
+    m_Delay(1),
+    m_DueEvents(0),
+    m_Timer(new QTimer(this)),
+    m_Events(QueueCapacity),
+    m_IsCancelled(false){
     connect (m_Timer,&QTimer::timeout,this,&Visualizer::PlayItem);
     m_Changes = m_Accesses = m_Comparisons = nullptr;
     m_CanRun = false;
 }
 
+Visualizer::~Visualizer(){
+    Stop();
+}
+
 bool Visualizer::Visualize(Sortings::Operation operation, std::vector<uint32_t>::iterator first,
                            std::optional<std::vector<uint32_t>::iterator> second){
-    double secondHeightCoef = second == std::nullopt ? 0 : double(**second)/m_MaxValue;
-    size_t firstPos = first - m_Data.begin();
-    size_t secondPos = second == std::nullopt ? UINT32_MAX : *second-m_Data.begin();
-    m_VisualizeQueue.push_back({ operation, firstPos,
-                                secondPos,
-                                double(*first)/m_MaxValue,
-                                secondHeightCoef});
+    bool isChange = operation == Sortings::Operation::CHANGE;
+    Publish({operation, size_t(first - m_Data.begin()),
+             second == std::nullopt ? EventLog::NoPosition : size_t(*second - m_Data.begin()),
+             isChange ? *first : 0,
+             isChange && second != std::nullopt ? **second : 0});
     return true;
 }
 
-void Visualizer::Play(int speedOfVisualization){
-    m_VisualizeQueue.push_back({Sortings::Operation::END, 0, 0, 0, 0});
-    std::cout << "Visualization started, " << m_VisualizeQueue.size() << std::endl;
-    m_CurPos = 0;
-    m_Timer->start(speedOfVisualization);
+void Visualizer::Publish(const EventLog::Event& event){
+    while(!m_Events.TryPush(event)){
+        if(m_IsCancelled.load(std::memory_order_relaxed)){
+            throw Cancelled();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Visualizer::Play(std::function<float()> sorting, int speedOfVisualization){
+    ClearQueue();
+    m_Playback.Reset(m_Data);
+    m_Worker = std::thread([this, sorting = std::move(sorting)]{
+        try{
+            float time = sorting();
+            emit SortingFinished(time);
+            Publish({Sortings::Operation::END, 0, EventLog::NoPosition, 0, 0});
+        }
+        catch(const Cancelled&){}
+    });
+    SetDelay(speedOfVisualization);
+    m_DueEvents = 0;
+    m_FrameClock.start();
+    m_Timer->start(FrameInterval);
     m_CanRun = true;
 }
 
+void Visualizer::Stop(){
+    if(m_Worker.joinable()){
+        m_IsCancelled.store(true, std::memory_order_relaxed);
+        m_Worker.join();
+        m_IsCancelled.store(false, std::memory_order_relaxed);
+    }
+    m_Events.Clear();
+}
+
+void Visualizer::SetDelay(int delay){
+    m_Delay = std::max(delay, 1);
+}
+
+bool Visualizer::DrainEvents(){
+    m_Log.Drain(m_Events, m_Playback.GetIndex() + LogBudget);
+    return m_Playback.GetIndex() < m_Log.Size();
+}
+
 void Visualizer::PlayItem(){
-    if(m_CurPos > 0){
-        auto& lastItem = m_VisualizeQueue[m_CurPos-1];
-        m_Rects[lastItem.first]->setBrush(QBrush(Qt::red));
-        if(lastItem.second != UINT32_MAX){
-            m_Rects[lastItem.second]->setBrush(QBrush(Qt::red));
+    qint64 elapsed = std::min<qint64>(m_FrameClock.restart(), 4 * FrameInterval);
+    for(size_t index : m_Highlighted){
+        SetColor(index, Qt::red);
+    }
+    m_Highlighted.clear();
+
+    DrainEvents();
+    double eventsPerMillisecond = std::max(1.0 / m_Delay, double(m_Log.Size()) / TargetDuration);
+    m_DueEvents += elapsed * eventsPerMillisecond;
+
+    QElapsedTimer budget;
+    budget.start();
+    EventLog::Event item;
+    for(size_t played = 1; m_DueEvents >= 1; played++){
+        if(!DrainEvents()){
+            m_DueEvents = std::min(m_DueEvents, 1.0);
+            break;
         }
-        if(m_CurPos == m_VisualizeQueue.size()){
-            m_Timer->stop();
-            m_Scene->update();
-            m_CanRun = false;
-            emit Sorted();
+        m_Playback.Next(item);
+        m_DueEvents--;
+        if(item.operation == Sortings::Operation::END){
+            Finish();
             return;
         }
+        Show(item);
+        if(played % 256 == 0 && budget.elapsed() >= FrameBudget){
+            m_DueEvents = 0;
+            break;
+        }
     }
-    auto& item = m_VisualizeQueue[m_CurPos++];
-    if(item.operation == Sortings::Operation::COMPARISON){
-        m_Rects[item.first]->setBrush(QBrush(Qt::blue));
-        long comp = m_Comparisons->text().toLong();
-        m_Comparisons->setText(QString::number(++comp));
-        if(item.second != UINT32_MAX){
-            m_Rects[item.second]->setBrush(QBrush(Qt::blue));
+    ShowCounters();
+    UpdateFrame();
+}
+
+void Visualizer::Seek(size_t index){
+    for(size_t i : m_Highlighted){
+        SetColor(i, Qt::red);
+    }
+    m_Highlighted.clear();
+    while(m_Worker.joinable() && m_Log.Size() < index && !m_Log.IsComplete()){
+        if(!m_Log.Drain(m_Events, index)){
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
     }
-    else if(item.operation == Sortings::Operation::ACCESS){
-        m_Rects[item.first]->setBrush(QBrush(Qt::yellow));
-        long reads = m_Accesses->text().toLong();
-        reads++;
-        if(item.second != UINT32_MAX){
-            m_Rects[item.second]->setBrush(QBrush(Qt::yellow));
-            reads++;
+    m_Playback.Seek(index);
+    m_DueEvents = 0;
+    const std::vector<uint32_t>& values = m_Playback.GetValues();
+    for(size_t i = 0; i < values.size(); i++){
+        SetValue(i, values[i]);
+    }
+    ShowCounters();
+    UpdateFrame();
+}
+
+void Visualizer::Finish(){
+    m_Worker.join();
+    m_Timer->stop();
+    ShowCounters();
+    UpdateFrame();
+    m_CanRun = false;
+    emit Sorted();
+}
+
+void Visualizer::Show(const EventLog::Event& item){
+    Qt::GlobalColor color = item.operation == Sortings::Operation::COMPARISON ? Qt::blue :
+                            item.operation == Sortings::Operation::ACCESS ? Qt::yellow : Qt::green;
+    SetColor(item.first, color);
+    m_Highlighted.push_back(item.first);
+    if(item.operation == Sortings::Operation::CHANGE){
+        SetValue(item.first, item.firstValue);
+    }
+    if(item.second != EventLog::NoPosition){
+        SetColor(item.second, color);
+        m_Highlighted.push_back(item.second);
+        if(item.operation == Sortings::Operation::CHANGE){
+            SetValue(item.second, item.secondValue);
         }
-        m_Accesses->setText(QString::number(reads));
     }
-    else if(item.operation == Sortings::Operation::CHANGE){
-        m_Rects[item.first]->setBrush(QBrush(Qt::green));
-        long writes = m_Changes->text().toLong();
-        writes++;
+}
 
-        m_Rects[item.first]->setRect(item.first*m_Width, 10,
-                                     m_Width, item.firstHeightCoef*m_Scene->height()*0.9);
+void Visualizer::ShowCounters(){
+    const Playback::Counters& counters = m_Playback.GetCounters();
+    m_Comparisons->setText(QString::number(counters.comparisons));
+    m_Accesses->setText(QString::number(counters.accesses));
+    m_Changes->setText(QString::number(counters.changes));
+    emit PositionChanged(m_Playback.GetIndex(), m_Log.Size());
+}
+
+void Visualizer::SetColor(size_t index, Qt::GlobalColor color){
+    if(m_Pixmap){
+        m_Renderer.SetColor(index, QColor(color).rgb());
+    }
+    else{
+        m_Rects[index]->setBrush(QBrush(color));
+    }
+}
 
-        if(item.second != UINT32_MAX){
-            m_Rects[item.second]->setBrush(QBrush(Qt::green));
-            writes++;
+void Visualizer::SetValue(size_t index, uint32_t value){
+    if(m_Pixmap){
+        m_Renderer.SetValue(index, value);
+    }
+    else{
+        m_Rects[index]->setRect(index*m_Width, 10, m_Width, double(value)/m_MaxValue*m_Scene->height()*0.9);
+    }
+}
 
-            m_Rects[item.second]->setRect(item.second*m_Width, 10,
-                                         m_Width, item.secondHeightCoef*m_Scene->height()*0.9);
-        }
-        m_Changes->setText(QString::number(writes));
+void Visualizer::UpdateFrame(){
+    if(m_Pixmap && m_Renderer.Render()){
+        m_Pixmap->setPixmap(QPixmap::fromImage(m_Renderer.GetImage()));
     }
     m_Scene->update();
 }
@@ -104,17 +209,22 @@ void Visualizer::PauseOrContinue(){
 void Visualizer::Clear(){
     m_Timer->stop();
     m_CanRun = false;
-    m_VisualizeQueue.clear();
+    ClearQueue();
 
     for(auto i:m_Rects){
         delete i;
     }
     m_Rects.clear();
+    delete m_Pixmap;
+    m_Pixmap = nullptr;
     m_Scene->update();
 }
 
 void Visualizer::ClearQueue(){
-    m_VisualizeQueue.clear();
+    Stop();
+    m_Log.Clear();
+    m_Playback.Reset({});
+    m_Highlighted.clear();
 }
 
 QGraphicsScene* Visualizer::GetScene(){
@@ -125,13 +235,26 @@ QTimer* Visualizer::GetTimer(){
     return m_Timer;
 }
 
+const EventLog& Visualizer::GetLog() const{
+    return m_Log;
+}
+
 void Visualizer::FormScene(const QSize& size){
     for(auto i:m_Rects){
         delete i;
     }
+    delete m_Pixmap;
+    m_Pixmap = nullptr;
     m_Scene->setSceneRect(0,0,size.width()*0.95, size.height()*0.95);
     m_Width = double(m_Scene->width())/m_Data.size();
     m_Rects.clear();
+    if(m_Data.size() > MaxRects){
+        m_Renderer.Reset(m_Data, m_MaxValue, m_Scene->sceneRect().size().toSize());
+        m_Renderer.Render();
+        m_Pixmap = m_Scene->addPixmap(QPixmap::fromImage(m_Renderer.GetImage()));
+        m_Scene->update();
+        return;
+    }
     for(size_t i=0;i<m_Data.size();i++){
         double height = double(m_Data[i])/m_MaxValue*m_Scene->height()*0.9;
         QGraphicsRectItem* cur =
@@ -148,6 +271,12 @@ void Visualizer::UpdateScene(double widthCoef, double heightCoef){
     auto oldSceneRect = m_Scene->sceneRect();
     m_Scene->setSceneRect ( 0,0,widthCoef*oldSceneRect.width(), heightCoef*oldSceneRect.height());
 
+    if(m_Pixmap){
+        m_Renderer.Resize(m_Scene->sceneRect().size().toSize());
+        UpdateFrame();
+        return;
+    }
+
     m_Width = double(m_Scene->width())/m_Rects.size();
 
     //double heightCoef = double(size.height())/oldSize.height();
@@ -8,13 +8,22 @@
 #include <QGraphicsScene>
 #include <QObject>
 #include <QGraphicsRectItem>
+#include <QGraphicsPixmapItem>
 #include <QTimer>
 #include <QLineEdit>
+#include <QElapsedTimer>
 
 #include <vector>
 #include <optional>
+#include <functional>
+#include <atomic>
+#include <thread>
 
 #include "Sorting.h"
+#include "eventlog.h"
+#include "ringbuffer.h"
+#include "rasterrenderer.h"
+#include "playback.h"
 
 /**
 \brief template class-implementation of sorting proxy
@@ -26,6 +35,7 @@ class Visualizer : public QObject, public Sortings::DefaultVisualizer<std::vecto
     Q_OBJECT
 
 public:
+    static constexpr size_t MaxVisualizedSize = 1'000'000;    ///<bigger arrays are sorted without visualization
 
     /**
     \brief Visualizer ctor
@@ -34,14 +44,23 @@ public:
     */
     Visualizer(std::vector<uint32_t>& data);
 
+    /**
+    \brief Visualizer dtor, cancels sorting on worker thread
+    */
+    ~Visualizer();
+
     /**
     \brief overrided method of DefaultVisualizer
+
+    \note called on worker thread, waits while queue of events is full
     */
     bool Visualize(Sortings::Operation operation, std::vector<uint32_t>::iterator first, std::optional<std::vector<uint32_t>::iterator> second = std::nullopt) override;
 
     /**
     \brief forms new items that depends on sorted data
 
+    \note arrays bigger than MaxRects are drawn by RasterRenderer into single pixmap
+
     \param size current size of graphics view
     */
     void FormScene(const QSize& size);
@@ -83,19 +102,43 @@ public:
     void SetAccessesItem(QLineEdit* item);
 
     /**
-    \brief starts visualization
+    \brief starts sorting on worker thread and visualization of its events
 
-    \param speedOfVisualization speed of visualization
+    \param sorting function that sorts data with this visualizer and returns time of sorting in milliseconds
+    \param speedOfVisualization delay between events in milliseconds
     */
-    void Play(int speedOfVisualization);
+    void Play(std::function<float()> sorting, int speedOfVisualization);
 
     /**
-    \brief plays single item of visualization
+    \brief cancels sorting on worker thread and waits for it
+    */
+    void Stop();
+
+    /**
+    \brief sets delay between events
+
+    \param delay delay in milliseconds, events are played faster if recording doesn't fit in TargetDuration
+    */
+    void SetDelay(int delay);
+
+    /**
+    \brief plays events of one frame
+
+    Number of events depends on time since previous frame, delay and size of recording,
+    but they are applied at most FrameBudget milliseconds. Counters and scene are updated once per frame.
     */
     void PlayItem();
 
     /**
-    \brief clears queue of visualization
+    \brief moves visualization to event of recording
+
+    \param index index of event, events that sorting hasn't recorded yet are waited for,
+    index is clamped to number of events of finished or cancelled sorting
+    */
+    void Seek(size_t index);
+
+    /**
+    \brief cancels sorting on worker thread and clears events of visualization
     */
     void ClearQueue();
 
@@ -123,33 +166,75 @@ public:
     */
     QTimer* GetTimer();
 
+    /**
+    \brief recorded events getter
+
+    \return log of events of last sorting
+    */
+    const EventLog& GetLog() const;
+
 signals:
 
     /**
     \brief signal emited after last item of visualization played
     */
     void Sorted();
+
+    /**
+    \brief signal emited from worker thread after sorting returned
+
+    \param time time of sorting in milliseconds
+    */
+    void SortingFinished(float time);
+
+    /**
+    \brief signal emited after every played frame and seek
+
+    \param index index of next event
+    \param size number of recorded events
+    */
+    void PositionChanged(size_t index, size_t size);
 private:
-    struct VisualizeItem{
-        Sortings::Operation operation;
-        size_t first;
-        size_t second;
-        double firstHeightCoef;
-        double secondHeightCoef;
-    };
+    struct Cancelled{};
+
+    static constexpr size_t QueueCapacity = 64 * 1024;
+    static constexpr size_t LogBudget = 64 * 1024 * 1024;  ///<max events recorded ahead of playback
+    static constexpr size_t MaxRects = 500;
+    static constexpr int FrameInterval = 16;        ///<milliseconds between frames
+    static constexpr int FrameBudget = 10;          ///<max milliseconds spent on events of one frame
+    static constexpr int TargetDuration = 60'000;   ///<max milliseconds of playback of whole recording
+
+    void Publish(const EventLog::Event& event);
+    bool DrainEvents();
+    void Show(const EventLog::Event& item);
+    void ShowCounters();
+    void Finish();
+    void SetColor(size_t index, Qt::GlobalColor color);
+    void SetValue(size_t index, uint32_t value);
+    void UpdateFrame();
 
     QGraphicsScene* m_Scene;
     std::vector<QGraphicsRectItem*>m_Rects;
+    RasterRenderer m_Renderer;
+    QGraphicsPixmapItem* m_Pixmap;
     std::vector<uint32_t>&m_Data;
     uint32_t m_MaxValue;
     double m_Width;
-    size_t m_CurPos;
 
     bool m_CanRun;
 
-    std::vector<VisualizeItem>m_VisualizeQueue;
+    EventLog m_Log;
+    Playback m_Playback;
+    std::vector<size_t> m_Highlighted;     ///<elements colored by events of last frame
+    int m_Delay;
+    double m_DueEvents;
+    QElapsedTimer m_FrameClock;
     QTimer *m_Timer;
 
+    RingBuffer<EventLog::Event> m_Events;
+    std::thread m_Worker;
+    std::atomic<bool> m_IsCancelled;
+
     QLineEdit* m_Comparisons;
     QLineEdit* m_Changes;
     QLineEdit* m_Accesses;